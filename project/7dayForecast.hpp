@@ -1,38 +1,31 @@
 #pragma once
 #include <Arduino.h>
-#include <ArduinoJson.h>
-#include <HTTPClient.h>
 #include <WiFi.h>
-#include <WiFiClientSecure.h>
 #include <algorithm>
 #include <lvgl.h>
 #include <time.h>
 #include <vector>
 
+#include "forecastParser.hpp"
+#include "httpsPool.hpp"
+#include "jsonPull.hpp"
 #include "stationPicker.hpp"
 #include "weatherIcons.hpp"
 
 // Tile object for 7-day forecast view (defined in project.ino)
 extern lv_obj_t *t2;
 
-/**
- * Day Forecast Structure
- * Stores weather forecast for a single day
- */
-struct DayForecast {
-  String date;    // YYYY-MM-DD format
-  String weekday; // Mon, Tue, Wed, etc.
-  float temp;     // Temperature at 12:00 UTC (around noon local time)
-  int symb;       // SMHI Wsymb2 weather symbol code (1-27)
-};
+static const size_t FORECAST_CARD_COUNT = 7; // Days shown as cards
 
 /**
  * Week Forecast View Class
  * Fetches and displays 7-day weather forecast from SMHI forecast API
  * Renders forecast as scrollable horizontal cards showing:
  * - Weekday name and date
- * - Weather icon (based on Wsymb2 symbol code)
- * - Temperature at noon
+ * - Weather icon (dominant daytime Wsymb2 symbol)
+ * - Daily max temperature, min temperature and precipitation
+ * The cards are built once in create() and updated in place on every
+ * fetch. The full hourly series is kept as well (hours()).
  */
 class WeekForecastView {
 public:
@@ -63,93 +56,135 @@ public:
     lv_obj_set_scroll_dir(row, LV_DIR_HOR);
     lv_obj_set_scrollbar_mode(row, LV_SCROLLBAR_MODE_ACTIVE);
     lv_obj_align_to(row, title, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 5);
+
+    init_styles();
+    create_cards();
+    render(); // A forecast may have arrived before the tile was built
+  }
+
+  /**
+   * Set Abort Check
+   * Polled while waiting for forecast data; returning true stops the fetch
+   */
+  void setAbortCheck(JsonPullParser::AbortFn fn, void *ctx) {
+    abort_fn = fn;
+    abort_ctx = ctx;
   }
 
   /**
    * Fetch and Render Forecast for Station
-   * Looks up station coordinates and fetches forecast
+   * Blocking convenience wrapper around fetchForStationIdx() + show()
    *
-   * @param station_idx Index into gStations vector
+   * @param station_idx Index into gStations
    * @return true if forecast was successfully fetched and rendered
    */
   bool fetchAndRenderForStationIdx(int station_idx) {
+    ForecastData fetched;
+    if (!fetchForStationIdx(station_idx, fetched))
+      return false;
+    show(fetched);
+    return true;
+  }
+
+  /**
+   * Fetch Forecast for Station
+   * Looks up station coordinates and fetches forecast. Touches no LVGL
+   * objects, so it can run on the fetch worker.
+   *
+   * @param station_idx Index into gStations
+   * @param out Filled with the hourly series and daily aggregates
+   * @return true if at least one day was parsed
+   */
+  bool fetchForStationIdx(int station_idx, ForecastData &out) {
     if (station_idx < 0 || station_idx >= (int)gStations.size())
       return false;
     char lat[16], lon[16];
     dtostrf(gStations[(size_t)station_idx].lat, 0, 4, lat);
     dtostrf(gStations[(size_t)station_idx].lon, 0, 4, lon);
-    return fetchAndRenderForLatLon(lat, lon);
+    return fetchForLatLon(lat, lon, out);
   }
 
   /**
-   * Fetch and Render Forecast for Coordinates
-   * Fetches 7-day forecast from SMHI pmp3g forecast API
+   * Fetch Forecast for Coordinates
+   * Fetches the full ~10 day forecast from SMHI pmp3g forecast API
    *
    * @param lat Latitude as string
    * @param lon Longitude as string
-   * @return true if forecast was successfully fetched and rendered
+   * @param out Filled with the hourly series and daily aggregates
+   * @return true if at least one day was parsed
    */
-  bool fetchAndRenderForLatLon(const char *lat, const char *lon) {
+  bool fetchForLatLon(const char *lat, const char *lon, ForecastData &out) {
+    out.clear();
     if (!lat || !lon)
       return false;
     if (WiFi.status() != WL_CONNECTED)
       return false;
 
-    String url = build_pmp3g_url(lat, lon);
+    String path = build_pmp3g_path(lat, lon);
     Serial.print("WeekForecast: fetching ");
-    Serial.println(url);
-
-    WiFiClientSecure client;
-    client.setInsecure();
-    client.setTimeout(10000);
-
-    HTTPClient https;
-    https.setReuse(true);
-
-    if (!https.begin(client, url)) {
-      Serial.println("WeekForecast: Connection failed");
-      return false;
-    }
+    Serial.println(path);
 
-    int code = https.GET();
+    HttpsRequest req(g_metfcst_host);
+    int code = req.get(path, 10000);
     if (code != 200) {
       Serial.printf("WeekForecast: HTTP Error %d\n", code);
-      https.end();
+      req.discardBody();
       return false;
     }
 
-    Stream &stream = https.getStream();
-
     unsigned long start = millis();
-    while (stream.available() == 0 && millis() - start < 3000) {
-      delay(10);
+    JsonPullParser json(req.stream());
+    json.setAbortCheck(abort_fn, abort_ctx);
+    bool success = ForecastParser::parse(json, out) && json.finish() &&
+                   !out.days.empty();
+    req.setBodyBytes(json.bytesRead());
+    if (!success) {
+      req.abandon();
+      if (!json.wasAborted())
+        Serial.println("WeekForecast: Parsing failed or no data found");
+      return false;
     }
 
-    bool success = parse_iteratively(stream);
-    https.end();
+    Serial.printf("WeekForecast: %u steps, %u days, %u bytes in %lu ms\n",
+                  (unsigned)out.hours.size(), (unsigned)out.days.size(),
+                  (unsigned)json.bytesRead(), millis() - start);
+    return true;
+  }
 
-    if (success) {
-      render();
-      Serial.printf("WeekForecast: Rendered %d days\n", (int)days.size());
-    } else {
-      Serial.println("WeekForecast: Parsing failed or no data found");
-    }
-    return success;
+  /**
+   * Show Fetched Forecast
+   * Takes over the fetched data (swap, no copy) and updates the cards in
+   * place. Must run on the LVGL thread.
+   */
+  void show(ForecastData &fetched) {
+    data.swap(fetched);
+    unsigned long start = micros();
+    render();
+    Serial.printf("WeekForecast: Rendered %d days in %lu us\n",
+                  (int)min(data.days.size(), FORECAST_CARD_COUNT),
+                  micros() - start);
   }
 
+  // Hourly series of the forecast on screen (for an hourly view)
+  const std::vector<ForecastHour> &hours() const { return data.hours; }
+
 private:
   lv_obj_t *parent;
   lv_obj_t *row;
   lv_obj_t *title;
-  std::vector<DayForecast> days;
+  ForecastData data;
+  JsonPullParser::AbortFn abort_fn = nullptr;
+  void *abort_ctx = nullptr;
+
+  bool abort_requested() const { return abort_fn && abort_fn(abort_ctx); }
 
   /**
-   * Build SMHI Forecast API URL
+   * Build SMHI Forecast API Path
    * Uses pmp3g (Point Multi-Parameter Grib version 3) forecast API
+   * (requested on g_metfcst_host)
    */
-  static String build_pmp3g_url(const char *lat, const char *lon) {
-    String url = "https://opendata-download-metfcst.smhi.se/api/category/pmp3g/"
-                 "version/2/geotype/point/lon/";
+  static String build_pmp3g_path(const char *lat, const char *lon) {
+    String url = "/api/category/pmp3g/version/2/geotype/point/lon/";
     url += lon;
     url += "/lat/";
     url += lat;
@@ -158,263 +193,165 @@ private:
   }
 
   /**
-   * Extract Float Parameter from JSON Array
-   * Searches parameter array for a specific parameter name and extracts its
-   * first value
+   * Day Card
+   * One pre-built card of the row. Labels show text from the card's own
+   * buffers (lv_label_set_text_static), so updating them allocates nothing.
    */
-  static bool param_float(const JsonArray &params, const char *name,
-                          float &out) {
-    for (JsonObject p : params) {
-      if (strcmp(p["name"] | "", name) == 0) {
-        if (p["values"].is<JsonArray>() && p["values"].size() > 0) {
-          out = p["values"][0].as<float>();
-          return true;
-        }
-      }
-    }
-    return false;
+  struct DayCard {
+    lv_obj_t *chip;
+    lv_obj_t *weekday;
+    lv_obj_t *date;
+    lv_obj_t *icon_box;
+    lv_obj_t *icon; // Atlas image; hidden while the fallback shapes show
+    lv_obj_t *temp;
+    lv_obj_t *detail;
+    char weekday_text[8];
+    char date_text[8];
+    char temp_text[12];
+    char detail_text[24];
+  };
+
+  DayCard cards[FORECAST_CARD_COUNT] = {};
+
+  // Shared by all cards instead of per-object local styles
+  lv_style_t style_chip, style_icon_box;
+  lv_style_t style_weekday, style_date, style_temp, style_detail;
+
+  void init_styles() {
+    lv_style_init(&style_chip);
+    lv_style_set_width(&style_chip, 140);
+    lv_style_set_height(&style_chip, lv_pct(95));
+    lv_style_set_layout(&style_chip, LV_LAYOUT_FLEX);
+    lv_style_set_flex_flow(&style_chip, LV_FLEX_FLOW_COLUMN);
+    lv_style_set_flex_main_place(&style_chip, LV_FLEX_ALIGN_CENTER);
+    lv_style_set_flex_cross_place(&style_chip, LV_FLEX_ALIGN_CENTER);
+    lv_style_set_flex_track_place(&style_chip, LV_FLEX_ALIGN_CENTER);
+    lv_style_set_pad_all(&style_chip, 2);
+    lv_style_set_radius(&style_chip, 10);
+    lv_style_set_bg_color(&style_chip, lv_color_hex(0x2C3E50));
+    lv_style_set_border_width(&style_chip, 0);
+
+    lv_style_init(&style_icon_box);
+    lv_style_set_width(&style_icon_box, 100);
+    lv_style_set_height(&style_icon_box, 100);
+    lv_style_set_bg_opa(&style_icon_box, LV_OPA_0);
+    lv_style_set_border_width(&style_icon_box, 0);
+
+    init_text_style(style_weekday, &lv_font_montserrat_20, 0xFFFFFF);
+    init_text_style(style_date, &lv_font_montserrat_14, 0xAAAAAA);
+    init_text_style(style_temp, &lv_font_montserrat_28, 0xFFFFFF);
+    init_text_style(style_detail, &lv_font_montserrat_14, 0xAAAAAA);
   }
 
-  /**
-   * Extract Integer Parameter from JSON Array
-   * Searches parameter array for a specific parameter name and extracts its
-   * first value
-   */
-  static bool param_int(const JsonArray &params, const char *name, int &out) {
-    for (JsonObject p : params) {
-      if (strcmp(p["name"] | "", name) == 0) {
-        if (p["values"].is<JsonArray>() && p["values"].size() > 0) {
-          out = p["values"][0].as<int>();
-          return true;
-        }
-      }
-    }
-    return false;
+  static void init_text_style(lv_style_t &style, const lv_font_t *font,
+                              uint32_t color) {
+    lv_style_init(&style);
+    lv_style_set_text_font(&style, font);
+    lv_style_set_text_color(&style, lv_color_hex(color));
   }
 
-  /**
-   * Calculate Weekday Name from Date String
-   * Uses Zeller's congruence algorithm for Gregorian calendar
-   *
-   * @param dateStr Date in YYYY-MM-DD format
-   * @return Weekday abbreviation (Mon, Tue, etc.)
-   */
-  static const char *get_weekday_name(const String &dateStr) {
-    // Parse YYYY-MM-DD
-    int year = dateStr.substring(0, 4).toInt();
-    int month = dateStr.substring(5, 7).toInt();
-    int day = dateStr.substring(8, 10).toInt();
-
-    // Zeller's congruence for Gregorian calendar
-    if (month < 3) {
-      month += 12;
-      year--;
-    }
-    int k = year % 100;
-    int j = year / 100;
-    int h = (day + (13 * (month + 1)) / 5 + k + k / 4 + j / 4 - 2 * j) % 7;
-    // h: 0=Sat, 1=Sun, 2=Mon, ...
-    static const char *names[] = {"Sat", "Sun", "Mon", "Tue",
-                                  "Wed", "Thu", "Fri"};
-    if (h < 0)
-      h += 7;
-    return names[h];
+  static lv_obj_t *create_card_label(lv_obj_t *chip, lv_style_t &style) {
+    lv_obj_t *label = lv_label_create(chip);
+    lv_obj_add_style(label, &style, 0);
+    return label;
   }
 
   /**
-   * Read Next JSON Object from Stream
-   * Similar to smhiApi.hpp but adapted for forecast API format
-   *
-   * @param stream HTTP response stream
-   * @param buffer Output buffer for JSON object
-   * @param bufSize Size of output buffer
-   * @return true if object was successfully read
+   * Build Card Pool
+   * Creates all FORECAST_CARD_COUNT cards once, hidden until render()
+   * has a day for them. Each card is:
+   * - Dark background with rounded corners
+   * - Weekday name (white, large font)
+   * - Date in MM/DD format (gray, smaller font)
+   * - Weather icon (100x100px)
+   * - Max temperature (white, large font)
+   * - Min temperature and precipitation (gray, small font)
    */
-  bool readNextObject(Stream &stream, char *buffer, size_t bufSize) {
-    size_t pos = 0;
-    int braceCount = 0;
-    bool started = false;
-    unsigned long lastRead = millis();
-
-    while (true) {
-      if (millis() - lastRead > 5000)
-        return false;
-
-      if (stream.available()) {
-        char c = stream.read();
-        lastRead = millis();
-
-        if (!started) {
-          if (c == '{') {
-            started = true;
-            braceCount = 1;
-            if (pos < bufSize - 1)
-              buffer[pos++] = c;
-          } else if (c == ']') {
-            return false;
-          }
-        } else {
-          if (pos < bufSize - 1)
-            buffer[pos++] = c;
-
-          if (c == '{') {
-            braceCount++;
-          } else if (c == '}') {
-            braceCount--;
-            if (braceCount == 0) {
-              buffer[pos] = 0;
-              return true;
-            }
-          }
-        }
-      } else {
-        delay(5);
-      }
+  void create_cards() {
+    for (DayCard &c : cards) {
+      c.chip = lv_obj_create(row);
+      lv_obj_add_style(c.chip, &style_chip, 0);
+      lv_obj_clear_flag(c.chip, LV_OBJ_FLAG_SCROLLABLE);
+      lv_obj_add_flag(c.chip, LV_OBJ_FLAG_HIDDEN);
+
+      c.weekday = create_card_label(c.chip, style_weekday);
+      c.date = create_card_label(c.chip, style_date);
+
+      c.icon_box = lv_obj_create(c.chip);
+      lv_obj_add_style(c.icon_box, &style_icon_box, 0);
+      lv_obj_clear_flag(c.icon_box, LV_OBJ_FLAG_SCROLLABLE);
+      c.icon = lv_img_create(c.icon_box);
+      lv_obj_center(c.icon);
+
+      c.temp = create_card_label(c.chip, style_temp);
+      c.detail = create_card_label(c.chip, style_detail);
     }
-    return false;
   }
 
   /**
-   * Parse Forecast Time Series Iteratively
-   * Streams through forecast JSON to extract 7 days of noon forecasts
-   *
-   * Filters to only use 12:00 UTC entries (approximately local noon)
-   * Extracts temperature (t) and weather symbol (Wsymb2) parameters
-   *
-   * @param stream HTTP response stream
-   * @return true if at least one day was successfully parsed
+   * Set Card Icon
+   * Points the card's image at the atlas entry for the symbol. If the
+   * atlas has none, the icon is composed from objects in the icon box
+   * (deleted again once an atlas image can be shown).
    */
-  bool parse_iteratively(Stream &stream) {
-    // Clear previous forecast data
-    days.clear();
-
-    // Find start of timeSeries array in the JSON stream
-    if (!stream.find("\"timeSeries\"")) {
-      Serial.println("WeekForecast: 'timeSeries' not found in stream");
-      return false;
-    }
-    if (!stream.find("[")) {
-      Serial.println("WeekForecast: Array start '[' not found");
-      return false;
-    }
-
-    StaticJsonDocument<256> filter;
-    filter["validTime"] = true;
-    filter["parameters"][0]["name"] = true;
-    filter["parameters"][0]["values"][0] = true;
-
-    char jsonBuf[4096];
-    DynamicJsonDocument chunkDoc(6144);
-
-    String lastDate = "";
-    int count = 0;
-
-    while (count < 7) {
-      if (readNextObject(stream, jsonBuf, sizeof(jsonBuf))) {
-        chunkDoc.clear();
-        DeserializationError err = deserializeJson(
-            chunkDoc, jsonBuf, DeserializationOption::Filter(filter));
-
-        if (err) {
-          Serial.print("Chunk parse error: ");
-          Serial.println(err.c_str());
-          continue;
-        }
-
-        String vt = chunkDoc["validTime"] | "";
-        if (vt.length() >= 16) {
-          // Extract hour (UTC)
-          int hour = vt.substring(11, 13).toInt();
-          String date = vt.substring(0, 10);
-
-          // Only take 12:00 UTC entries (noon), and only one per day
-          if (hour == 12 && date != lastDate) {
-            JsonArray params = chunkDoc["parameters"].as<JsonArray>();
-            float t = NAN;
-            int sym = 0;
-            if (param_float(params, "t", t) &&
-                param_int(params, "Wsymb2", sym)) {
-              DayForecast d;
-              d.date = date;
-              d.weekday = get_weekday_name(date);
-              d.temp = t;
-              d.symb = sym;
-              days.push_back(d);
-              lastDate = date;
-              count++;
-            }
-          }
-        }
-      } else {
-        break;
-      }
+  static void set_card_icon(DayCard &c, int symb) {
+    const int size = 90;
+    WeatherIconAtlas *atlas = weather_icon_atlas(size);
+    const lv_img_dsc_t *src = atlas ? atlas->get(symb) : nullptr;
+
+    // Fallback shapes from an earlier render follow the image
+    while (lv_obj_get_child_cnt(c.icon_box) > 1)
+      lv_obj_del(lv_obj_get_child(c.icon_box, 1));
+
+    if (src) {
+      lv_img_set_src(c.icon, src);
+      lv_obj_clear_flag(c.icon, LV_OBJ_FLAG_HIDDEN);
+    } else {
+      lv_obj_add_flag(c.icon, LV_OBJ_FLAG_HIDDEN);
+      draw_weather_icon_objects(c.icon_box, symb, size);
     }
-
-    return !days.empty();
-  }
-
-  /**
-   * Clear Forecast Cards
-   * Removes all child objects from the row container
-   */
-  void clear_row() {
-    if (row)
-      lv_obj_clean(row);
   }
 
   /**
    * Render Forecast Cards
-   * Creates a card for each day in the forecast with:
-   * - Dark background with rounded corners
-   * - Weekday name (white, large font)
-   * - Date in MM/DD format (gray, smaller font)
-   * - Weather icon (100x100px)
-   * - Temperature (white, large font)
+   * Fills the first days' cards in place and hides the rest
    */
   void render() {
     if (!parent || !row)
       return;
-    clear_row();
-
-    for (const auto &d : days) {
-      lv_obj_t *chip = lv_obj_create(row);
-      lv_obj_set_size(chip, 140, lv_pct(95));
-      lv_obj_set_flex_flow(chip, LV_FLEX_FLOW_COLUMN);
-      lv_obj_set_flex_align(chip, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER,
-                            LV_FLEX_ALIGN_CENTER);
-      lv_obj_set_style_pad_all(chip, 2, 0);
-      lv_obj_set_style_radius(chip, 10, 0);
-      lv_obj_set_style_bg_color(chip, lv_color_hex(0x2C3E50), 0);
-      lv_obj_set_style_border_width(chip, 0, 0);
-      lv_obj_clear_flag(chip, LV_OBJ_FLAG_SCROLLABLE);
-
-      // Weekday name
-      lv_obj_t *weekdayLabel = lv_label_create(chip);
-      lv_label_set_text(weekdayLabel, d.weekday.c_str());
-      lv_obj_set_style_text_font(weekdayLabel, &lv_font_montserrat_20, 0);
-      lv_obj_set_style_text_color(weekdayLabel, lv_color_hex(0xFFFFFF), 0);
-
-      // Date (MM/DD format)
-      lv_obj_t *dateLabel = lv_label_create(chip);
-      String dateStr = d.date.substring(5, 7) + "/" + d.date.substring(8, 10);
-      lv_label_set_text(dateLabel, dateStr.c_str());
-      lv_obj_set_style_text_font(dateLabel, &lv_font_montserrat_14, 0);
-      lv_obj_set_style_text_color(dateLabel, lv_color_hex(0xAAAAAA), 0);
-
-      // Icon container
-      lv_obj_t *icon_cont = lv_obj_create(chip);
-      lv_obj_set_size(icon_cont, 100, 100);
-      lv_obj_set_style_bg_opa(icon_cont, LV_OPA_0, 0);
-      lv_obj_set_style_border_width(icon_cont, 0, 0);
-      lv_obj_clear_flag(icon_cont, LV_OBJ_FLAG_SCROLLABLE);
-
-      draw_weather_icon(icon_cont, d.symb, 90);
-
-      // Temperature (12:00 UTC = 13:00 Swedish time in winter)
-      lv_obj_t *t = lv_label_create(chip);
-      lv_label_set_text_fmt(t, "%.0f°C", d.temp);
-      lv_obj_set_style_text_font(t, &lv_font_montserrat_28, 0);
-      lv_obj_set_style_text_color(t, lv_color_hex(0xFFFFFF), 0);
+
+    size_t shown = min(data.days.size(), FORECAST_CARD_COUNT);
+    for (size_t i = 0; i < FORECAST_CARD_COUNT; i++) {
+      DayCard &c = cards[i];
+      if (i >= shown) {
+        lv_obj_add_flag(c.chip, LV_OBJ_FLAG_HIDDEN);
+        continue;
+      }
+      const DayForecast &d = data.days[i];
+
+      snprintf(c.weekday_text, sizeof(c.weekday_text), "%s",
+               d.weekday.c_str());
+      lv_label_set_text_static(c.weekday, c.weekday_text);
+
+      // MM/DD from YYYY-MM-DD
+      const char *ymd = d.date.c_str();
+      if (d.date.length() >= 10)
+        snprintf(c.date_text, sizeof(c.date_text), "%.2s/%.2s", ymd + 5,
+                 ymd + 8);
+      else
+        c.date_text[0] = 0;
+      lv_label_set_text_static(c.date, c.date_text);
+
+      set_card_icon(c, d.symb);
+
+      snprintf(c.temp_text, sizeof(c.temp_text), "%.0f°C", d.temp_max);
+      lv_label_set_text_static(c.temp, c.temp_text);
+
+      snprintf(c.detail_text, sizeof(c.detail_text), "%.0f° %.1f mm",
+               d.temp_min, d.precip_mm);
+      lv_label_set_text_static(c.detail, c.detail_text);
+
+      lv_obj_clear_flag(c.chip, LV_OBJ_FLAG_HIDDEN);
     }
   }
 };
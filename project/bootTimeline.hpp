@@ -0,0 +1,64 @@
+#pragma once
+#include <Arduino.h>
+
+/**
+ * Boot Timeline
+ * Milliseconds from reset to each boot milestone, logged once the UI
+ * takes input:
+ *
+ *   Boot: display 412 ms, lvgl 431 ms, splash built 433 ms,
+ *         first pixel 461 ms, ..., interactive 530 ms
+ *
+ * millis() starts with the application, so the ROM and second-stage
+ * bootloader before it are not included. "first pixel" is the splash
+ * frame handed to the panel. "interactive" is the first pass of the
+ * main loop after the boot-time deferred work (the forecast tile).
+ */
+enum BootMark {
+  BOOT_DISPLAY,       // amoled.begin() done
+  BOOT_LVGL,          // LVGL and flush buffers set up
+  BOOT_SPLASH,        // create_ui(): tileview and splash tile
+  BOOT_FIRST_PIXEL,   // Splash rendered and flushed
+  BOOT_STORAGE,       // Flash cache mounted, fetch worker started
+  BOOT_TILES_AHEAD,   // Deferred build of the tile after the splash
+  BOOT_INTERACTIVE,   // Main loop running with the above in place
+  BOOT_MARK_COUNT
+};
+
+static const char *const BOOT_MARK_NAMES[BOOT_MARK_COUNT] = {
+    "display",          "lvgl",          "splash built", "first pixel",
+    "storage + worker", "forecast tile", "interactive"};
+
+class BootTimeline {
+public:
+  /**
+   * Record Milestone
+   * Only the first call per mark counts. Recording BOOT_INTERACTIVE
+   * logs the timeline.
+   */
+  void mark(BootMark m) {
+    if (at_ms[m])
+      return;
+    unsigned long now = millis();
+    at_ms[m] = now ? now : 1; // 0 means "not yet"
+    if (m == BOOT_INTERACTIVE)
+      log();
+  }
+
+  bool reached(BootMark m) const { return at_ms[m] != 0; }
+
+  void log() const {
+    Serial.print("Boot:");
+    for (int i = 0; i < BOOT_MARK_COUNT; i++) {
+      if (at_ms[i])
+        Serial.printf("%s %s %lu ms", i ? "," : "", BOOT_MARK_NAMES[i],
+                      at_ms[i]);
+    }
+    Serial.println();
+  }
+
+private:
+  unsigned long at_ms[BOOT_MARK_COUNT] = {};
+};
+
+static BootTimeline g_boot;
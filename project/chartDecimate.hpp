@@ -0,0 +1,196 @@
+#pragma once
+#include <Arduino.h>
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+#include "seriesPyramid.hpp"
+#include "seriesStore.hpp"
+
+/**
+ * Chart Zoom Levels
+ * Visible time span per level, widest first. 0 = the whole series.
+ * At the narrowest level a latest-months hourly series shows about the
+ * same 48 raw points the chart used to be limited to.
+ * The last levels are aggregated views of the whole series: one mean
+ * point plus a min/max bar per day or week (SeriesPyramid).
+ */
+struct ChartZoomLevel {
+  const char *label;
+  int32_t span_s;
+  int8_t aggregate; // SeriesPyramid::Level, or -1 for raw points
+};
+
+static const ChartZoomLevel CHART_ZOOM_LEVELS[] = {
+    {"All", 0, -1},
+    {"30 d", 30 * 86400, -1},
+    {"7 d", 7 * 86400, -1},
+    {"2 d", 2 * 86400, -1},
+    {"Daily", 0, SeriesPyramid::LEVEL_DAY},
+    {"Weekly", 0, SeriesPyramid::LEVEL_WEEK},
+};
+static const int CHART_ZOOM_COUNT =
+    sizeof(CHART_ZOOM_LEVELS) / sizeof(CHART_ZOOM_LEVELS[0]);
+
+/**
+ * Decimated Chart Window
+ * Min/max-per-column level of detail for one visible window of a series
+ *
+ * The window [start, start + count) is split into `columns` buckets of
+ * consecutive points. Each bucket contributes its minimum and its maximum,
+ * in time order, so every peak and dip survives however many points share
+ * a pixel column; the polyline has at most 2 * columns vertices whatever
+ * the window length. Windows that already fit are passed through as raw
+ * points.
+ *
+ * Bucket extremes come from the pyramid's RangeMinMax, so a build costs
+ * O(columns) however long the window is.
+ *
+ * Only source indices are stored; x positions follow from the index and
+ * values are read back from the SeriesStore when drawing.
+ */
+class ChartDecimator {
+public:
+  /**
+   * Build Window
+   * @param data Source series
+   * @param range Min/max index of data (SeriesPyramid synced to data)
+   * @param start First source index of the window
+   * @param count Number of source points in the window
+   * @param columns Target bucket count (roughly the plot width in pixels
+   *                divided by the pixels per bucket)
+   */
+  void build(const SeriesStore &data, const RangeMinMax &range, size_t start,
+             size_t count, int columns) {
+    idx.clear();
+    first = start;
+    span = count;
+    agg = -1;
+    lo = 0.0f;
+    hi = 0.0f;
+    if (count == 0 || start + count > data.size())
+      return;
+    if (columns < 1)
+      columns = 1;
+
+    const float *v = data.values();
+    size_t imin, imax;
+    range.query(v, start, start + count, imin, imax);
+    lo = v[imin];
+    hi = v[imax];
+
+    raw = count <= (size_t)columns * 2;
+    if (raw) {
+      idx.reserve(count);
+      for (size_t i = start; i < start + count; i++)
+        idx.push_back((uint32_t)i);
+      return;
+    }
+
+    idx.reserve((size_t)columns * 2);
+    for (int c = 0; c < columns; c++) {
+      size_t b0 = start + (count * (size_t)c) / (size_t)columns;
+      size_t b1 = start + (count * (size_t)(c + 1)) / (size_t)columns;
+      if (b1 <= b0)
+        continue;
+
+      range.query(v, b0, b1, imin, imax);
+
+      // Keep time order inside the bucket; flat buckets add one point
+      if (imin == imax) {
+        idx.push_back((uint32_t)imin);
+      } else if (imin < imax) {
+        idx.push_back((uint32_t)imin);
+        idx.push_back((uint32_t)imax);
+      } else {
+        idx.push_back((uint32_t)imax);
+        idx.push_back((uint32_t)imin);
+      }
+    }
+  }
+
+  /**
+   * Build Aggregated View
+   * One vertex per pyramid bucket over the whole series, placed at the
+   * bucket's middle raw point; vertex i is bucket i of the level
+   */
+  void buildAggregate(const SeriesStore &data, const SeriesPyramid &pyramid,
+                      SeriesPyramid::Level level) {
+    idx.clear();
+    first = 0;
+    span = data.size();
+    agg = (int8_t)level;
+    raw = false;
+    size_t n = pyramid.bucketCount(level);
+    if (n == 0) {
+      lo = hi = 0.0f;
+      return;
+    }
+
+    idx.reserve(n);
+    lo = pyramid.bucket(level, 0).min;
+    hi = pyramid.bucket(level, 0).max;
+    for (size_t i = 0; i < n; i++) {
+      const SeriesBucket &b = pyramid.bucket(level, i);
+      idx.push_back(b.first + b.count / 2);
+      if (b.min < lo)
+        lo = b.min;
+      if (b.max > hi)
+        hi = b.max;
+    }
+  }
+
+  size_t size() const { return idx.size(); }
+  // Source index of vertex i
+  size_t index(size_t i) const { return idx[i]; }
+  // True if every source point in the window is a vertex
+  bool isRaw() const { return raw; }
+  // Pyramid level of an aggregated view, -1 otherwise
+  int aggregateLevel() const { return agg; }
+
+  size_t windowStart() const { return first; }
+  size_t windowCount() const { return span; }
+  float minValue() const { return lo; }
+  float maxValue() const { return hi; }
+
+private:
+  std::vector<uint32_t> idx;
+  size_t first = 0;
+  size_t span = 0;
+  float lo = 0.0f;
+  float hi = 0.0f;
+  bool raw = true;
+  int8_t agg = -1;
+};
+
+/**
+ * Window For Zoom Level
+ * Source index range covering span_s seconds, positioned by a 0-100
+ * slider value (0 = oldest, 100 = newest). span_s = 0 selects everything.
+ */
+static void chart_zoom_window(const SeriesStore &data, int32_t span_s,
+                              int slider_value, size_t &start,
+                              size_t &count) {
+  size_t total = data.size();
+  start = 0;
+  count = total;
+  if (total < 2 || span_s <= 0 || data.lastTime() - data.firstTime() <= span_s)
+    return;
+
+  int32_t latest_start = data.lastTime() - span_s;
+  int32_t t0 = data.firstTime() +
+               (int32_t)(((int64_t)(latest_start - data.firstTime()) *
+                          slider_value) /
+                         100);
+
+  // Timestamps are ascending: binary search both ends
+  const int32_t *t = data.times();
+  size_t a = std::lower_bound(t, t + total, t0) - t;
+  size_t b = std::upper_bound(t, t + total, t0 + span_s) - t;
+  if (b - a < 2) { // Gap in the data: show at least a segment
+    b = std::min(total, a + 2);
+    a = b - 2;
+  }
+  start = a;
+  count = b - a;
+}
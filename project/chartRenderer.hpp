@@ -0,0 +1,306 @@
+#pragma once
+#include <Arduino.h>
+#include <algorithm>
+#include <lvgl.h>
+#include <string.h>
+#include <vector>
+
+#include "chartDecimate.hpp"
+#include "seriesPyramid.hpp"
+
+// Point markers are only drawn when raw points are at least this far apart
+static const int CHART_MARKER_MIN_SPACING = 8;
+
+/**
+ * Chart Renderer
+ * Draws the history chart's series from cached screen coordinates
+ *
+ * Vertices are projected once into graph-local pixels (relative to the
+ * graph area's top-left corner) and kept until the data, window, Y range
+ * or graph size changes, so scrolling the tileview or redrawing one band
+ * of the screen reuses them as they are.
+ *
+ * Vertex x is non-decreasing, so each draw call binary-searches the
+ * first and last vertex inside its clip area and only walks those:
+ * the cost follows the pixels being redrawn, not the length of the series
+ * times the number of draw bands. Within that range the polyline is
+ * batched: runs of vertices in the same pixel column (min/max pairs) or
+ * on the same row collapse into one segment, and segments entirely above
+ * or below the clip area are skipped. Point markers are blitted from one
+ * shared pre-rendered sprite.
+ */
+class ChartRenderer {
+public:
+  // Vertex value callback: raw point or aggregate mean of vertex i
+  typedef float (*ValueFn)(size_t i);
+
+  ~ChartRenderer() {
+    if (marker_buf)
+      free(marker_buf);
+  }
+
+  /**
+   * Prepare Renderer
+   * Renders the marker sprite; call outside of drawing (LVGL thread)
+   */
+  void begin() {
+    if (!marker.data)
+      render_marker();
+  }
+
+  // Data, window or Y range changed: reproject before the next draw
+  void invalidate() { valid = false; }
+
+  /**
+   * Project Vertices
+   * No-op while the cached coordinates are still valid for this size
+   *
+   * @param lod Vertices of the current window
+   * @param value Value of vertex i
+   * @param pyramid Source of the min/max bars in aggregated views
+   * @param window_start First source index of the window
+   * @param window_size Source points in the window
+   * @param y_min Bottom of the Y axis
+   * @param y_max Top of the Y axis
+   * @param width Graph area width in pixels
+   * @param height Graph area height in pixels
+   */
+  void project(const ChartDecimator &lod, ValueFn value,
+               const SeriesPyramid &pyramid, int window_start,
+               int window_size, int y_min, int y_max, int width,
+               int height) {
+    if (valid && width == w && height == h)
+      return;
+    valid = true;
+    w = width;
+    h = height;
+    pts.clear();
+    bar_top.clear();
+    bar_bottom.clear();
+
+    size_t n = lod.size();
+    int span = window_size - 1;
+    if (n == 0 || span < 1 || w < 2 || h < 2)
+      return;
+
+    int y_range = y_max - y_min;
+    if (y_range <= 0)
+      y_range = 1;
+
+    pts.resize(n);
+    for (size_t i = 0; i < n; i++) {
+      // Position by source index, so min/max pairs share their column
+      pts[i].x = (lv_coord_t)(((int64_t)((int)lod.index(i) - window_start) *
+                               (w - 1)) /
+                              span);
+      pts[i].y = y_pixel(value(i), y_min, y_range);
+    }
+
+    // Points too close for markers: thinner lines without round caps
+    dense = !lod.isRaw() || (w - 1) / span < CHART_MARKER_MIN_SPACING;
+
+    int level = lod.aggregateLevel();
+    if (level >= 0) {
+      bar_top.resize(n);
+      bar_bottom.resize(n);
+      for (size_t i = 0; i < n; i++) {
+        const SeriesBucket &b =
+            pyramid.bucket((SeriesPyramid::Level)level, i);
+        bar_top[i] = y_pixel(b.max, y_min, y_range);
+        bar_bottom[i] = y_pixel(b.min, y_min, y_range);
+      }
+      bar_width = n * 3 < (size_t)w ? 3 : 1;
+    }
+  }
+
+  /**
+   * Draw Series
+   * Bars, polyline and markers that intersect the current clip area
+   *
+   * @param draw_ctx Context of the LV_EVENT_DRAW_POST being handled
+   * @param gx Graph area left edge (screen coordinates)
+   * @param gy Graph area top edge (screen coordinates)
+   */
+  void draw(lv_draw_ctx_t *draw_ctx, int gx, int gy) {
+    size_t n = pts.size();
+    if (n < 2)
+      return;
+
+    // Clip area in graph-local pixels, widened by the stroke/marker size
+    const lv_area_t *clip = draw_ctx->clip_area;
+    const int pad = MARKER_RADIUS + 2;
+    int cx1 = clip->x1 - gx - pad, cx2 = clip->x2 - gx + pad;
+    int cy1 = clip->y1 - gy - pad, cy2 = clip->y2 - gy + pad;
+    if (cx2 < 0 || cx1 > pts[n - 1].x)
+      return;
+
+    // Vertices [i0, i1] cover the clip area, plus one on either side so
+    // segments crossing its edges are kept
+    size_t i0 = std::lower_bound(pts.begin(), pts.end(), cx1, x_less) -
+                pts.begin();
+    size_t i1 = std::upper_bound(pts.begin(), pts.end(), cx2, x_greater) -
+                pts.begin();
+    if (i0 > 0)
+      i0--;
+    if (i1 >= n)
+      i1 = n - 1;
+
+    if (!bar_top.empty())
+      draw_bars(draw_ctx, gx, gy, i0, i1, cy1, cy2);
+    draw_lines(draw_ctx, gx, gy, i0, i1, cy1, cy2);
+    if (!dense)
+      draw_markers(draw_ctx, gx, gy, i0, i1, cy1, cy2);
+  }
+
+private:
+  static const int MARKER_RADIUS = 3;
+  static const int MARKER_SIZE = MARKER_RADIUS * 2 + 1;
+
+  std::vector<lv_point_t> pts;       // Graph-local vertex positions
+  std::vector<lv_coord_t> bar_top;   // Aggregated views: bucket max y
+  std::vector<lv_coord_t> bar_bottom; // Aggregated views: bucket min y
+  int w = 0, h = 0;
+  int bar_width = 1;
+  bool dense = false;
+  bool valid = false;
+
+  uint8_t *marker_buf = nullptr;
+  lv_img_dsc_t marker = {};
+
+  lv_coord_t y_pixel(float v, int y_min, int y_range) const {
+    // Invert Y (higher values at top) and scale to graph height
+    return (lv_coord_t)((1.0f - (v - y_min) / (float)y_range) * (h - 1));
+  }
+
+  static bool x_less(const lv_point_t &p, int x) { return p.x < x; }
+  static bool x_greater(int x, const lv_point_t &p) { return x < p.x; }
+
+  static bool outside_rows(int ya, int yb, int cy1, int cy2) {
+    return (ya < cy1 && yb < cy1) || (ya > cy2 && yb > cy2);
+  }
+
+  void draw_bars(lv_draw_ctx_t *draw_ctx, int gx, int gy, size_t i0,
+                 size_t i1, int cy1, int cy2) {
+    lv_draw_line_dsc_t dsc;
+    lv_draw_line_dsc_init(&dsc);
+    dsc.width = bar_width;
+    dsc.color = lv_palette_lighten(LV_PALETTE_BLUE, 3);
+    dsc.opa = LV_OPA_COVER;
+
+    for (size_t i = i0; i <= i1; i++) {
+      if (outside_rows(bar_top[i], bar_bottom[i], cy1, cy2))
+        continue;
+      lv_point_t top = {(lv_coord_t)(gx + pts[i].x),
+                        (lv_coord_t)(gy + bar_top[i])};
+      lv_point_t bottom = {top.x, (lv_coord_t)(gy + bar_bottom[i])};
+      lv_draw_line(draw_ctx, &dsc, &top, &bottom);
+    }
+  }
+
+  void draw_lines(lv_draw_ctx_t *draw_ctx, int gx, int gy, size_t i0,
+                  size_t i1, int cy1, int cy2) {
+    lv_draw_line_dsc_t dsc;
+    lv_draw_line_dsc_init(&dsc);
+    dsc.color = lv_palette_main(LV_PALETTE_BLUE);
+    dsc.opa = LV_OPA_COVER;
+    dsc.width = dense ? 2 : 3;
+    dsc.round_start = dense ? 0 : 1;
+    dsc.round_end = dense ? 0 : 1;
+
+    size_t i = i0;
+    while (i < i1) {
+      lv_point_t a = pts[i];
+      lv_point_t b = pts[i + 1];
+      i++;
+
+      // Collapse a run in one column (min/max pairs) into a single
+      // vertical stroke over its extent, or a run along one row into a
+      // single horizontal stroke
+      if (a.x == b.x) {
+        lv_coord_t lo = std::min(a.y, b.y), hi = std::max(a.y, b.y);
+        while (i < i1 && pts[i + 1].x == a.x) {
+          i++;
+          lo = std::min(lo, pts[i].y);
+          hi = std::max(hi, pts[i].y);
+        }
+        a.y = lo;
+        b.y = hi;
+        if (lo == hi)
+          continue; // Repeated vertex; neighbours draw the joins
+      } else if (a.y == b.y) {
+        while (i < i1 && pts[i + 1].y == a.y)
+          i++;
+        b = pts[i];
+      }
+
+      if (outside_rows(a.y, b.y, cy1, cy2))
+        continue;
+      lv_point_t p1 = {(lv_coord_t)(gx + a.x), (lv_coord_t)(gy + a.y)};
+      lv_point_t p2 = {(lv_coord_t)(gx + b.x), (lv_coord_t)(gy + b.y)};
+      lv_draw_line(draw_ctx, &dsc, &p1, &p2);
+    }
+  }
+
+  void draw_markers(lv_draw_ctx_t *draw_ctx, int gx, int gy, size_t i0,
+                    size_t i1, int cy1, int cy2) {
+    const lv_img_dsc_t *sprite = marker.data ? &marker : nullptr;
+
+    lv_draw_img_dsc_t img_dsc;
+    lv_draw_img_dsc_init(&img_dsc);
+    lv_draw_rect_dsc_t rect_dsc; // Only without a sprite
+    lv_draw_rect_dsc_init(&rect_dsc);
+    rect_dsc.bg_color = lv_color_white();
+    rect_dsc.border_color = lv_palette_main(LV_PALETTE_BLUE);
+    rect_dsc.border_width = 2;
+    rect_dsc.radius = LV_RADIUS_CIRCLE;
+
+    for (size_t i = i0; i <= i1; i++) {
+      if (pts[i].y < cy1 || pts[i].y > cy2)
+        continue;
+      lv_area_t area;
+      area.x1 = gx + pts[i].x - MARKER_RADIUS;
+      area.y1 = gy + pts[i].y - MARKER_RADIUS;
+      area.x2 = area.x1 + MARKER_SIZE - 1;
+      area.y2 = area.y1 + MARKER_SIZE - 1;
+      if (sprite)
+        lv_draw_img(draw_ctx, &img_dsc, &area, sprite);
+      else
+        lv_draw_rect(draw_ctx, &rect_dsc, &area);
+    }
+  }
+
+  /**
+   * Marker Sprite
+   * The white, blue-ringed point marker rendered once into a small
+   * RGB565 + alpha image. Without it markers are drawn as rects.
+   */
+  void render_marker() {
+    uint32_t bytes =
+        LV_CANVAS_BUF_SIZE_TRUE_COLOR_ALPHA(MARKER_SIZE, MARKER_SIZE);
+    marker_buf = (uint8_t *)malloc(bytes);
+    if (!marker_buf)
+      return;
+    memset(marker_buf, 0, bytes); // Fully transparent
+
+    lv_obj_t *canvas = lv_canvas_create(lv_layer_sys());
+    lv_canvas_set_buffer(canvas, marker_buf, MARKER_SIZE, MARKER_SIZE,
+                         LV_IMG_CF_TRUE_COLOR_ALPHA);
+    lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+
+    lv_draw_rect_dsc_t dsc;
+    lv_draw_rect_dsc_init(&dsc);
+    dsc.bg_color = lv_color_white();
+    dsc.border_color = lv_palette_main(LV_PALETTE_BLUE);
+    dsc.border_width = 2;
+    dsc.radius = LV_RADIUS_CIRCLE;
+    lv_canvas_draw_rect(canvas, 0, 0, MARKER_SIZE, MARKER_SIZE, &dsc);
+    lv_obj_del(canvas);
+
+    marker.header.always_zero = 0;
+    marker.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    marker.header.w = MARKER_SIZE;
+    marker.header.h = MARKER_SIZE;
+    marker.data_size = bytes;
+    marker.data = marker_buf;
+  }
+};
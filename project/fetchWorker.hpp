@@ -0,0 +1,341 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include <vector>
+
+#include "7dayForecast.hpp"
+#include "httpsPool.hpp"
+#include "paramIndex.hpp"
+#include "seriesStore.hpp"
+#include "smhiApi.hpp"
+#include "stationCache.hpp"
+
+/**
+ * Fetch Worker
+ * Runs all SMHI downloads on a FreeRTOS task pinned to core 0, so the
+ * Arduino loop (core 1) keeps calling lv_timer_handler while a 10-15 s
+ * request is in flight.
+ *
+ * The UI posts requests to a queue and polls for results each loop:
+ * - Series requests are fetched into a back SeriesStore that the UI swaps
+ *   with weatherData (O(1) pointer swap, no copy)
+ * - Forecast requests fill a back ForecastData that the UI swaps into g_week
+ * - The parameter index request builds g_param_index's live masks (the UI
+ *   publishes them with g_param_index.poll()). The build pauses whenever
+ *   another request is queued and resumes once the queue is empty, so
+ *   series and forecasts never wait behind the metadata downloads.
+ * - The station cache request writes g_station_cache to flash
+ *
+ * A failed series or forecast download publishes an empty result, which
+ * the UI shows as "no data" instead of keeping the previous station's.
+ *
+ * Every request carries a generation number per kind. Posting a new request
+ * bumps the generation, which makes the in-flight download of that kind
+ * abort at its next chunk and any queued or finished older results be
+ * dropped, so only the latest city/parameter choice ever reaches the UI.
+ */
+
+// Global SMHI API instance (defined in project.ino, used only by the worker)
+extern SMHI_API weather;
+
+enum FetchKind : uint8_t {
+  FETCH_SERIES = 0, // Observation series -> weatherData
+  FETCH_FORECAST,   // 7-day forecast -> g_week
+  FETCH_PARAM_INDEX, // Station/parameter metadata -> g_param_index
+  FETCH_STATION_CACHE, // g_station_cache -> flash
+  FETCH_KIND_COUNT
+};
+
+struct FetchRequest {
+  uint8_t kind;
+  uint32_t generation;
+  int station_idx;
+  int param_code; // FETCH_SERIES only
+};
+
+static const uint32_t FETCH_WORKER_STACK = 16384; // TLS + forecast buffers
+static const UBaseType_t FETCH_WORKER_PRIORITY = 1;
+static const BaseType_t FETCH_WORKER_CORE = 0; // Arduino loop runs on core 1
+// One live request per kind fits, see fetch_worker_post
+static const UBaseType_t FETCH_QUEUE_LENGTH = FETCH_KIND_COUNT;
+
+static QueueHandle_t g_fetch_queue = NULL;
+static TaskHandle_t g_fetch_task = NULL;
+
+// Latest requested generation per kind (bumped by the UI)
+static std::atomic<uint32_t> g_fetch_generation[FETCH_KIND_COUNT];
+// Kind currently being downloaded (FETCH_KIND_COUNT = idle)
+static std::atomic<uint8_t> g_fetch_active(FETCH_KIND_COUNT);
+
+// Back buffers, owned by the worker while the ready flag is clear
+static SeriesStore g_series_back;
+static ForecastData g_forecast_back;
+static uint32_t g_result_generation[FETCH_KIND_COUNT];
+static std::atomic<bool> g_result_ready[FETCH_KIND_COUNT];
+
+// Parameter codes for the index build (bit n = code n)
+static const int *g_param_index_codes = nullptr;
+static int g_param_index_count = 0;
+// Index build that gave way to other requests (worker task only)
+static FetchRequest g_param_index_req;
+static bool g_param_index_paused = false;
+
+// ------------------------------------------------------------------
+// Cancellation
+// Passed to SMHI_API / WeekForecastView as their abort check; ctx points
+// at the generation of the request being served
+// ------------------------------------------------------------------
+static bool fetch_series_stale(void *ctx) {
+  return *(uint32_t *)ctx != g_fetch_generation[FETCH_SERIES].load();
+}
+
+static bool fetch_forecast_stale(void *ctx) {
+  return *(uint32_t *)ctx != g_fetch_generation[FETCH_FORECAST].load();
+}
+
+static bool fetch_request_stale(const FetchRequest &req) {
+  return req.generation != g_fetch_generation[req.kind].load();
+}
+
+// Index build yield check: anything posted since it started goes first
+static bool fetch_requests_waiting(void *ctx) {
+  (void)ctx;
+  return uxQueueMessagesWaiting(g_fetch_queue) > 0;
+}
+
+/**
+ * Serve One Request
+ * Waits until the UI has taken the previous result of the same kind,
+ * then downloads into the back buffer and publishes it
+ */
+static void fetch_worker_run(FetchRequest req) {
+  if (req.kind == FETCH_PARAM_INDEX) {
+    // Background metadata: no busy indicator
+    g_param_index_paused =
+        g_param_index.build(g_param_index_codes, g_param_index_count,
+                            fetch_requests_waiting,
+                            nullptr) == ParamIndex::BUILD_PAUSED;
+    g_param_index_req = req;
+    return;
+  }
+  if (req.kind == FETCH_STATION_CACHE) {
+    g_station_cache.save(); // Not a download: no busy indicator
+    return;
+  }
+
+  while (g_result_ready[req.kind].load(std::memory_order_acquire)) {
+    if (fetch_request_stale(req))
+      return;
+    vTaskDelay(pdMS_TO_TICKS(5));
+  }
+  if (fetch_request_stale(req))
+    return;
+
+  unsigned long start = millis();
+  bool ok = false;
+  g_fetch_active = req.kind;
+
+  if (req.kind == FETCH_SERIES) {
+    weather.setAbortCheck(fetch_series_stale, &req.generation);
+    ok = weather.update_series(req.station_idx, req.param_code,
+                               "latest-months", g_series_back);
+    weather.setAbortCheck(nullptr, nullptr);
+  } else {
+    g_week.setAbortCheck(fetch_forecast_stale, &req.generation);
+    ok = g_week.fetchForStationIdx(req.station_idx, g_forecast_back);
+    g_week.setAbortCheck(nullptr, nullptr);
+  }
+
+  g_fetch_active = FETCH_KIND_COUNT;
+
+  if (fetch_request_stale(req)) {
+    Serial.printf("FetchWorker: %s request %u dropped after %lu ms\n",
+                  req.kind == FETCH_SERIES ? "series" : "forecast",
+                  (unsigned)req.generation, millis() - start);
+    return;
+  }
+
+  // A failed download still publishes, empty, so the UI stops showing the
+  // previous station's data
+  if (!ok) {
+    if (req.kind == FETCH_SERIES)
+      g_series_back.clear();
+    else
+      g_forecast_back.clear();
+  }
+
+  g_result_generation[req.kind] = req.generation;
+  g_result_ready[req.kind].store(true, std::memory_order_release);
+  Serial.printf("FetchWorker: %s request %u %s in %lu ms\n",
+                req.kind == FETCH_SERIES ? "series" : "forecast",
+                (unsigned)req.generation, ok ? "done" : "failed",
+                millis() - start);
+}
+
+static void fetch_worker_task(void *arg) {
+  (void)arg;
+  FetchRequest req;
+  while (true) {
+    // A paused index build resumes as soon as the queue is empty
+    TickType_t wait =
+        g_param_index_paused ? 0 : pdMS_TO_TICKS(HTTPS_IDLE_CLOSE_MS);
+    if (xQueueReceive(g_fetch_queue, &req, wait) != pdTRUE) {
+      if (g_param_index_paused)
+        fetch_worker_run(g_param_index_req);
+      else
+        https_pool_close_idle(); // Quiet period: release TLS buffers
+      continue;
+    }
+    if (fetch_request_stale(req))
+      continue; // Superseded while queued
+    fetch_worker_run(req);
+  }
+}
+
+/**
+ * Start Fetch Worker
+ * Call once from setup(). If the task cannot be created requests are
+ * served synchronously on the caller (old blocking behaviour), except the
+ * parameter index build, which is skipped.
+ */
+static bool fetch_worker_begin() {
+  for (int k = 0; k < FETCH_KIND_COUNT; k++) {
+    g_fetch_generation[k] = 0;
+    g_result_ready[k] = false;
+  }
+  https_pool_begin(); // Before the worker and the probe tasks use it
+
+  g_fetch_queue = xQueueCreate(FETCH_QUEUE_LENGTH, sizeof(FetchRequest));
+  if (g_fetch_queue &&
+      xTaskCreatePinnedToCore(fetch_worker_task, "fetch",
+                              FETCH_WORKER_STACK, NULL, FETCH_WORKER_PRIORITY,
+                              &g_fetch_task, FETCH_WORKER_CORE) == pdPASS) {
+    return true;
+  }
+
+  Serial.println("FetchWorker: task creation failed, fetching synchronously");
+  g_fetch_task = NULL;
+  return false;
+}
+
+static void fetch_worker_post(uint8_t kind, int station_idx, int param_code) {
+  FetchRequest req;
+  req.kind = kind;
+  req.generation = ++g_fetch_generation[kind];
+  req.station_idx = station_idx;
+  req.param_code = param_code;
+
+  if (!g_fetch_task) {
+    // 39 metadata downloads would freeze the UI: probe stations instead
+    if (kind == FETCH_PARAM_INDEX) {
+      g_param_index.skipLive();
+      return;
+    }
+    g_result_ready[kind] = false; // Unclaimed older result is stale now
+    fetch_worker_run(req);
+    return;
+  }
+
+  if (xQueueSend(g_fetch_queue, &req, 0) == pdTRUE)
+    return;
+
+  // Queue full: take out the requests superseded by a newer one of their
+  // kind (the one just posted included) and requeue the rest in order.
+  // Only one request per kind is live, so this always makes room; a
+  // parameter index build or cache write is never dropped for space.
+  FetchRequest queued[FETCH_QUEUE_LENGTH];
+  UBaseType_t live = 0;
+  FetchRequest e;
+  while (live < FETCH_QUEUE_LENGTH &&
+         xQueueReceive(g_fetch_queue, &e, 0) == pdTRUE) {
+    if (!fetch_request_stale(e))
+      queued[live++] = e;
+  }
+  for (UBaseType_t i = 0; i < live; i++)
+    xQueueSend(g_fetch_queue, &queued[i], 0);
+  if (xQueueSend(g_fetch_queue, &req, 0) != pdTRUE)
+    Serial.printf("FetchWorker: queue full, request kind %u lost\n",
+                  (unsigned)kind);
+}
+
+/**
+ * Request Observation Series
+ * Cancels any series download still in flight
+ */
+static void fetch_worker_request_series(int station_idx, int param_code) {
+  fetch_worker_post(FETCH_SERIES, station_idx, param_code);
+}
+
+/**
+ * Request 7-day Forecast
+ * Cancels any forecast download still in flight
+ */
+static void fetch_worker_request_forecast(int station_idx) {
+  fetch_worker_post(FETCH_FORECAST, station_idx, 0);
+}
+
+/**
+ * Request Parameter Index Build
+ * Queued behind any series/forecast already posted and paused for any
+ * posted later; runs once. Skipped when requests are served
+ * synchronously.
+ *
+ * @param codes Parameter codes (must outlive the build)
+ */
+static void fetch_worker_request_param_index(const int *codes, int count) {
+  g_param_index_codes = codes;
+  g_param_index_count = count;
+  fetch_worker_post(FETCH_PARAM_INDEX, -1, 0);
+}
+
+/**
+ * Request Station Cache Write
+ * A newer request supersedes a queued one; the store is copied when the
+ * write starts, so it always saves the latest state
+ */
+static void fetch_worker_request_station_cache_save() {
+  fetch_worker_post(FETCH_STATION_CACHE, -1, 0);
+}
+
+// True while a series or forecast download is running (for a loading
+// indicator)
+static bool fetch_worker_busy() {
+  return g_fetch_active.load() != FETCH_KIND_COUNT;
+}
+
+/**
+ * Take Finished Series
+ * Swaps the newest completed series into front (normally weatherData);
+ * front ends up empty if that download failed
+ * Call from the LVGL thread only.
+ *
+ * @return true if front was replaced
+ */
+static bool fetch_worker_take_series(SeriesStore &front) {
+  if (!g_result_ready[FETCH_SERIES].load(std::memory_order_acquire))
+    return false;
+  bool current = g_result_generation[FETCH_SERIES] ==
+                 g_fetch_generation[FETCH_SERIES].load();
+  if (current)
+    front.swap(g_series_back);
+  g_result_ready[FETCH_SERIES].store(false, std::memory_order_release);
+  return current;
+}
+
+/**
+ * Take Finished Forecast
+ * Hands the newest completed forecast to the 7-day view
+ * Call from the LVGL thread only.
+ *
+ * @return true if the view was updated
+ */
+static bool fetch_worker_take_forecast(WeekForecastView &view) {
+  if (!g_result_ready[FETCH_FORECAST].load(std::memory_order_acquire))
+    return false;
+  bool current = g_result_generation[FETCH_FORECAST] ==
+                 g_fetch_generation[FETCH_FORECAST].load();
+  if (current)
+    view.show(g_forecast_back);
+  g_result_ready[FETCH_FORECAST].store(false, std::memory_order_release);
+  return current;
+}
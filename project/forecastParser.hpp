@@ -0,0 +1,327 @@
+#pragma once
+#include <Arduino.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "jsonPull.hpp"
+#include "seriesStore.hpp"
+
+/**
+ * Forecast Hour
+ * One pmp3g timestep (hourly at first, 3 h and 6 h steps further out)
+ * Missing parameters are NAN (symb 0)
+ */
+struct ForecastHour {
+  int32_t time; // validTime, epoch seconds UTC
+  float temp;   // t, air temperature (C)
+  float pmean;  // pmean, mean precipitation intensity (mm/h)
+  float wind;   // ws, wind speed (m/s)
+  float gust;   // gust, wind gust (m/s)
+  uint8_t symb; // Wsymb2 weather symbol (1-27)
+};
+
+/**
+ * Day Forecast Structure
+ * Aggregate of all timesteps falling on one local calendar day
+ */
+struct DayForecast {
+  String date;     // YYYY-MM-DD format (local date)
+  String weekday;  // Mon, Tue, Wed, etc.
+  float temp_min;  // Lowest t of the day
+  float temp_max;  // Highest t of the day
+  float precip_mm; // pmean integrated over each step's duration
+  float wind_max;  // Highest ws of the day
+  int symb;        // Dominant daytime Wsymb2 (longest total duration)
+};
+
+/**
+ * Forecast Data
+ * Parsed hourly series and the daily aggregates built from it
+ */
+struct ForecastData {
+  std::vector<ForecastHour> hours;
+  std::vector<DayForecast> days;
+
+  void clear() {
+    hours.clear();
+    days.clear();
+  }
+
+  void swap(ForecastData &other) {
+    hours.swap(other.hours);
+    days.swap(other.days);
+  }
+};
+
+static const size_t FORECAST_MAX_HOURS = 128; // pmp3g has ~80 steps
+static const size_t FORECAST_MAX_DAYS = 11;
+
+/**
+ * Forecast Parser
+ * Single pass over a pmp3g document with JsonPullParser
+ *
+ *   {"approvedTime":..., "timeSeries":[
+ *     {"validTime":"2024-01-01T13:00:00Z",
+ *      "parameters":[{"name":"t","levelType":"hl","level":2,
+ *                     "unit":"Cel","values":[4.2]}, ...]}, ...]}
+ *
+ * Every timestep is read exactly once into a compact ForecastHour; the
+ * parameter name is matched as it streams past, so no JSON document or
+ * per-timestep buffer is ever built. The only scratch memory is the pull
+ * parser's chunk and token buffers (under 600 bytes), reused for the
+ * whole response.
+ */
+class ForecastParser {
+public:
+  /**
+   * Parse Document
+   * @param json Parser positioned at the start of the response
+   * @param out Cleared, then filled with hours and daily aggregates
+   * @return true if the timeSeries array was read completely
+   */
+  static bool parse(JsonPullParser &json, ForecastData &out) {
+    out.clear();
+    out.hours.reserve(FORECAST_MAX_HOURS);
+
+    if (!json.findKey("timeSeries", 1) ||
+        json.next() != JsonPullParser::TOKEN_BEGIN_ARRAY)
+      return false;
+
+    JsonPullParser::Token tok;
+    while ((tok = json.next()) == JsonPullParser::TOKEN_BEGIN_OBJECT) {
+      ForecastHour h = {0, NAN, NAN, NAN, NAN, 0};
+      bool have_time = false;
+
+      while ((tok = json.next()) == JsonPullParser::TOKEN_KEY) {
+        if (json.textEquals("validTime")) {
+          if (json.next() != JsonPullParser::TOKEN_STRING)
+            return false;
+          have_time = parse_iso_date(json.text(), h.time);
+        } else if (json.textEquals("parameters")) {
+          if (!read_parameters(json, h))
+            return false;
+        } else if (!json.skipValue()) {
+          return false;
+        }
+      }
+      if (tok != JsonPullParser::TOKEN_END_OBJECT)
+        return false;
+
+      if (have_time && out.hours.size() < FORECAST_MAX_HOURS)
+        out.hours.push_back(h);
+    }
+    if (tok != JsonPullParser::TOKEN_END_ARRAY)
+      return false;
+
+    build_days(out);
+    return true;
+  }
+
+  /**
+   * Build Daily Aggregates
+   * Groups hours by local calendar day. Each step stands for the time up
+   * to the next step, which weights precipitation and symbols correctly
+   * once the series thins out to 3 h and 6 h steps.
+   */
+  static void build_days(ForecastData &d) {
+    d.days.clear();
+    size_t n = d.hours.size();
+
+    DayAccum acc;
+    int cur_key = -1;
+    for (size_t i = 0; i < n; i++) {
+      const ForecastHour &h = d.hours[i];
+      int32_t dur = step_seconds(d.hours, i);
+
+      struct tm tmv;
+      time_t tt = (time_t)h.time;
+      localtime_r(&tt, &tmv);
+      int key = (tmv.tm_year + 1900) * 10000 + (tmv.tm_mon + 1) * 100 +
+                tmv.tm_mday;
+
+      if (key != cur_key) {
+        if (cur_key >= 0 && !acc.flush(d.days))
+          return;
+        acc.start(tmv);
+        cur_key = key;
+      }
+      acc.add(h, dur, tmv.tm_hour);
+    }
+    if (cur_key >= 0)
+      acc.flush(d.days);
+  }
+
+private:
+  enum Field : uint8_t {
+    FIELD_NONE = 0,
+    FIELD_TEMP,
+    FIELD_PMEAN,
+    FIELD_WIND,
+    FIELD_GUST,
+    FIELD_SYMB
+  };
+
+  static Field field_for(const JsonPullParser &json) {
+    if (json.textEquals("t"))
+      return FIELD_TEMP;
+    if (json.textEquals("Wsymb2"))
+      return FIELD_SYMB;
+    if (json.textEquals("pmean"))
+      return FIELD_PMEAN;
+    if (json.textEquals("ws"))
+      return FIELD_WIND;
+    if (json.textEquals("gust"))
+      return FIELD_GUST;
+    return FIELD_NONE;
+  }
+
+  /**
+   * Read Parameters Array
+   * Keeps the first value of the parameters we use; the rest of each
+   * entry (level, unit, ...) is skipped
+   */
+  static bool read_parameters(JsonPullParser &json, ForecastHour &h) {
+    if (json.next() != JsonPullParser::TOKEN_BEGIN_ARRAY)
+      return false;
+
+    JsonPullParser::Token tok;
+    while ((tok = json.next()) == JsonPullParser::TOKEN_BEGIN_OBJECT) {
+      Field field = FIELD_NONE;
+      float value = NAN;
+
+      while ((tok = json.next()) == JsonPullParser::TOKEN_KEY) {
+        if (json.textEquals("name")) {
+          if (json.next() != JsonPullParser::TOKEN_STRING)
+            return false;
+          field = field_for(json);
+        } else if (json.textEquals("values")) {
+          if (json.next() != JsonPullParser::TOKEN_BEGIN_ARRAY)
+            return false;
+          tok = json.next();
+          if (tok == JsonPullParser::TOKEN_NUMBER)
+            value = json.textAsFloat();
+          if (tok != JsonPullParser::TOKEN_END_ARRAY && !json.skipContainer())
+            return false;
+        } else if (!json.skipValue()) {
+          return false;
+        }
+      }
+      if (tok != JsonPullParser::TOKEN_END_OBJECT)
+        return false;
+
+      switch (field) {
+      case FIELD_TEMP:
+        h.temp = value;
+        break;
+      case FIELD_PMEAN:
+        h.pmean = value;
+        break;
+      case FIELD_WIND:
+        h.wind = value;
+        break;
+      case FIELD_GUST:
+        h.gust = value;
+        break;
+      case FIELD_SYMB:
+        if (value >= 1 && value <= 27)
+          h.symb = (uint8_t)value;
+        break;
+      default:
+        break;
+      }
+    }
+    return tok == JsonPullParser::TOKEN_END_ARRAY;
+  }
+
+  // Duration a step stands for: until the next step (last: as the previous)
+  static int32_t step_seconds(const std::vector<ForecastHour> &hours,
+                              size_t i) {
+    int32_t dur = 3600;
+    if (i + 1 < hours.size())
+      dur = hours[i + 1].time - hours[i].time;
+    else if (i > 0)
+      dur = hours[i].time - hours[i - 1].time;
+    if (dur < 600)
+      dur = 600;
+    if (dur > 12 * 3600)
+      dur = 12 * 3600;
+    return dur;
+  }
+
+  /**
+   * Day Accumulator
+   * Running aggregate for the day being parsed
+   */
+  struct DayAccum {
+    struct tm day;
+    float tmin, tmax, precip, wind;
+    uint32_t symb_day[28]; // Seconds per symbol, 06-18 local
+    uint32_t symb_all[28]; // Seconds per symbol, whole day
+
+    void start(const struct tm &t) {
+      day = t;
+      tmin = INFINITY;
+      tmax = -INFINITY;
+      precip = 0.0f;
+      wind = NAN;
+      memset(symb_day, 0, sizeof(symb_day));
+      memset(symb_all, 0, sizeof(symb_all));
+    }
+
+    void add(const ForecastHour &h, int32_t dur, int local_hour) {
+      if (!isnan(h.temp)) {
+        if (h.temp < tmin)
+          tmin = h.temp;
+        if (h.temp > tmax)
+          tmax = h.temp;
+      }
+      if (!isnan(h.pmean) && h.pmean > 0)
+        precip += h.pmean * (float)dur / 3600.0f;
+      if (!isnan(h.wind) && (isnan(wind) || h.wind > wind))
+        wind = h.wind;
+      if (h.symb) {
+        symb_all[h.symb] += (uint32_t)dur;
+        if (local_hour >= 6 && local_hour < 18)
+          symb_day[h.symb] += (uint32_t)dur;
+      }
+    }
+
+    // Longest-lasting symbol; ties go to the higher (more severe) code
+    static int dominant(const uint32_t *secs) {
+      int best = 0;
+      for (int s = 1; s < 28; s++) {
+        if (secs[s] && secs[s] >= secs[best])
+          best = s;
+      }
+      return best;
+    }
+
+    bool flush(std::vector<DayForecast> &days) {
+      if (tmin > tmax) // No temperature at all: not worth a card
+        return true;
+      if (days.size() >= FORECAST_MAX_DAYS)
+        return false;
+
+      static const char *names[] = {"Sun", "Mon", "Tue", "Wed",
+                                    "Thu", "Fri", "Sat"};
+      char date[36]; // Room for any int fields, not just valid dates
+      snprintf(date, sizeof(date), "%04d-%02d-%02d", day.tm_year + 1900,
+               day.tm_mon + 1, day.tm_mday);
+
+      DayForecast d;
+      d.date = date;
+      d.weekday = names[day.tm_wday];
+      d.temp_min = tmin;
+      d.temp_max = tmax;
+      d.precip_mm = precip;
+      d.wind_max = isnan(wind) ? 0.0f : wind;
+      d.symb = dominant(symb_day);
+      if (!d.symb)
+        d.symb = dominant(symb_all);
+      days.push_back(d);
+      return true;
+    }
+  };
+};
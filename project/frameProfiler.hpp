@@ -0,0 +1,480 @@
+#pragma once
+#include <Arduino.h>
+#include <lvgl.h>
+#include <src/draw/sw/lv_draw_sw.h> // lv_draw_sw_ctx_t, blend hook
+#include <string.h>
+
+/**
+ * Frame Profiler
+ * Where each LVGL frame's time goes, measured on the device
+ *
+ * begin() wraps the display's refresh timer, flush callback and the
+ * software draw context's primitives (rect, label glyphs, images, lines,
+ * arcs, polygons and the blend stage underneath them all). Every frame
+ * that redraws something records:
+ *   - invalidated areas and pixels (before LVGL joins overlapping areas)
+ *   - layout, whole refresh, flush and per-primitive draw time
+ *   - named scopes in our own draw callbacks (FrameProfScope)
+ * Per-frame totals go into log2 histograms and the last
+ * FRAME_PROF_HISTORY frames are kept as they are. lv_timer_handler() is
+ * timed per call by the main loop.
+ *
+ * Draw times nest: blend is part of the primitive that called it, and
+ * every primitive is part of the refresh.
+ *
+ * The hooks are always compiled in and cost one branch per call while
+ * disabled. Build with -DFRAME_PROFILER to start enabled; over the serial
+ * monitor:
+ *   p  enable / disable        r  reset
+ *   c  summary as CSV          j  summary as JSON
+ *   f  recent frames as CSV
+ */
+
+enum FrameProfMetric : uint8_t {
+  PROF_TIMER_HANDLER = 0, // lv_timer_handler(), per call
+  PROF_REFRESH,           // Whole display refresh incl. layout and flush
+  PROF_LAYOUT,            // lv_obj_update_layout() of the screens
+  PROF_DRAW_RECT,         // Rects and backgrounds (objects, buttons, ...)
+  PROF_DRAW_LABEL,        // Glyphs (labels)
+  PROF_DRAW_IMG,          // Decoded images (icons, canvases)
+  PROF_DRAW_LINE,         // Lines (chart series, bars)
+  PROF_DRAW_ARC,          // Arcs (spinners)
+  PROF_DRAW_POLYGON,      // Polygons
+  PROF_BLEND,             // Software blend under all of the above
+  PROF_FLUSH,             // Display flush callback
+  PROF_CHART_SERIES,      // Scope: history chart series (DRAW_POST)
+  PROF_METRIC_COUNT
+};
+
+static const char *const FRAME_PROF_NAMES[PROF_METRIC_COUNT] = {
+    "timer_handler", "refresh",    "layout", "draw_rect",
+    "draw_label",    "draw_img",   "draw_line", "draw_arc",
+    "draw_polygon",  "blend",      "flush",  "chart_series"};
+
+// Histogram bucket k holds totals in [32 << k, 64 << k) us; bucket 0 also
+// takes everything shorter, the last one everything longer (> 0.5 s)
+static const int FRAME_PROF_BUCKETS = 14;
+static const int FRAME_PROF_HISTORY = 32;
+
+class FrameProfiler {
+public:
+  /**
+   * Install Hooks
+   * Call once after the display driver is registered (LVGL thread)
+   */
+  void begin() {
+    lv_disp_t *disp = lv_disp_get_default();
+    if (!disp || installed)
+      return;
+    installed = true;
+
+    lv_timer_set_cb(disp->refr_timer, refr_timer_cb);
+    orig_flush = disp->driver->flush_cb;
+    disp->driver->flush_cb = flush_cb;
+
+    lv_draw_ctx_t *ctx = disp->driver->draw_ctx;
+    orig.draw_rect = ctx->draw_rect;
+    orig.draw_bg = ctx->draw_bg;
+    orig.draw_letter = ctx->draw_letter;
+    orig.draw_img_decoded = ctx->draw_img_decoded;
+    orig.draw_line = ctx->draw_line;
+    orig.draw_arc = ctx->draw_arc;
+    orig.draw_polygon = ctx->draw_polygon;
+    if (ctx->draw_rect)
+      ctx->draw_rect = draw_rect_cb;
+    if (ctx->draw_bg)
+      ctx->draw_bg = draw_bg_cb;
+    if (ctx->draw_letter)
+      ctx->draw_letter = draw_letter_cb;
+    if (ctx->draw_img_decoded)
+      ctx->draw_img_decoded = draw_img_cb;
+    if (ctx->draw_line)
+      ctx->draw_line = draw_line_cb;
+    if (ctx->draw_arc)
+      ctx->draw_arc = draw_arc_cb;
+    if (ctx->draw_polygon)
+      ctx->draw_polygon = draw_polygon_cb;
+    // Every LVGL 8 draw context (no GPU enabled here) is a software one
+    lv_draw_sw_ctx_t *sw = (lv_draw_sw_ctx_t *)ctx;
+    orig_blend = sw->blend;
+    if (sw->blend)
+      sw->blend = blend_cb;
+
+#ifdef FRAME_PROFILER
+    enabled = true;
+#endif
+  }
+
+  bool isEnabled() const { return enabled; }
+  void setEnabled(bool on) { enabled = on; }
+
+  void reset() {
+    memset(stats, 0, sizeof(stats));
+    memset(inv_hist, 0, sizeof(inv_hist));
+    memset(history, 0, sizeof(history));
+    frames = 0;
+    inv_areas_total = 0;
+    inv_px_total = 0;
+  }
+
+  // Time spent in one lv_timer_handler() call
+  void recordTimerHandler(uint32_t us) {
+    if (enabled)
+      add_sample(stats[PROF_TIMER_HANDLER], us, 1);
+  }
+
+  // Adds to the current frame; ignored outside of a refresh
+  void add(FrameProfMetric m, uint32_t us) {
+    if (in_frame) {
+      cur_us[m] += us;
+      cur_calls[m]++;
+    }
+  }
+
+  /**
+   * Serial Commands
+   * Handles the single-letter commands listed above; call from loop()
+   */
+  void pollSerial() {
+    while (Serial.available() > 0) {
+      switch (Serial.read()) {
+      case 'p':
+        enabled = !enabled;
+        Serial.printf("FrameProfiler: %s\n", enabled ? "on" : "off");
+        break;
+      case 'r':
+        reset();
+        Serial.println("FrameProfiler: reset");
+        break;
+      case 'c':
+        dumpCsv();
+        break;
+      case 'j':
+        dumpJson();
+        break;
+      case 'f':
+        dumpFrames();
+        break;
+      default:
+        break;
+      }
+    }
+  }
+
+  // One line per metric: frames it occurred in, calls, sum, max, histogram
+  void dumpCsv() const {
+    Serial.printf("# frames,%lu,inv_areas,%lu,inv_px,%llu\n",
+                  (unsigned long)frames, (unsigned long)inv_areas_total,
+                  (unsigned long long)inv_px_total);
+    Serial.print("metric,n,calls,sum_us,max_us");
+    for (int b = 0; b < FRAME_PROF_BUCKETS; b++)
+      Serial.printf(",lt%lu", (unsigned long)bucket_limit(b));
+    Serial.println();
+    for (int m = 0; m < PROF_METRIC_COUNT; m++) {
+      const Stat &s = stats[m];
+      Serial.printf("%s,%lu,%lu,%llu,%lu", FRAME_PROF_NAMES[m],
+                    (unsigned long)s.n, (unsigned long)s.calls,
+                    (unsigned long long)s.sum_us, (unsigned long)s.max_us);
+      for (int b = 0; b < FRAME_PROF_BUCKETS; b++)
+        Serial.printf(",%lu", (unsigned long)s.hist[b]);
+      Serial.println();
+    }
+    Serial.print("inv_px_hist");
+    for (int b = 0; b < FRAME_PROF_BUCKETS; b++)
+      Serial.printf(",%lu", (unsigned long)inv_hist[b]);
+    Serial.println();
+  }
+
+  void dumpJson() const {
+    Serial.printf("{\"frames\":%lu,\"inv_areas\":%lu,\"inv_px\":%llu,"
+                  "\"bucket_us\":32,\"metrics\":{",
+                  (unsigned long)frames, (unsigned long)inv_areas_total,
+                  (unsigned long long)inv_px_total);
+    for (int m = 0; m < PROF_METRIC_COUNT; m++) {
+      const Stat &s = stats[m];
+      Serial.printf("%s\"%s\":{\"n\":%lu,\"calls\":%lu,\"sum\":%llu,"
+                    "\"max\":%lu,\"hist\":[",
+                    m ? "," : "", FRAME_PROF_NAMES[m], (unsigned long)s.n,
+                    (unsigned long)s.calls, (unsigned long long)s.sum_us,
+                    (unsigned long)s.max_us);
+      for (int b = 0; b < FRAME_PROF_BUCKETS; b++)
+        Serial.printf("%s%lu", b ? "," : "", (unsigned long)s.hist[b]);
+      Serial.print("]}");
+    }
+    Serial.print("},\"inv_px_hist\":[");
+    for (int b = 0; b < FRAME_PROF_BUCKETS; b++)
+      Serial.printf("%s%lu", b ? "," : "", (unsigned long)inv_hist[b]);
+    Serial.println("]}");
+  }
+
+  // Last FRAME_PROF_HISTORY frames, oldest first; times in us
+  void dumpFrames() const {
+    Serial.print("frame,ms,inv_areas,inv_px");
+    for (int m = PROF_REFRESH; m < PROF_METRIC_COUNT; m++)
+      Serial.printf(",%s", FRAME_PROF_NAMES[m]);
+    Serial.println();
+    uint32_t n = frames < FRAME_PROF_HISTORY ? frames : FRAME_PROF_HISTORY;
+    for (uint32_t i = frames - n; i < frames; i++) {
+      const FrameRecord &f = history[i % FRAME_PROF_HISTORY];
+      Serial.printf("%lu,%lu,%u,%lu", (unsigned long)i,
+                    (unsigned long)f.start_ms, (unsigned)f.inv_areas,
+                    (unsigned long)f.inv_px);
+      for (int m = PROF_REFRESH; m < PROF_METRIC_COUNT; m++)
+        Serial.printf(",%lu", (unsigned long)f.us[m]);
+      Serial.println();
+    }
+  }
+
+private:
+  struct Stat {
+    uint32_t n;     // Frames (calls for the timer handler) with any time
+    uint32_t calls; // Individual calls
+    uint64_t sum_us;
+    uint32_t max_us;
+    uint32_t hist[FRAME_PROF_BUCKETS];
+  };
+
+  struct FrameRecord {
+    uint32_t start_ms;
+    uint16_t inv_areas;
+    uint32_t inv_px;
+    uint32_t us[PROF_METRIC_COUNT];
+  };
+
+  struct DrawFns {
+    void (*draw_rect)(lv_draw_ctx_t *, const lv_draw_rect_dsc_t *,
+                      const lv_area_t *);
+    void (*draw_bg)(lv_draw_ctx_t *, const lv_draw_rect_dsc_t *,
+                    const lv_area_t *);
+    void (*draw_letter)(lv_draw_ctx_t *, const lv_draw_label_dsc_t *,
+                        const lv_point_t *, uint32_t);
+    void (*draw_img_decoded)(lv_draw_ctx_t *, const lv_draw_img_dsc_t *,
+                             const lv_area_t *, const uint8_t *, lv_img_cf_t);
+    void (*draw_line)(lv_draw_ctx_t *, const lv_draw_line_dsc_t *,
+                      const lv_point_t *, const lv_point_t *);
+    void (*draw_arc)(lv_draw_ctx_t *, const lv_draw_arc_dsc_t *,
+                     const lv_point_t *, uint16_t, uint16_t, uint16_t);
+    void (*draw_polygon)(lv_draw_ctx_t *, const lv_draw_rect_dsc_t *,
+                         const lv_point_t *, uint16_t);
+  };
+
+  bool installed = false;
+  bool enabled = false;
+  bool in_frame = false;
+
+  Stat stats[PROF_METRIC_COUNT] = {};
+  uint32_t inv_hist[FRAME_PROF_BUCKETS] = {};
+  FrameRecord history[FRAME_PROF_HISTORY] = {};
+  uint32_t frames = 0;
+  uint32_t inv_areas_total = 0;
+  uint64_t inv_px_total = 0;
+
+  uint32_t cur_us[PROF_METRIC_COUNT] = {};
+  uint32_t cur_calls[PROF_METRIC_COUNT] = {};
+
+  DrawFns orig = {};
+  void (*orig_flush)(lv_disp_drv_t *, const lv_area_t *, lv_color_t *) =
+      nullptr;
+  void (*orig_blend)(lv_draw_ctx_t *, const lv_draw_sw_blend_dsc_t *) =
+      nullptr;
+
+  static uint32_t bucket_limit(int b) { return 64u << b; }
+
+  static int bucket_of(uint32_t v) {
+    int b = 0;
+    while (b < FRAME_PROF_BUCKETS - 1 && v >= bucket_limit(b))
+      b++;
+    return b;
+  }
+
+  static void add_sample(Stat &s, uint32_t us, uint32_t calls) {
+    s.n++;
+    s.calls += calls;
+    s.sum_us += us;
+    if (us > s.max_us)
+      s.max_us = us;
+    s.hist[bucket_of(us)]++;
+  }
+
+  void begin_frame() {
+    memset(cur_us, 0, sizeof(cur_us));
+    memset(cur_calls, 0, sizeof(cur_calls));
+    in_frame = true;
+  }
+
+  void end_frame(uint32_t start_ms, uint16_t areas, uint32_t px) {
+    in_frame = false;
+    FrameRecord &f = history[frames % FRAME_PROF_HISTORY];
+    f.start_ms = start_ms;
+    f.inv_areas = areas;
+    f.inv_px = px;
+    for (int m = PROF_REFRESH; m < PROF_METRIC_COUNT; m++) {
+      f.us[m] = cur_us[m];
+      if (cur_calls[m])
+        add_sample(stats[m], cur_us[m], cur_calls[m]);
+    }
+    inv_hist[bucket_of(px / 16)]++; // Pixel buckets start at 1024 px
+    inv_areas_total += areas;
+    inv_px_total += px;
+    frames++;
+  }
+
+  // ------------------------------------------------------------------
+  // Hooks (LVGL thread)
+  // ------------------------------------------------------------------
+  static void refr_timer_cb(lv_timer_t *t);
+  static void flush_cb(lv_disp_drv_t *drv, const lv_area_t *area,
+                       lv_color_t *color_p);
+
+  static void draw_rect_cb(lv_draw_ctx_t *ctx, const lv_draw_rect_dsc_t *dsc,
+                           const lv_area_t *coords);
+  static void draw_bg_cb(lv_draw_ctx_t *ctx, const lv_draw_rect_dsc_t *dsc,
+                         const lv_area_t *coords);
+  static void draw_letter_cb(lv_draw_ctx_t *ctx,
+                             const lv_draw_label_dsc_t *dsc,
+                             const lv_point_t *pos, uint32_t letter);
+  static void draw_img_cb(lv_draw_ctx_t *ctx, const lv_draw_img_dsc_t *dsc,
+                          const lv_area_t *coords, const uint8_t *map,
+                          lv_img_cf_t cf);
+  static void draw_line_cb(lv_draw_ctx_t *ctx, const lv_draw_line_dsc_t *dsc,
+                           const lv_point_t *p1, const lv_point_t *p2);
+  static void draw_arc_cb(lv_draw_ctx_t *ctx, const lv_draw_arc_dsc_t *dsc,
+                          const lv_point_t *center, uint16_t radius,
+                          uint16_t start_angle, uint16_t end_angle);
+  static void draw_polygon_cb(lv_draw_ctx_t *ctx,
+                              const lv_draw_rect_dsc_t *dsc,
+                              const lv_point_t *points, uint16_t count);
+  static void blend_cb(lv_draw_ctx_t *ctx, const lv_draw_sw_blend_dsc_t *dsc);
+};
+
+static FrameProfiler g_frame_profiler;
+
+/**
+ * Profiler Scope
+ * Adds the time until the end of the enclosing block to metric m of the
+ * frame being drawn
+ */
+class FrameProfScope {
+public:
+  explicit FrameProfScope(FrameProfMetric m)
+      : metric(m), start(g_frame_profiler.isEnabled() ? micros() : 0) {}
+  ~FrameProfScope() {
+    if (start)
+      g_frame_profiler.add(metric, micros() - start);
+  }
+
+private:
+  FrameProfMetric metric;
+  uint32_t start;
+};
+
+// Times one call of a wrapped function into metric m
+#define FRAME_PROF_CALL(m, call)                                             \
+  do {                                                                       \
+    if (!g_frame_profiler.in_frame) {                                        \
+      call;                                                                  \
+    } else {                                                                 \
+      uint32_t prof_t0 = micros();                                           \
+      call;                                                                  \
+      g_frame_profiler.add(m, micros() - prof_t0);                           \
+    }                                                                        \
+  } while (0)
+
+inline void FrameProfiler::refr_timer_cb(lv_timer_t *t) {
+  FrameProfiler &p = g_frame_profiler;
+  lv_disp_t *disp = (lv_disp_t *)t->user_data;
+  if (!p.enabled || !disp || !disp->act_scr) {
+    _lv_disp_refr_timer(t);
+    return;
+  }
+
+  uint32_t t0 = micros();
+  // Same layout pass the refresh starts with; it is then a no-op there
+  lv_obj_update_layout(disp->act_scr);
+  if (disp->prev_scr)
+    lv_obj_update_layout(disp->prev_scr);
+  lv_obj_update_layout(disp->top_layer);
+  lv_obj_update_layout(disp->sys_layer);
+  uint32_t t_layout = micros() - t0;
+
+  uint16_t areas = disp->inv_p;
+  uint32_t px = 0;
+  for (uint16_t i = 0; i < areas; i++)
+    px += lv_area_get_size(&disp->inv_areas[i]);
+  if (areas == 0) { // Nothing to redraw: not a frame
+    _lv_disp_refr_timer(t);
+    return;
+  }
+
+  p.begin_frame();
+  _lv_disp_refr_timer(t);
+  p.cur_us[PROF_LAYOUT] = t_layout;
+  p.cur_calls[PROF_LAYOUT] = 1;
+  p.cur_us[PROF_REFRESH] = micros() - t0;
+  p.cur_calls[PROF_REFRESH] = 1;
+  p.end_frame(t0 / 1000, areas, px);
+}
+
+inline void FrameProfiler::flush_cb(lv_disp_drv_t *drv, const lv_area_t *area,
+                             lv_color_t *color_p) {
+  FRAME_PROF_CALL(PROF_FLUSH,
+                  g_frame_profiler.orig_flush(drv, area, color_p));
+}
+
+inline void FrameProfiler::draw_rect_cb(lv_draw_ctx_t *ctx,
+                                 const lv_draw_rect_dsc_t *dsc,
+                                 const lv_area_t *coords) {
+  FRAME_PROF_CALL(PROF_DRAW_RECT,
+                  g_frame_profiler.orig.draw_rect(ctx, dsc, coords));
+}
+
+inline void FrameProfiler::draw_bg_cb(lv_draw_ctx_t *ctx,
+                               const lv_draw_rect_dsc_t *dsc,
+                               const lv_area_t *coords) {
+  FRAME_PROF_CALL(PROF_DRAW_RECT,
+                  g_frame_profiler.orig.draw_bg(ctx, dsc, coords));
+}
+
+inline void FrameProfiler::draw_letter_cb(lv_draw_ctx_t *ctx,
+                                   const lv_draw_label_dsc_t *dsc,
+                                   const lv_point_t *pos, uint32_t letter) {
+  FRAME_PROF_CALL(PROF_DRAW_LABEL,
+                  g_frame_profiler.orig.draw_letter(ctx, dsc, pos, letter));
+}
+
+inline void FrameProfiler::draw_img_cb(lv_draw_ctx_t *ctx,
+                                const lv_draw_img_dsc_t *dsc,
+                                const lv_area_t *coords, const uint8_t *map,
+                                lv_img_cf_t cf) {
+  FRAME_PROF_CALL(PROF_DRAW_IMG, g_frame_profiler.orig.draw_img_decoded(
+                                     ctx, dsc, coords, map, cf));
+}
+
+inline void FrameProfiler::draw_line_cb(lv_draw_ctx_t *ctx,
+                                 const lv_draw_line_dsc_t *dsc,
+                                 const lv_point_t *p1, const lv_point_t *p2) {
+  FRAME_PROF_CALL(PROF_DRAW_LINE,
+                  g_frame_profiler.orig.draw_line(ctx, dsc, p1, p2));
+}
+
+inline void FrameProfiler::draw_arc_cb(lv_draw_ctx_t *ctx,
+                                const lv_draw_arc_dsc_t *dsc,
+                                const lv_point_t *center, uint16_t radius,
+                                uint16_t start_angle, uint16_t end_angle) {
+  FRAME_PROF_CALL(PROF_DRAW_ARC,
+                  g_frame_profiler.orig.draw_arc(ctx, dsc, center, radius,
+                                                 start_angle, end_angle));
+}
+
+inline void FrameProfiler::draw_polygon_cb(lv_draw_ctx_t *ctx,
+                                    const lv_draw_rect_dsc_t *dsc,
+                                    const lv_point_t *points,
+                                    uint16_t count) {
+  FRAME_PROF_CALL(PROF_DRAW_POLYGON,
+                  g_frame_profiler.orig.draw_polygon(ctx, dsc, points, count));
+}
+
+inline void FrameProfiler::blend_cb(lv_draw_ctx_t *ctx,
+                             const lv_draw_sw_blend_dsc_t *dsc) {
+  FRAME_PROF_CALL(PROF_BLEND, g_frame_profiler.orig_blend(ctx, dsc));
+}
@@ -0,0 +1,423 @@
+#pragma once
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+#include <atomic>
+
+/**
+ * HTTPS Connection Pool
+ * Keeps TLS connections to the SMHI hosts open between requests
+ *
+ * Every request used to build a fresh WiFiClientSecure + HTTPClient and pay
+ * a full TLS handshake (~1 s on the ESP32-S3). Here each host owns a couple
+ * of long-lived connection slots; HTTPClient runs with keep-alive, so a
+ * request on a slot that is still connected goes straight to GET.
+ *
+ * A slot is leased by one HttpsRequest at a time (the fetch worker, the
+ * settings tile and the station probes all talk to the observation host).
+ * The slot locks are created by https_pool_begin() before any of those
+ * tasks start. Each request records DNS, connect (TCP + TLS),
+ * time-to-first-byte and body timings.
+ *
+ * The hosts can be pointed at a local stand-in server with build flags,
+ * see tools/smhi_standin.py:
+ *   -DSMHI_METOBS_HOST=\"192.168.1.10\" -DSMHI_METFCST_HOST=\"192.168.1.10\"
+ *   -DSMHI_HTTPS_PORT=8443
+ */
+
+#ifndef SMHI_METOBS_HOST
+#define SMHI_METOBS_HOST "opendata-download-metobs.smhi.se"
+#endif
+#ifndef SMHI_METFCST_HOST
+#define SMHI_METFCST_HOST "opendata-download-metfcst.smhi.se"
+#endif
+#ifndef SMHI_HTTPS_PORT
+#define SMHI_HTTPS_PORT 443
+#endif
+
+static const uint8_t HTTPS_MAX_SLOTS = 3;
+static const uint8_t HTTPS_MAX_HOSTS = 4;
+static const uint32_t HTTPS_IDLE_CLOSE_MS = 20000; // Servers drop idle links
+static const size_t HTTPS_DRAIN_LIMIT = 8192; // Larger unread bodies: close
+
+/**
+ * Request Timing
+ * Milliseconds spent in each phase of the last request on a host
+ * dns_ms/connect_ms are 0 when an open connection was reused
+ */
+struct HttpTiming {
+  uint32_t dns_ms;
+  uint32_t connect_ms; // TCP + TLS handshake
+  uint32_t ttfb_ms;    // Request sent -> status line and headers read
+  uint32_t body_ms;    // Headers read -> request finished
+  uint32_t bytes;      // Body bytes consumed by the caller
+  bool reused;
+};
+
+/**
+ * HTTPS Host
+ * Connection slots and counters for one host name
+ */
+class HttpsHost {
+public:
+  HttpsHost(const char *host_name, uint16_t port_no, uint8_t slot_count)
+      : host(host_name), port(port_no),
+        slots(slot_count < HTTPS_MAX_SLOTS ? slot_count : HTTPS_MAX_SLOTS) {
+    Registry &r = registry();
+    if (r.count < HTTPS_MAX_HOSTS)
+      r.hosts[r.count++] = this;
+  }
+
+  // Every host constructed so far (https_pool_begin, https_pool_close_idle)
+  static HttpsHost *const *hosts(uint8_t &count) {
+    count = registry().count;
+    return registry().hosts;
+  }
+
+  /**
+   * Create Slot Locks
+   * Once, from setup() before any task uses the host (see
+   * https_pool_begin); leases taken before that fail
+   */
+  bool begin() {
+    for (uint8_t i = 0; i < slots; i++) {
+      if (!slot[i].lock)
+        slot[i].lock = xSemaphoreCreateMutex();
+      if (!slot[i].lock)
+        return false;
+    }
+    return true;
+  }
+
+  const char *name() const { return host; }
+
+  // Base URL ("https://host[:port]") for building request URLs
+  String baseUrl() const {
+    String url = "https://";
+    url += host;
+    if (port != 443) {
+      url += ":";
+      url += String(port);
+    }
+    return url;
+  }
+
+  // Cumulative counters (diagnostics), bumped by whichever task leases
+  std::atomic<uint32_t> requests{0};
+  std::atomic<uint32_t> reuses{0};
+  std::atomic<uint32_t> handshakes{0};
+  std::atomic<uint32_t> failures{0};
+
+  /**
+   * Close Idle Connections
+   * Frees the TLS buffers of slots unused for longer than idle_ms
+   * Slots leased right now are left alone.
+   */
+  void closeIdle(uint32_t idle_ms) {
+    for (uint8_t i = 0; i < slots; i++) {
+      Slot &s = slot[i];
+      if (!s.lock || xSemaphoreTake(s.lock, 0) != pdTRUE)
+        continue;
+      if (s.client && s.client->connected() &&
+          millis() - s.last_used > idle_ms) {
+        s.client->stop();
+        Serial.printf("HTTPS: closed idle connection to %s\n", host);
+      }
+      xSemaphoreGive(s.lock);
+    }
+  }
+
+private:
+  friend class HttpsRequest;
+
+  struct Slot {
+    SemaphoreHandle_t lock = NULL;
+    WiFiClientSecure *client = nullptr;
+    HTTPClient *http = nullptr;
+    unsigned long last_used = 0;
+  };
+
+  const char *host;
+  uint16_t port;
+  uint8_t slots;
+  Slot slot[HTTPS_MAX_SLOTS];
+
+  struct Registry {
+    HttpsHost *hosts[HTTPS_MAX_HOSTS];
+    uint8_t count;
+  };
+
+  // Function-local so it is ready whichever global host is built first
+  static Registry &registry() {
+    static Registry r = {};
+    return r;
+  }
+
+  /**
+   * Lease a Slot
+   * Prefers a free slot that is still connected, then any free slot,
+   * then waits for one to be returned
+   */
+  Slot *acquire(uint32_t wait_ms) {
+    if (!slot[0].lock) {
+      Serial.printf("HTTPS: %s used before https_pool_begin()\n", host);
+      return nullptr;
+    }
+    unsigned long start = millis();
+    while (true) {
+      Slot *free_slot = nullptr;
+      for (uint8_t i = 0; i < slots; i++) {
+        if (xSemaphoreTake(slot[i].lock, 0) != pdTRUE)
+          continue;
+        bool warm = slot[i].client && slot[i].client->connected();
+        if (warm) {
+          if (free_slot)
+            xSemaphoreGive(free_slot->lock);
+          return &slot[i];
+        }
+        if (free_slot)
+          xSemaphoreGive(slot[i].lock);
+        else
+          free_slot = &slot[i];
+      }
+      if (free_slot)
+        return free_slot;
+      if (millis() - start >= wait_ms)
+        return nullptr;
+      vTaskDelay(pdMS_TO_TICKS(5));
+    }
+  }
+
+  void release(Slot *s) {
+    s->last_used = millis();
+    xSemaphoreGive(s->lock);
+  }
+};
+
+// Shared hosts (observations get two slots: worker + settings tile; the
+// station probes have their own, see stationProbe.hpp)
+static HttpsHost g_metobs_host(SMHI_METOBS_HOST, SMHI_HTTPS_PORT, 2);
+static HttpsHost g_metfcst_host(SMHI_METFCST_HOST, SMHI_HTTPS_PORT, 1);
+
+/**
+ * HTTPS Request
+ * Scoped lease of one pooled connection for a single GET
+ *
+ *   HttpsRequest req(g_metobs_host);
+ *   if (req.get(path) == 200) { parse(req.stream()); req.setBodyBytes(n); }
+ *   // destructor returns the connection (kept open if the body was read)
+ */
+class HttpsRequest {
+public:
+  explicit HttpsRequest(HttpsHost &h, uint32_t wait_ms = 30000) : host(h) {
+    slot = host.acquire(wait_ms);
+    if (!slot)
+      Serial.printf("HTTPS: no free connection to %s\n", host.host);
+  }
+
+  ~HttpsRequest() { finish(); }
+
+  HttpsRequest(const HttpsRequest &) = delete;
+  HttpsRequest &operator=(const HttpsRequest &) = delete;
+
+  /**
+   * Send GET
+   * Connects (or reuses the slot's open connection) and reads the headers.
+   * A reused connection that turns out to be dead is retried once fresh.
+   *
+   * @param path Request path starting with '/'
+   * @param timeout_ms Connect and read timeout
+   * @return HTTP status, or a negative HTTPClient error
+   */
+  int get(const String &path, uint32_t timeout_ms = 15000) {
+    if (!slot)
+      return HTTPC_ERROR_CONNECTION_REFUSED;
+    finish_http();
+
+    memset(&timing, 0, sizeof(timing));
+    host.requests++;
+    uri = path;
+
+    if (!slot->client) {
+      slot->client = new WiFiClientSecure();
+      slot->client->setInsecure();
+      slot->http = new HTTPClient();
+      slot->http->setReuse(true);
+    }
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+      timing.reused = slot->client->connected();
+      if (!timing.reused && !open_connection(timeout_ms))
+        break;
+
+      slot->http->setConnectTimeout(timeout_ms);
+      slot->http->setTimeout(timeout_ms);
+      if (!slot->http->begin(*slot->client, host.baseUrl() + path))
+        break;
+      in_flight = true;
+
+      unsigned long sent = millis();
+      code = slot->http->GET();
+      timing.ttfb_ms = millis() - sent;
+      body_start = millis();
+
+      if (code > 0)
+        break;
+
+      // Server closed the kept-alive connection under us: reconnect once
+      finish_http(false);
+      if (!timing.reused)
+        break;
+      Serial.printf("HTTPS: stale connection to %s, reconnecting\n",
+                    host.host);
+    }
+
+    if (timing.reused && code > 0)
+      host.reuses++;
+    if (code <= 0)
+      host.failures++;
+    return code;
+  }
+
+  // Response body stream (valid until finish / destruction)
+  Stream &stream() { return slot->http->getStream(); }
+  // Content-Length, or -1 if unknown
+  int size() { return slot->http->getSize(); }
+  // Report how many body bytes the caller consumed (for timing/logging)
+  void setBodyBytes(size_t n) { timing.bytes = (uint32_t)n; }
+
+  /**
+   * Discard Body
+   * Reads and drops a small body so the connection can be reused for the
+   * next request (status-only probes)
+   */
+  void discardBody() {
+    if (!in_flight)
+      return;
+    int len = size();
+    if (len < 0 || (size_t)len > HTTPS_DRAIN_LIMIT)
+      return; // finish() will close the connection instead
+    Stream &s = stream();
+    unsigned long start = millis();
+    uint8_t buf[256];
+    size_t got = 0;
+    while (got < (size_t)len && millis() - start < 2000) {
+      int avail = s.available();
+      if (avail <= 0) {
+        delay(1);
+        continue;
+      }
+      size_t want = (size_t)len - got;
+      if (want > sizeof(buf))
+        want = sizeof(buf);
+      got += s.readBytes(buf, want);
+    }
+    timing.bytes = (uint32_t)got;
+  }
+
+  /**
+   * Drop Connection
+   * Closes the connection instead of keeping it (aborted or partial reads
+   * would leave unread body bytes in front of the next response)
+   */
+  void abandon() { finish_http(false); }
+
+  /**
+   * Finish Request
+   * Keeps the connection if the whole body was consumed, logs timings
+   * and returns the slot to the host
+   */
+  void finish() {
+    if (!slot)
+      return;
+    finish_http(true);
+    host.release(slot);
+    slot = nullptr;
+  }
+
+  const HttpTiming &lastTiming() const { return timing; }
+
+private:
+  HttpsHost &host;
+  HttpsHost::Slot *slot = nullptr;
+  HttpTiming timing = {};
+  String uri;
+  int code = 0;
+  bool in_flight = false;
+  unsigned long body_start = 0;
+
+  bool open_connection(uint32_t timeout_ms) {
+    slot->client->stop();
+
+    unsigned long t0 = millis();
+    IPAddress ip;
+    if (!WiFi.hostByName(host.host, ip)) {
+      Serial.printf("HTTPS: DNS lookup for %s failed\n", host.host);
+      return false;
+    }
+    timing.dns_ms = millis() - t0;
+
+    // Connect by name so SNI is sent; the lookup above warmed the DNS cache
+    unsigned long t1 = millis();
+    slot->client->setHandshakeTimeout((timeout_ms + 999) / 1000);
+    if (!slot->client->connect(host.host, host.port)) {
+      Serial.printf("HTTPS: connect to %s:%u failed\n", host.host,
+                    (unsigned)host.port);
+      return false;
+    }
+    timing.connect_ms = millis() - t1;
+    host.handshakes++;
+    return true;
+  }
+
+  void finish_http(bool keep = true) {
+    if (!in_flight)
+      return;
+    in_flight = false;
+    timing.body_ms = millis() - body_start;
+
+    // Only keep the connection when nothing of this response is left unread
+    int len = slot->http->getSize();
+    bool drained = len >= 0 && timing.bytes >= (uint32_t)len &&
+                   slot->client->available() == 0;
+    if (!keep || !drained || code <= 0)
+      slot->client->stop();
+    slot->http->end();
+
+    Serial.printf("HTTPS: %s%s -> %d, dns %u ms, connect %u ms%s, "
+                  "ttfb %u ms, body %u ms, %u bytes\n",
+                  host.host, uri.c_str(), code, (unsigned)timing.dns_ms,
+                  (unsigned)timing.connect_ms,
+                  timing.reused ? " (reused)" : "", (unsigned)timing.ttfb_ms,
+                  (unsigned)timing.body_ms, (unsigned)timing.bytes);
+  }
+};
+
+/**
+ * Start Connection Pool
+ * Creates the slot locks of every host (including ones declared in other
+ * headers, such as the probe host). Call once from setup() before any task
+ * that sends requests is started; creating them lazily let two tasks
+ * racing for a fresh host each create a lock and share one connection.
+ *
+ * @return false if a lock could not be created
+ */
+static bool https_pool_begin() {
+  uint8_t count;
+  HttpsHost *const *hosts = HttpsHost::hosts(count);
+  bool ok = true;
+  for (uint8_t i = 0; i < count; i++)
+    ok &= hosts[i]->begin();
+  if (!ok)
+    Serial.println("HTTPS: could not create connection pool locks");
+  return ok;
+}
+
+// Close pooled connections nobody has used for a while (call periodically)
+static void https_pool_close_idle() {
+  uint8_t count;
+  HttpsHost *const *hosts = HttpsHost::hosts(count);
+  for (uint8_t i = 0; i < count; i++)
+    hosts[i]->closeIdle(HTTPS_IDLE_CLOSE_MS);
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <Arduino.h>
+#include <lvgl.h>
+
+#include "weatherIcons.hpp"
+
+/**
+ * Weather Icon Benchmark
+ * Compares the forecast tile's icons composed from objects against the
+ * pre-rasterized atlas: object count, heap/PSRAM and render time.
+ *
+ * Built only with -DWEATHER_ICON_BENCH; runs once after create_ui() and
+ * logs to the serial monitor:
+ *
+ *   IconBench objects: 56 objs, build 1234 us, frame 5678 us, ...
+ *   IconBench atlas:   22 objs, build  456 us, frame 2345 us, ...
+ *
+ * Each pass builds the same FORECAST_CARD_COUNT icon boxes (one per art,
+ * cycling) on a full-screen container above the tiles, renders it a few
+ * times and deletes it again. The atlas pass is run twice: the first one
+ * includes rasterizing the images, the second is the steady state.
+ */
+#ifdef WEATHER_ICON_BENCH
+
+static const int ICON_BENCH_FRAMES = 5;
+static const int ICON_BENCH_SYMBOLS[] = {1, 3, 6, 9, 11, 13, 16};
+
+static uint32_t icon_bench_count_objs(lv_obj_t *obj) {
+  uint32_t n = 1;
+  uint32_t children = lv_obj_get_child_cnt(obj);
+  for (uint32_t i = 0; i < children; i++)
+    n += icon_bench_count_objs(lv_obj_get_child(obj, i));
+  return n;
+}
+
+static void icon_bench_pass(const char *name, bool atlas) {
+  size_t heap0 = ESP.getFreeHeap();
+  size_t psram0 = ESP.getFreePsram();
+
+  lv_obj_t *screen = lv_layer_top();
+  lv_obj_t *row = lv_obj_create(screen);
+  lv_obj_set_size(row, lv_pct(100), lv_pct(100));
+  lv_obj_set_style_bg_color(row, lv_color_hex(0x1A1A1A), 0);
+  lv_obj_set_flex_flow(row, LV_FLEX_FLOW_ROW);
+  lv_obj_set_style_pad_all(row, 4, 0);
+
+  unsigned long t0 = micros();
+  const int n = sizeof(ICON_BENCH_SYMBOLS) / sizeof(ICON_BENCH_SYMBOLS[0]);
+  for (int i = 0; i < n; i++) {
+    // Same icon box as the forecast cards
+    lv_obj_t *icon_cont = lv_obj_create(row);
+    lv_obj_set_size(icon_cont, 100, 100);
+    lv_obj_set_style_bg_opa(icon_cont, LV_OPA_0, 0);
+    lv_obj_set_style_border_width(icon_cont, 0, 0);
+    lv_obj_clear_flag(icon_cont, LV_OBJ_FLAG_SCROLLABLE);
+    if (atlas)
+      draw_weather_icon(icon_cont, ICON_BENCH_SYMBOLS[i], 90);
+    else
+      draw_weather_icon_objects(icon_cont, ICON_BENCH_SYMBOLS[i], 90);
+  }
+  lv_obj_update_layout(row);
+  unsigned long build_us = micros() - t0;
+
+  unsigned long frame_us = 0;
+  for (int f = 0; f < ICON_BENCH_FRAMES; f++) {
+    lv_obj_invalidate(row);
+    t0 = micros();
+    lv_refr_now(NULL);
+    frame_us += micros() - t0;
+  }
+  frame_us /= ICON_BENCH_FRAMES;
+
+  Serial.printf("IconBench %s: %u objs, build %lu us, frame %lu us, "
+                "heap -%d B, psram -%d B\n",
+                name, (unsigned)(icon_bench_count_objs(row) - 1), build_us,
+                frame_us, (int)(heap0 - ESP.getFreeHeap()),
+                (int)(psram0 - ESP.getFreePsram()));
+  lv_obj_del(row);
+}
+
+static void weather_icon_bench() {
+  icon_bench_pass("objects", false);
+  icon_bench_pass("atlas (first)", true);
+  icon_bench_pass("atlas", true);
+
+  WeatherIconAtlas *atlas = weather_icon_atlas(90);
+  Serial.printf("IconBench atlas images: %u B\n",
+                (unsigned)(atlas ? atlas->memoryBytes() : 0));
+  lv_obj_invalidate(lv_scr_act());
+}
+
+#endif
@@ -0,0 +1,483 @@
+#pragma once
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * JSON Pull Parser
+ * Single-pass tokenizer that reads JSON straight off an Arduino Stream
+ *
+ * The HTTP body is pulled in fixed-size chunks and handed out one token at
+ * a time (object/array boundaries, keys and scalar values). No document is
+ * ever built: scalar text lands in a small scratch buffer that is reused for
+ * every token, so RAM use is constant no matter how large the response is.
+ *
+ * Typical use:
+ *   JsonPullParser json(stream);
+ *   while ((tok = json.next()) == JsonPullParser::TOKEN_KEY) {
+ *     if (json.textEquals("value")) { ...read value token... }
+ *     else json.skipValue();
+ *   }
+ */
+class JsonPullParser {
+public:
+  // Polled while waiting for data; returning true stops the parse
+  typedef bool (*AbortFn)(void *ctx);
+
+  enum Token : uint8_t {
+    TOKEN_ERROR = 0,    // Malformed input, timeout or aborted
+    TOKEN_END,          // Stream finished cleanly at depth 0
+    TOKEN_BEGIN_OBJECT, // {
+    TOKEN_END_OBJECT,   // }
+    TOKEN_BEGIN_ARRAY,  // [
+    TOKEN_END_ARRAY,    // ]
+    TOKEN_KEY,          // "name" in key position, text() holds the name
+    TOKEN_STRING,       // "text" in value position, text() holds the text
+    TOKEN_NUMBER,       // Number literal, text() holds its characters
+    TOKEN_TRUE,
+    TOKEN_FALSE,
+    TOKEN_NULL
+  };
+
+  static const size_t CHUNK_SIZE = 512; // Bytes pulled from the stream at once
+  static const size_t TEXT_SIZE = 64;   // Longest key/scalar kept (truncated)
+  static const uint8_t MAX_DEPTH = 32;  // Nesting limit (bitmask stack)
+
+  /**
+   * @param s Source stream (usually HTTPClient::getStream())
+   * @param idle_timeout_ms Give up when no byte arrives for this long
+   */
+  explicit JsonPullParser(Stream &s, uint32_t idle_timeout_ms = 10000)
+      : stream(s), timeout_ms(idle_timeout_ms) {
+    text_buf[0] = '\0';
+  }
+
+  /**
+   * Set Abort Check
+   * fn(ctx) is polled before every chunk refill; once it returns true the
+   * parser fails with TOKEN_ERROR (used to cancel a superseded fetch)
+   */
+  void setAbortCheck(AbortFn fn, void *ctx) {
+    abort_fn = fn;
+    abort_ctx = ctx;
+  }
+
+  /**
+   * Read Next Token
+   * Whitespace, ':' and ',' are consumed silently. A string is reported as
+   * TOKEN_KEY when it sits in key position inside an object.
+   */
+  Token next() {
+    while (true) {
+      int c = get_char();
+      if (c < 0)
+        return (depth_ == 0 && !failed) ? TOKEN_END : fail();
+
+      switch (c) {
+      case ' ':
+      case '\t':
+      case '\r':
+      case '\n':
+      case ':':
+        continue;
+      case ',':
+        if (in_object())
+          expect_key = true;
+        continue;
+      case '{':
+        if (!push(true))
+          return fail();
+        expect_key = true;
+        return TOKEN_BEGIN_OBJECT;
+      case '}':
+        if (!pop(true))
+          return fail();
+        expect_key = false;
+        return TOKEN_END_OBJECT;
+      case '[':
+        if (!push(false))
+          return fail();
+        expect_key = false;
+        return TOKEN_BEGIN_ARRAY;
+      case ']':
+        if (!pop(false))
+          return fail();
+        expect_key = false;
+        return TOKEN_END_ARRAY;
+      case '"':
+        if (!read_string())
+          return fail();
+        if (in_object() && expect_key) {
+          expect_key = false;
+          return TOKEN_KEY;
+        }
+        return TOKEN_STRING;
+      case 't':
+        return read_literal("rue", "true") ? TOKEN_TRUE : fail();
+      case 'f':
+        return read_literal("alse", "false") ? TOKEN_FALSE : fail();
+      case 'n':
+        return read_literal("ull", "null") ? TOKEN_NULL : fail();
+      default:
+        if (c == '-' || (c >= '0' && c <= '9')) {
+          read_number((char)c);
+          return TOKEN_NUMBER;
+        }
+        return fail();
+      }
+    }
+  }
+
+  /**
+   * Skip Value
+   * Consumes the next value completely (scalar, object or array)
+   * Call right after TOKEN_KEY to ignore a field you don't care about
+   *
+   * @return false on malformed input or timeout
+   */
+  bool skipValue() {
+    Token t = next();
+    if (t == TOKEN_BEGIN_OBJECT || t == TOKEN_BEGIN_ARRAY)
+      return skipContainer();
+    return t != TOKEN_ERROR && t != TOKEN_END && t != TOKEN_END_OBJECT &&
+           t != TOKEN_END_ARRAY;
+  }
+
+  /**
+   * Skip Container
+   * Consumes everything up to and including the close of the object/array
+   * whose opening token was just returned
+   */
+  bool skipContainer() {
+    if (depth_ == 0)
+      return false;
+    uint8_t target = depth_ - 1;
+    while (depth_ > target) {
+      Token t = next();
+      if (t == TOKEN_ERROR || t == TOKEN_END)
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * Find Key
+   * Advances until a key with the given name is seen at the given depth
+   * (1 = top-level object). The values of other keys at that depth are
+   * skipped raw: their bytes are scanned for brackets and quotes only, so
+   * nothing inside them is copied into text() or checked for syntax.
+   *
+   * @return true when positioned right after the key
+   */
+  bool findKey(const char *key, uint8_t at_depth) {
+    while (true) {
+      Token t = next();
+      if (t == TOKEN_ERROR || t == TOKEN_END)
+        return false;
+      if (t == TOKEN_KEY && depth_ == at_depth) {
+        if (textEquals(key))
+          return true;
+        if (!skip_raw())
+          return false;
+        continue;
+      }
+      if (depth_ < at_depth && (t == TOKEN_END_OBJECT || t == TOKEN_END_ARRAY))
+        return false;
+    }
+  }
+
+  /**
+   * Finish Document
+   * Consumes whatever is left of the top-level value, so the connection
+   * holds no unread body bytes and can be reused
+   *
+   * @return true if the document was closed cleanly
+   */
+  bool finish() {
+    while (depth_ > 0) {
+      Token t = next();
+      if (t == TOKEN_ERROR || t == TOKEN_END)
+        return false;
+    }
+    return !failed;
+  }
+
+  // Text of the last key/string/number token (NUL terminated, maybe cut)
+  const char *text() const { return text_buf; }
+  size_t textLength() const { return text_len; }
+  bool textTruncated() const { return text_cut; }
+  bool textEquals(const char *s) const { return strcmp(text_buf, s) == 0; }
+  float textAsFloat() const { return strtof(text_buf, nullptr); }
+  int64_t textAsInt64() const { return strtoll(text_buf, nullptr, 10); }
+
+  // Current nesting depth (0 = outside the top-level value)
+  uint8_t depth() const { return depth_; }
+  // Total bytes pulled from the stream so far
+  size_t bytesRead() const { return total_read; }
+  // True once a timeout or syntax error has been hit
+  bool failedState() const { return failed; }
+  // True if the parse was stopped by the abort check
+  bool wasAborted() const { return aborted; }
+
+private:
+  Stream &stream;
+  uint32_t timeout_ms;
+  AbortFn abort_fn = nullptr;
+  void *abort_ctx = nullptr;
+  bool aborted = false;
+
+  char chunk[CHUNK_SIZE];
+  size_t chunk_len = 0;
+  size_t chunk_pos = 0;
+  size_t total_read = 0;
+
+  char text_buf[TEXT_SIZE];
+  size_t text_len = 0;
+  bool text_cut = false;
+
+  uint32_t object_bits = 0; // Bit n set = level n+1 is an object
+  uint8_t depth_ = 0;
+  bool expect_key = false;
+  bool failed = false;
+
+  Token fail() {
+    failed = true;
+    return TOKEN_ERROR;
+  }
+
+  bool in_object() const {
+    return depth_ > 0 && (object_bits & (1UL << (depth_ - 1)));
+  }
+
+  bool push(bool is_object) {
+    if (depth_ >= MAX_DEPTH)
+      return false;
+    if (is_object)
+      object_bits |= (1UL << depth_);
+    else
+      object_bits &= ~(1UL << depth_);
+    depth_++;
+    return true;
+  }
+
+  bool pop(bool is_object) {
+    if (depth_ == 0 || in_object() != is_object)
+      return false;
+    depth_--;
+    return true;
+  }
+
+  /**
+   * Refill Chunk Buffer
+   * Pulls whatever is already available (up to CHUNK_SIZE) in one call,
+   * waiting at most timeout_ms for the next byte to arrive
+   */
+  bool fill() {
+    if (failed)
+      return false;
+    unsigned long start = millis();
+    while (true) {
+      if (abort_fn && abort_fn(abort_ctx)) {
+        aborted = failed = true;
+        return false;
+      }
+      int avail = stream.available();
+      if (avail > 0) {
+        size_t want = (size_t)avail < CHUNK_SIZE ? (size_t)avail : CHUNK_SIZE;
+        size_t n = stream.readBytes(chunk, want);
+        if (n > 0) {
+          chunk_len = n;
+          chunk_pos = 0;
+          total_read += n;
+          return true;
+        }
+      }
+      if (millis() - start >= timeout_ms)
+        return false;
+      delay(1);
+    }
+  }
+
+  int peek_char() {
+    if (chunk_pos >= chunk_len && !fill())
+      return -1;
+    return (unsigned char)chunk[chunk_pos];
+  }
+
+  int get_char() {
+    if (chunk_pos >= chunk_len && !fill())
+      return -1;
+    return (unsigned char)chunk[chunk_pos++];
+  }
+
+  void text_reset() {
+    text_len = 0;
+    text_cut = false;
+    text_buf[0] = '\0';
+  }
+
+  void text_put(char c) {
+    if (text_len < TEXT_SIZE - 1) {
+      text_buf[text_len++] = c;
+      text_buf[text_len] = '\0';
+    } else {
+      text_cut = true;
+    }
+  }
+
+  static int hex_value(int c) {
+    if (c >= '0' && c <= '9')
+      return c - '0';
+    if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+    return -1;
+  }
+
+  // Encode a \uXXXX escape as UTF-8 (BMP only, surrogates kept as-is)
+  void text_put_codepoint(uint32_t cp) {
+    if (cp < 0x80) {
+      text_put((char)cp);
+    } else if (cp < 0x800) {
+      text_put((char)(0xC0 | (cp >> 6)));
+      text_put((char)(0x80 | (cp & 0x3F)));
+    } else {
+      text_put((char)(0xE0 | (cp >> 12)));
+      text_put((char)(0x80 | ((cp >> 6) & 0x3F)));
+      text_put((char)(0x80 | (cp & 0x3F)));
+    }
+  }
+
+  bool read_string() {
+    text_reset();
+    while (true) {
+      int c = get_char();
+      if (c < 0)
+        return false;
+      if (c == '"')
+        return true;
+      if (c != '\\') {
+        text_put((char)c);
+        continue;
+      }
+      int e = get_char();
+      switch (e) {
+      case 'n':
+        text_put('\n');
+        break;
+      case 't':
+        text_put('\t');
+        break;
+      case 'r':
+        text_put('\r');
+        break;
+      case 'b':
+        text_put('\b');
+        break;
+      case 'f':
+        text_put('\f');
+        break;
+      case 'u': {
+        uint32_t cp = 0;
+        for (int i = 0; i < 4; i++) {
+          int h = hex_value(get_char());
+          if (h < 0)
+            return false;
+          cp = (cp << 4) | (uint32_t)h;
+        }
+        text_put_codepoint(cp);
+        break;
+      }
+      case -1:
+        return false;
+      default: // \" \\ \/
+        text_put((char)e);
+        break;
+      }
+    }
+  }
+
+  void read_number(char first) {
+    text_reset();
+    text_put(first);
+    while (true) {
+      int c = peek_char();
+      if (!((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' ||
+            c == '+' || c == '-'))
+        return;
+      text_put((char)c);
+      chunk_pos++;
+    }
+  }
+
+  /**
+   * Skip Value Raw
+   * Consumes the value after a key without tokenizing it: only quotes,
+   * escapes and bracket nesting are tracked. Depth and key state are left
+   * as they were, as the value opens and closes at the current level.
+   */
+  bool skip_raw() {
+    uint16_t nest = 0;
+    while (true) {
+      int c = get_char();
+      if (c < 0) {
+        failed = true;
+        return false;
+      }
+      switch (c) {
+      case ' ':
+      case '\t':
+      case '\r':
+      case '\n':
+      case ':':
+      case ',':
+        break;
+      case '"':
+        while ((c = get_char()) != '"') {
+          if (c == '\\')
+            c = get_char();
+          if (c < 0) {
+            failed = true;
+            return false;
+          }
+        }
+        if (nest == 0)
+          return true;
+        break;
+      case '{':
+      case '[':
+        nest++;
+        break;
+      case '}':
+      case ']':
+        if (nest == 0) { // Key without a value
+          failed = true;
+          return false;
+        }
+        if (--nest == 0)
+          return true;
+        break;
+      default:
+        if (nest > 0)
+          break;
+        // Scalar at the key's level: runs up to the next delimiter
+        while ((c = peek_char()) >= 0 && c != ',' && c != '}' && c != ']' &&
+               c != ' ' && c != '\t' && c != '\r' && c != '\n')
+          chunk_pos++;
+        return true;
+      }
+    }
+  }
+
+  bool read_literal(const char *rest, const char *word) {
+    for (const char *p = rest; *p; ++p) {
+      if (get_char() != *p)
+        return false;
+    }
+    text_reset();
+    for (const char *p = word; *p; ++p)
+      text_put(*p);
+    return true;
+  }
+};
@@ -0,0 +1,401 @@
+#pragma once
+#include <Arduino.h>
+#include <Preferences.h>
+#include <algorithm>
+#include <atomic>
+#include <time.h>
+#include <vector>
+
+#include "httpsPool.hpp"
+#include "jsonPull.hpp"
+#include "stationTable.hpp"
+
+// Build-time table written by tools/gen_stations.py next to stations.hpp
+#if __has_include("stationParams.hpp")
+#include "stationParams.hpp"
+#define HAVE_STATION_PARAMS 1
+#else
+#define HAVE_STATION_PARAMS 0
+#endif
+
+// Global station list defined in project.ino
+extern StationTable gStations;
+
+// Delay before a seeded index is checked against the live metadata
+// (the simulator's station_params build shortens it)
+#ifndef PARAM_INDEX_VERIFY_DELAY_MS
+#define PARAM_INDEX_VERIFY_DELAY_MS 60000
+#endif
+
+// Minimum time between two live checks of the table, counted from the last
+// check or from when the table was generated (the simulator sets 0)
+#ifndef PARAM_INDEX_VERIFY_INTERVAL_S
+#define PARAM_INDEX_VERIFY_INTERVAL_S 86400
+#endif
+
+// NVS namespace holding the time of the last live check
+static const char *PARAM_INDEX_PREFS = "param_index";
+
+/**
+ * Parameter Index
+ * Station -> available-parameter bitmap built from SMHI station metadata
+ *
+ * Instead of probing /parameter/{p}/station/{id}/ for every parameter of
+ * every station the user picks, each parameter's station list
+ * (/parameter/{p}.json) is streamed once over the pooled connection and
+ * every station marked "active" gets that parameter's bit. Afterwards
+ * "which parameters does station X have" is one array read with no
+ * requests at all.
+ *
+ * SMHI has no single document covering all parameters, so the build is one
+ * request per parameter code on the fetch worker. It gives way to the
+ * user's downloads: between parameters, and while one is streaming, it
+ * pauses as soon as another request is waiting and resumes from that
+ * parameter once the worker is idle again.
+ *
+ * When the generated stationParams.hpp table is present the index is
+ * seeded from flash at boot (no requests at all) and the live build only
+ * runs later in the background to verify it, at most once per
+ * PARAM_INDEX_VERIFY_INTERVAL_S (see verifyDue()).
+ *
+ * Bit n of a station's mask corresponds to codes[n] passed to
+ * build()/seedFromTable(). The masks are read on the LVGL thread only;
+ * a finished live build is handed over by poll().
+ */
+class ParamIndex {
+public:
+  static const int MAX_PARAMS = 64;
+
+  enum BuildStatus : uint8_t {
+    BUILD_DONE = 0, // Every parameter list read
+    BUILD_FAILED,   // A list could not be read, live index disabled
+    BUILD_PAUSED    // Gave way to other requests, call build() to resume
+  };
+
+  /**
+   * Seed From Generated Table
+   * Fills the index from the flash-resident STATION_PARAMS table, remapping
+   * its parameter order to codes[]. LVGL thread, after gStations is loaded.
+   *
+   * @return false if there is no table or it doesn't match gStations
+   */
+  bool seedFromTable(const int *codes, int count) {
+#if HAVE_STATION_PARAMS
+    if (count > MAX_PARAMS || gStations.size() != STATION_COUNT)
+      return false;
+
+    // Table bit for each of our codes (-1 = not in the table)
+    int8_t table_bit[MAX_PARAMS];
+    for (int n = 0; n < count; n++) {
+      table_bit[n] = -1;
+      for (size_t t = 0; t < STATION_PARAM_CODE_COUNT; t++) {
+        if (STATION_PARAM_CODES[t] == codes[n])
+          table_bit[n] = (int8_t)t;
+      }
+    }
+
+    bits.assign(STATION_COUNT, 0);
+    for (size_t i = 0; i < STATION_COUNT; i++) {
+      uint64_t src = STATION_PARAMS[i].mask;
+      uint64_t m = 0;
+      for (int n = 0; n < count; n++) {
+        if (table_bit[n] >= 0 && ((src >> table_bit[n]) & 1))
+          m |= (uint64_t)1 << n;
+      }
+      bits[i] = m;
+    }
+    code_count = count;
+    ready_ = true;
+    from_table = true;
+    Serial.printf("ParamIndex: seeded %u stations from build-time table\n",
+                  (unsigned)STATION_COUNT);
+    return true;
+#else
+    (void)codes;
+    (void)count;
+    return false;
+#endif
+  }
+
+  /**
+   * Build Index From Live Metadata
+   * Blocking (network), run on the fetch worker. gStations must be loaded.
+   * The result is published by the next poll() on the LVGL thread.
+   *
+   * yield(ctx) is checked before each parameter and while its list
+   * streams. Once it returns true the build stops with BUILD_PAUSED; the
+   * next call picks up at the parameter that was cut short.
+   *
+   * @param codes Parameter codes, bit n = codes[n]
+   * @param count Number of codes (at most MAX_PARAMS)
+   */
+  BuildStatus build(const int *codes, int count,
+                    JsonPullParser::AbortFn yield = nullptr,
+                    void *ctx = nullptr) {
+    if (live_done_.load())
+      return BUILD_DONE;
+    if (count > MAX_PARAMS || gStations.empty())
+      return BUILD_FAILED;
+
+    if (next_param == 0) {
+      live_start = millis();
+      live_bytes = 0;
+      live.assign(gStations.size(), 0);
+    }
+
+    for (; next_param < count; next_param++) {
+      int i = next_param;
+      if (yield && yield(ctx))
+        return build_paused(codes[i]);
+
+      size_t bytes = 0;
+      uint64_t bit = (uint64_t)1 << i;
+      // One retry per parameter (a dropped keep-alive link, a 5xx)
+      bool ok = read_parameter(codes[i], bit, bytes, yield, ctx);
+      if (!ok && !(yield && yield(ctx)))
+        ok = read_parameter(codes[i], bit, bytes, yield, ctx);
+      if (!ok && yield && yield(ctx))
+        return build_paused(codes[i]); // Partial bits are a subset, kept
+      if (!ok) {
+        Serial.printf("ParamIndex: parameter %d failed, live index "
+                      "disabled\n",
+                      codes[i]);
+        live.clear();
+        next_param = 0;
+        failed_.store(true);
+        return BUILD_FAILED;
+      }
+      live_bytes += bytes;
+    }
+
+    next_param = 0;
+    live_count = count;
+    live_done_.store(true, std::memory_order_release);
+    Serial.printf("ParamIndex: %d parameters x %u stations in %lu ms, "
+                  "%u bytes\n",
+                  count, (unsigned)live.size(), millis() - live_start,
+                  (unsigned)live_bytes);
+    return BUILD_DONE;
+  }
+
+  /**
+   * Live Check Due
+   * True when a seeded table should be checked against the live metadata:
+   * PARAM_INDEX_VERIFY_INTERVAL_S have passed since the last check (kept
+   * in NVS) and since the table was generated. Without a wall clock the
+   * check waits for a later boot.
+   */
+  bool verifyDue(time_t now) const {
+#if HAVE_STATION_PARAMS
+    if (!from_table || now < STATION_PARAMS_GENERATED)
+      return false; // Clock not set yet
+    int32_t last = STATION_PARAMS_GENERATED;
+    Preferences prefs;
+    if (prefs.begin(PARAM_INDEX_PREFS, true)) {
+      last = std::max(last, prefs.getInt("verified", 0));
+      prefs.end();
+    }
+    return now - last >= PARAM_INDEX_VERIFY_INTERVAL_S;
+#else
+    (void)now;
+    return false;
+#endif
+  }
+
+  /**
+   * Skip Live Build
+   * For when there is no worker task to run build() on: marks the live
+   * index unavailable without a request. A seeded table stays in use;
+   * without one callers probe stations instead.
+   */
+  void skipLive() {
+    Serial.println("ParamIndex: no fetch worker, live index skipped");
+    failed_.store(true);
+  }
+
+  /**
+   * Publish Live Build
+   * LVGL thread: swaps in a finished live build, logging how many stations
+   * disagree with the table it replaces
+   *
+   * @return true if the masks were replaced
+   */
+  bool poll() {
+    if (published || !live_done_.load(std::memory_order_acquire))
+      return false;
+    published = true;
+
+    if (from_table) {
+      size_t changed = 0;
+      for (size_t i = 0; i < bits.size() && i < live.size(); i++)
+        changed += bits[i] != live[i];
+      Serial.printf("ParamIndex: live metadata differs from table for %u "
+                    "stations\n",
+                    (unsigned)changed);
+      record_verified(time(nullptr));
+    }
+    bits.swap(live);
+    live.clear();
+    live.shrink_to_fit();
+    code_count = live_count;
+    ready_ = true;
+    from_table = false;
+    return true;
+  }
+
+  // True once masks are available (LVGL thread)
+  bool ready() const { return ready_; }
+  // True if the live build gave up with nothing to fall back on; callers
+  // then probe stations one by one
+  bool failed() const { return !ready_ && failed_.load(); }
+  // True while the masks come from the build-time table
+  bool fromTable() const { return from_table; }
+
+  // Mask of available parameters for a gStations index (0 if unknown)
+  uint64_t mask(int station_idx) const {
+    if (!ready_ || station_idx < 0 || station_idx >= (int)bits.size())
+      return 0;
+    return bits[(size_t)station_idx];
+  }
+
+  // True if station has the parameter at position code_pos of codes[]
+  bool has(int station_idx, int code_pos) const {
+    return (mask(station_idx) >> code_pos) & 1;
+  }
+
+  /**
+   * Active Date Range
+   * First and last observation of any parameter (epoch seconds), from
+   * the build-time table
+   *
+   * @return false without a table
+   */
+  bool activeRange(int station_idx, int32_t &from, int32_t &to) const {
+#if HAVE_STATION_PARAMS
+    if (station_idx < 0 || station_idx >= (int)STATION_COUNT ||
+        gStations.size() != STATION_COUNT)
+      return false;
+    from = STATION_PARAMS[station_idx].from;
+    to = STATION_PARAMS[station_idx].to;
+    return true;
+#else
+    (void)station_idx;
+    (void)from;
+    (void)to;
+    return false;
+#endif
+  }
+
+  int codeCount() const { return code_count; }
+
+private:
+  std::vector<uint64_t> bits;     // Per gStations index (LVGL thread)
+  std::vector<uint64_t> live;     // Live build (fetch worker)
+  int code_count = 0;
+  int live_count = 0;
+  int next_param = 0;             // Where a paused build resumes
+  unsigned long live_start = 0;   // millis() when the build started
+  size_t live_bytes = 0;
+  bool ready_ = false;
+  bool from_table = false;
+  bool published = false;
+  std::atomic<bool> live_done_{false};
+  std::atomic<bool> failed_{false};
+
+  static BuildStatus build_paused(int code) {
+    Serial.printf("ParamIndex: paused at parameter %d for other requests\n",
+                  code);
+    return BUILD_PAUSED;
+  }
+
+  // Remember a finished live check of the table (LVGL thread)
+  static void record_verified(time_t now) {
+#if HAVE_STATION_PARAMS
+    if (now < STATION_PARAMS_GENERATED)
+      return;
+    Preferences prefs;
+    if (prefs.begin(PARAM_INDEX_PREFS, false)) {
+      prefs.putInt("verified", (int32_t)now);
+      prefs.end();
+    }
+#else
+    (void)now;
+#endif
+  }
+
+  // Metadata ids are numbers; look them up in the generated id table
+  static int find_station(int32_t id) {
+    char key[12];
+    snprintf(key, sizeof(key), "%ld", (long)id);
+    return gStations.indexOf(key);
+  }
+
+  /**
+   * Read One Parameter's Station List
+   * Streams {"station":[{"key":"65090","active":true,...},...]} and sets
+   * bit for every active station we know; abort(ctx) cuts it short
+   */
+  bool read_parameter(int code, uint64_t bit, size_t &bytes,
+                      JsonPullParser::AbortFn abort, void *ctx) {
+    String path = "/api/version/1.0/parameter/";
+    path += String(code);
+    path += ".json";
+
+    HttpsRequest req(g_metobs_host);
+    int status = req.get(path, 15000);
+    if (status != 200) {
+      req.discardBody();
+      return false;
+    }
+
+    JsonPullParser json(req.stream());
+    json.setAbortCheck(abort, ctx);
+    if (!json.findKey("station", 1) ||
+        json.next() != JsonPullParser::TOKEN_BEGIN_ARRAY) {
+      req.abandon();
+      return false;
+    }
+
+    int active = 0;
+    JsonPullParser::Token tok;
+    while ((tok = json.next()) == JsonPullParser::TOKEN_BEGIN_OBJECT) {
+      int32_t id = -1;
+      bool is_active = false;
+      while ((tok = json.next()) == JsonPullParser::TOKEN_KEY) {
+        if (json.textEquals("key") || json.textEquals("id")) {
+          tok = json.next();
+          if (tok == JsonPullParser::TOKEN_STRING ||
+              tok == JsonPullParser::TOKEN_NUMBER)
+            id = (int32_t)json.textAsInt64();
+        } else if (json.textEquals("active")) {
+          is_active = json.next() == JsonPullParser::TOKEN_TRUE;
+        } else if (!json.skipValue()) {
+          break;
+        }
+      }
+      if (tok != JsonPullParser::TOKEN_END_OBJECT)
+        break;
+
+      int idx = is_active ? find_station(id) : -1;
+      if (idx >= 0) {
+        live[(size_t)idx] |= bit;
+        active++;
+      }
+    }
+
+    bool ok = tok == JsonPullParser::TOKEN_END_ARRAY && json.finish();
+    bytes = json.bytesRead();
+    req.setBodyBytes(bytes);
+    if (!ok) {
+      req.abandon();
+      return false;
+    }
+    Serial.printf("ParamIndex: parameter %d has %d active stations\n", code,
+                  active);
+    return true;
+  }
+};
+
+// Global instance (seeded or built by the fetch worker, read by the
+// settings tile)
+static ParamIndex g_param_index;
@@ -14,6 +14,12 @@
 #include "time.h"
 
 #include "7dayForecast.hpp"
+#include "bootTimeline.hpp"
+#include "chartDecimate.hpp"
+#include "chartRenderer.hpp"
+#include "fetchWorker.hpp"
+#include "frameProfiler.hpp"
+#include "iconBench.hpp"
 #include "settingsTile.hpp"
 #include "smhiApi.hpp"
 #include "stationPicker.hpp"
@@ -36,15 +42,15 @@ const int daylightOffset_sec = 3600; // +1 hour for daylight saving time
 // --------------------------------------------------------------------
 LilyGo_Class amoled; // AMOLED display driver instance
 // SMHI API wrapper for fetching meteorological observation data
-SMHI_API weather("https://opendata-download-metobs.smhi.se/api/version/1.0/parameter/");
+SMHI_API weather("/api/version/1.0/parameter/");
 
 // UI tile objects (used across multiple files)
 lv_obj_t *t4 = NULL; // Settings tile
 lv_obj_t *t2 = NULL; // 7-day forecast tile
 
 // Global data storage
-std::vector<StationInfo> gStations; // All available SMHI weather stations
-std::vector<DataPoint> weatherData; // Current weather data points for graphing
+StationTable gStations; // All available SMHI weather stations (in flash)
+SeriesStore weatherData; // Current weather data points for graphing
 
 // --------------------------------------------------------------------
 // UI State Variables
@@ -56,12 +62,16 @@ static lv_obj_t *chart =
     NULL; // Line chart object for weather data visualization
 static lv_chart_series_t *series = NULL; // Data series for the chart
 static lv_obj_t *slider = NULL; // Slider for scrolling through historical data
+static lv_obj_t *zoom_label = NULL; // Current zoom level on the zoom button
+static lv_obj_t *chart_status = NULL; // Message over the plot (loading, no data)
 
 // Application state flags
 static bool wifi_connected = false;  // True when WiFi connection is established
 static bool stations_loaded = false; // True when station list has been loaded
 static bool initial_data_fetched =
     false; // True when first weather data fetch is complete
+static bool series_failed = false; // Last series download came back empty
+static bool fetch_loading = false; // Fetch worker busy, as last shown
 
 // Chart windowing and scaling variables
 static int g_window_start =
@@ -69,6 +79,14 @@ static int g_window_start =
 static int g_window_size = 0; // Number of data points to display in window
 static int g_y_min = -10;     // Minimum Y-axis value (temperature)
 static int g_y_max = 20;      // Maximum Y-axis value (temperature)
+static int g_zoom_level = 0;  // Index into CHART_ZOOM_LEVELS
+static ChartDecimator g_chart_lod; // Vertices actually drawn for the window
+static SeriesPyramid g_chart_pyramid; // Aggregates + range index of weatherData
+static ChartRenderer g_chart_renderer; // Projected vertices of g_chart_lod
+
+// Pixels per min/max bucket: two vertices per bucket is about one point
+// per horizontal pixel
+static const int CHART_PX_PER_BUCKET = 2;
 
 // --------------------------------------------------------------------
 // Graph Margins
@@ -89,6 +107,7 @@ static void create_ui();
 static void setup_weather_screen();
 static void chart_draw_event_cb(lv_event_t *e);
 static void update_chart_from_slider(lv_event_t *e);
+static void update_chart_status();
 static int calculate_margin_for_range(int y_min, int y_max);
 
 // --------------------------------------------------------------------
@@ -120,33 +139,6 @@ static void connect_wifi_non_blocking() {
   }
 }
 
-/**
- * Convert date string to display format
- * Handles both daily (YYYY-MM-DD) and monthly (YYYY-MM) formats
- * Returns a human-readable date string for X-axis labels
- */
-static const char *get_day_name(const String &date_str) {
-  static char day_buf[12];
-
-  // YYYY-MM-DD format (10+ chars) -> show MM/DD
-  if (date_str.length() >= 10) {
-    int day = date_str.substring(8, 10).toInt();
-    int month = date_str.substring(5, 7).toInt();
-    snprintf(day_buf, sizeof(day_buf), "%02d/%02d", month, day);
-    return day_buf;
-  }
-
-  // YYYY-MM format (7 chars) -> show month name or MM/YYYY
-  if (date_str.length() >= 7) {
-    int month = date_str.substring(5, 7).toInt();
-    int year = date_str.substring(2, 4).toInt();
-    snprintf(day_buf, sizeof(day_buf), "%02d/%02d", month, year);
-    return day_buf;
-  }
-
-  return "";
-}
-
 // --------------------------------------------------------------------
 // Dynamic Margin Calculation
 // Calculate left margin based on Y-axis value range
@@ -168,6 +160,18 @@ static int calculate_margin_for_range(int y_min, int y_max) {
   return max(32, digits * 9 + 20);
 }
 
+// --------------------------------------------------------------------
+// Chart Vertex Value
+// Value drawn at vertex i: the raw point, or the bucket mean in the
+// aggregated (daily/weekly) views
+// --------------------------------------------------------------------
+static float chart_vertex_value(size_t i) {
+  int level = g_chart_lod.aggregateLevel();
+  if (level >= 0)
+    return g_chart_pyramid.bucket((SeriesPyramid::Level)level, i).mean();
+  return weatherData.value(g_chart_lod.index(i));
+}
+
 // --------------------------------------------------------------------
 // Chart Drawing Event Callback
 // Handles custom drawing for the weather chart including:
@@ -274,15 +278,10 @@ static void chart_draw_event_cb(lv_event_t *e) {
       if (data_idx < 0 || data_idx >= (int)weatherData.size())
         return;
 
-      const String &date_str = weatherData[data_idx].date;
-      const char *day_label = get_day_name(date_str);
-
-      if (day_label && strlen(day_label) > 0) {
-        lv_snprintf(dsc->text, dsc->text_length, "%s", day_label);
-      } else {
-        const char *hhmm = weatherData[data_idx].time.c_str();
-        lv_snprintf(dsc->text, dsc->text_length, "%s", hhmm);
-      }
+      // Only the handful of visible ticks are ever formatted:
+      // MM/DD for hourly/daily data, MM/YY for monthly data
+      weatherData.formatTickLabel((size_t)data_idx, dsc->text,
+                                  dsc->text_length);
       return;
     }
   }
@@ -304,75 +303,12 @@ static void chart_draw_event_cb(lv_event_t *e) {
     int graphHeight =
         lv_obj_get_height(obj) - GRAPH_MARGIN_TOP - GRAPH_MARGIN_BOTTOM;
 
-    lv_draw_line_dsc_t line_dsc;
-    lv_draw_line_dsc_init(&line_dsc);
-    line_dsc.width = 3;
-    line_dsc.color = lv_palette_main(LV_PALETTE_BLUE);
-    line_dsc.opa = LV_OPA_COVER;
-    line_dsc.round_start = 1;
-    line_dsc.round_end = 1;
-
-    lv_draw_rect_dsc_t point_dsc;
-    lv_draw_rect_dsc_init(&point_dsc);
-    point_dsc.bg_color = lv_color_white();
-    point_dsc.border_color = lv_palette_main(LV_PALETTE_BLUE);
-    point_dsc.border_width = 2;
-    point_dsc.radius = LV_RADIUS_CIRCLE;
-
-    // Calculate Y-axis range for scaling data points
-    int y_range = g_y_max - g_y_min;
-    if (y_range <= 0)
-      y_range = 1;
-
-    lv_point_t p1;
-    bool has_p1 = false;
-
-    // Draw lines connecting data points
-    for (int i = 0; i < g_window_size; i++) {
-      int data_idx = g_window_start + i;
-      if (data_idx >= (int)weatherData.size())
-        break;
-
-      float val = weatherData[data_idx].temp;
-
-      // Calculate position within graph bounds
-      int x_offset = (i * (graphWidth - 1)) / (g_window_size - 1);
-      // Invert Y (higher temps at top) and scale to graph height
-      int y_offset =
-          (int)((1.0f - (val - g_y_min) / (float)y_range) * (graphHeight - 1));
-
-      lv_point_t p2;
-      p2.x = graphX + x_offset;
-      p2.y = graphY + y_offset;
-
-      if (has_p1) {
-        lv_draw_line(draw_ctx, &line_dsc, &p1, &p2);
-      }
-
-      p1 = p2;
-      has_p1 = true;
-    }
-
-    // Draw circular markers at each data point
-    for (int i = 0; i < g_window_size; i++) {
-      int data_idx = g_window_start + i;
-      if (data_idx >= (int)weatherData.size())
-        break;
-
-      float val = weatherData[data_idx].temp;
-
-      int x_offset = (i * (graphWidth - 1)) / (g_window_size - 1);
-      int y_offset =
-          (int)((1.0f - (val - g_y_min) / (float)y_range) * (graphHeight - 1));
-
-      lv_area_t point_area;
-      point_area.x1 = graphX + x_offset - 3;
-      point_area.y1 = graphY + y_offset - 3;
-      point_area.x2 = graphX + x_offset + 3;
-      point_area.y2 = graphY + y_offset + 3;
-
-      lv_draw_rect(draw_ctx, &point_dsc, &point_area);
-    }
+    // Projected once per window/range/size; drawn per clip area
+    FrameProfScope prof(PROF_CHART_SERIES);
+    g_chart_renderer.project(g_chart_lod, chart_vertex_value, g_chart_pyramid,
+                             g_window_start, g_window_size, g_y_min, g_y_max,
+                             graphWidth, graphHeight);
+    g_chart_renderer.draw(draw_ctx, graphX, graphY);
   }
 }
 
@@ -384,30 +320,47 @@ static void chart_draw_event_cb(lv_event_t *e) {
 static void update_chart_from_slider(lv_event_t *e) {
   if (!slider || !chart)
     return;
-  if (weatherData.empty())
+  if (weatherData.empty()) {
+    // Nothing to plot (failed download): drop the previous series' lines
+    g_window_start = 0;
+    g_window_size = 0;
+    g_chart_renderer.invalidate();
+    lv_obj_invalidate(chart);
     return;
+  }
 
   int slider_value = lv_slider_get_value(slider);
-  int total = (int)weatherData.size();
-  const int max_points = 50; // Limit visible points for performance
-  int window_size = min(max_points, total);
-  // Map slider (0-100) to data range
-  int start = map(slider_value, 0, 100, 0, max(0, total - window_size));
-
-  g_window_start = start;
-  g_window_size = window_size;
-
-  // Find min/max temperature in current window for Y-axis scaling
-  float min_val = 100000.0f;
-  float max_val = -100000.0f;
-
-  for (int i = 0; i < window_size; i++) {
-    float v = weatherData[start + i].temp;
-    if (v < min_val)
-      min_val = v;
-    if (v > max_val)
-      max_val = v;
-  }
+  const ChartZoomLevel &zoom = CHART_ZOOM_LEVELS[g_zoom_level];
+
+  // Aggregates and range index follow weatherData: rebuilt after a new
+  // fetch, extended in place after appends, otherwise a no-op
+  g_chart_pyramid.sync(weatherData);
+
+  // Window for the current zoom level, positioned by the slider
+  size_t start = 0, window_size = 0;
+  if (zoom.aggregate < 0)
+    chart_zoom_window(weatherData, zoom.span_s, slider_value, start,
+                      window_size);
+  else
+    window_size = weatherData.size();
+
+  g_window_start = (int)start;
+  g_window_size = (int)window_size;
+
+  // Reduce the window to about one vertex per pixel column, keeping the
+  // min and max of every column (also gives the Y range), or to one
+  // vertex per day/week in the aggregated views
+  int graph_width = lv_obj_get_width(chart) - g_graph_margin_left -
+                    GRAPH_MARGIN_RIGHT;
+  if (zoom.aggregate < 0)
+    g_chart_lod.build(weatherData, g_chart_pyramid.range(), start,
+                      window_size, max(1, graph_width / CHART_PX_PER_BUCKET));
+  else
+    g_chart_lod.buildAggregate(weatherData, g_chart_pyramid,
+                               (SeriesPyramid::Level)zoom.aggregate);
+
+  float min_val = g_chart_lod.minValue();
+  float max_val = g_chart_lod.maxValue();
 
   // Add padding to Y-axis range for better visibility
   int y_min = (int)floor(min_val - 2.0f);
@@ -423,56 +376,64 @@ static void update_chart_from_slider(lv_event_t *e) {
 
   // Update chart with new range and data
   lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, y_min, y_max);
-  lv_chart_set_point_count(chart, window_size);
+  // The chart series mirrors the drawn vertices (lines are custom drawn)
+  uint16_t vertex_count = (uint16_t)g_chart_lod.size();
+  lv_chart_set_point_count(chart, vertex_count);
+  for (uint16_t i = 0; i < vertex_count; i++)
+    lv_chart_set_value_by_id(chart, series, i,
+                             (lv_coord_t)chart_vertex_value(i));
+
+  g_chart_renderer.invalidate();
+  lv_chart_refresh(chart);
+  lv_obj_invalidate(chart);
+}
 
-  // Populate chart data points
-  for (int i = 0; i < window_size; i++) {
-    float v = weatherData[start + i].temp;
-    lv_chart_set_value_by_id(chart, series, i, v);
+// --------------------------------------------------------------------
+// Chart Status
+// "Loading..." above the plot while the fetch worker downloads, "No data"
+// in its middle when the last series download failed
+// --------------------------------------------------------------------
+static void update_chart_status() {
+  if (!chart_status)
+    return;
+  if (fetch_loading) {
+    lv_label_set_text_static(chart_status, "Loading...");
+    lv_obj_align(chart_status, LV_ALIGN_TOP_MID, 0, -GRAPH_MARGIN_TOP);
+  } else if (series_failed) {
+    lv_label_set_text_static(chart_status, "No data");
+    lv_obj_center(chart_status);
+  } else {
+    lv_obj_add_flag(chart_status, LV_OBJ_FLAG_HIDDEN);
+    return;
   }
+  lv_obj_clear_flag(chart_status, LV_OBJ_FLAG_HIDDEN);
+}
 
-  lv_chart_refresh(chart);
-  lv_obj_invalidate(chart);
+// --------------------------------------------------------------------
+// Zoom Button
+// Steps through CHART_ZOOM_LEVELS, widest to narrowest and around again
+// The slider keeps its position, so the view stays near the same dates
+// --------------------------------------------------------------------
+static void zoom_btn_event_cb(lv_event_t *e) {
+  (void)e;
+  g_zoom_level = (g_zoom_level + 1) % CHART_ZOOM_COUNT;
+  if (zoom_label)
+    lv_label_set_text(zoom_label, CHART_ZOOM_LEVELS[g_zoom_level].label);
+  update_chart_from_slider(NULL);
 }
 
 static void setup_weather_screen() {
+  g_chart_renderer.begin();
   lv_obj_add_event_cb(slider, update_chart_from_slider, LV_EVENT_VALUE_CHANGED,
                       NULL);
   update_chart_from_slider(NULL);
 }
 
 // --------------------------------------------------------------------
-// UI Creation
-// Creates a 4-tile horizontal tileview:
-// Tile 0: Splash screen
-// Tile 1: 7-day forecast
-// Tile 2: Historical data chart with slider
-// Tile 3: Settings page
+// Chart Tile
+// Historical data chart with custom drawing, slider and zoom button
 // --------------------------------------------------------------------
-static void create_ui() {
-  tileview = lv_tileview_create(NULL);
-  lv_obj_set_scroll_dir(tileview, LV_DIR_ALL);
-  lv_obj_add_flag(tileview, LV_OBJ_FLAG_SCROLL_MOMENTUM);
-  lv_obj_clear_flag(tileview, LV_OBJ_FLAG_SCROLL_ELASTIC);
-
-  // Tile 1: Splash screen with version info
-  lv_obj_t *t1 = lv_tileview_add_tile(tileview, 0, 0, LV_DIR_HOR);
-  lv_obj_set_style_bg_color(t1, lv_color_white(), 0);
-  lv_obj_t *splash_label = lv_label_create(t1);
-  lv_label_set_text(splash_label, "Group 1\nVersion 0.9");
-  lv_obj_set_style_text_font(splash_label, &lv_font_montserrat_28, 0);
-  lv_obj_center(splash_label);
-
-  // Tile 2: 7-day weather forecast
-  t2 = lv_tileview_add_tile(tileview, 1, 0, LV_DIR_HOR);
-  lv_obj_set_style_bg_color(t2, lv_color_white(), 0);
-  SevenDayForecast_CreateOn(
-      t2); // Create forecast cards (defined in 7dayForecast.hpp)
-
-  // Tile 3: Historical data chart with custom drawing
-  lv_obj_t *t3 = lv_tileview_add_tile(tileview, 2, 0, LV_DIR_HOR);
-  lv_obj_set_style_bg_color(t3, lv_color_white(), 0);
-
+static void create_chart_tile(lv_obj_t *t3) {
   // Create chart with custom styling
   chart = lv_chart_create(t3);
   lv_obj_remove_style_all(chart); // Start with clean slate
@@ -522,17 +483,122 @@ static void create_ui() {
 
   // Create slider for scrolling through historical data
   slider = lv_slider_create(t3);
-  lv_obj_set_width(slider, lv_disp_get_hor_res(NULL) - 40);
-  lv_obj_align(slider, LV_ALIGN_BOTTOM_MID, 0, -8);
+  lv_obj_set_width(slider, lv_disp_get_hor_res(NULL) - 120);
+  lv_obj_align(slider, LV_ALIGN_BOTTOM_LEFT, 20, -8);
   lv_slider_set_range(slider, 0, 100); // 0 = oldest data, 100 = newest data
-  setup_weather_screen();              // Connect slider to chart update handler
 
-  // Tile 4: Settings page for city/parameter selection
-  t4 = lv_tileview_add_tile(tileview, 3, 0, LV_DIR_HOR);
-  lv_obj_set_style_bg_color(t4, lv_color_white(), 0);
-  create_settings_tile(); // Create settings UI (defined in settingsTile.hpp)
+  // Zoom level button next to the slider
+  lv_obj_t *zoom_btn = lv_btn_create(t3);
+  lv_obj_set_size(zoom_btn, 70, 32);
+  lv_obj_align(zoom_btn, LV_ALIGN_BOTTOM_RIGHT, -10, -2);
+  lv_obj_add_event_cb(zoom_btn, zoom_btn_event_cb, LV_EVENT_CLICKED, NULL);
+  zoom_label = lv_label_create(zoom_btn);
+  lv_label_set_text(zoom_label, CHART_ZOOM_LEVELS[g_zoom_level].label);
+  lv_obj_center(zoom_label);
+
+  chart_status = lv_label_create(chart);
+  lv_obj_set_style_text_font(chart_status, &lv_font_montserrat_14, 0);
+  update_chart_status();
+
+  // Data may be in already: the first update needs the chart's real width
+  lv_obj_update_layout(t3);
+  setup_weather_screen(); // Connect slider, draw data fetched so far
+}
+
+// --------------------------------------------------------------------
+// UI Creation
+// Creates a 4-tile horizontal tileview:
+// Tile 0: Splash screen
+// Tile 1: 7-day forecast
+// Tile 2: Historical data chart with slider
+// Tile 3: Settings page
+//
+// Only the splash is built here, so it is on the panel with the first
+// refresh. The other tiles start out empty and are filled in when they
+// are approached: the forecast right after the first frame, then always
+// the tile after the one shown, and both neighbours as soon as a swipe
+// starts.
+// --------------------------------------------------------------------
+static const int UI_TILE_COUNT = 4;
+static lv_obj_t *ui_tiles[UI_TILE_COUNT] = {};
+static bool ui_tile_built[UI_TILE_COUNT] = {};
+
+static void build_tile(int idx) {
+  if (idx < 0 || idx >= UI_TILE_COUNT || ui_tile_built[idx])
+    return;
+  ui_tile_built[idx] = true;
+
+  uint32_t start = micros();
+  switch (idx) {
+  case 1:
+    SevenDayForecast_CreateOn(t2); // Forecast cards (7dayForecast.hpp)
+    break;
+  case 2:
+    create_chart_tile(ui_tiles[2]);
+    break;
+  case 3:
+    create_settings_tile(); // Settings UI (settingsTile.hpp)
+    break;
+  default:
+    break;
+  }
+  Serial.printf("UI: tile %d built in %lu us\n", idx, micros() - start);
+}
+
+static int active_tile_index() {
+  lv_obj_t *act = lv_tileview_get_tile_act(tileview);
+  for (int i = 0; i < UI_TILE_COUNT; i++)
+    if (ui_tiles[i] == act)
+      return i;
+  return 0;
+}
 
-  lv_scr_load_anim(tileview, LV_SCR_LOAD_ANIM_FADE_IN, 500, 0, false);
+static void tileview_event_cb(lv_event_t *e) {
+  int idx = active_tile_index();
+  if (lv_event_get_code(e) == LV_EVENT_SCROLL_BEGIN) {
+    build_tile(idx - 1);
+    build_tile(idx + 1);
+  } else {
+    build_tile(idx + 1); // Settled on a tile: one ahead
+  }
+}
+
+// First tile after the splash, once the splash is on the panel
+static void build_tiles_ahead_cb(lv_timer_t *t) {
+  (void)t;
+  build_tile(1);
+  g_boot.mark(BOOT_TILES_AHEAD);
+}
+
+static void create_ui() {
+  tileview = lv_tileview_create(NULL);
+  lv_obj_set_scroll_dir(tileview, LV_DIR_ALL);
+  lv_obj_add_flag(tileview, LV_OBJ_FLAG_SCROLL_MOMENTUM);
+  lv_obj_clear_flag(tileview, LV_OBJ_FLAG_SCROLL_ELASTIC);
+
+  for (int i = 0; i < UI_TILE_COUNT; i++) {
+    ui_tiles[i] = lv_tileview_add_tile(tileview, i, 0, LV_DIR_HOR);
+    lv_obj_set_style_bg_color(ui_tiles[i], lv_color_white(), 0);
+  }
+  t2 = ui_tiles[1];
+  t4 = ui_tiles[3];
+
+  // Tile 1: Splash screen with version info
+  lv_obj_t *splash_label = lv_label_create(ui_tiles[0]);
+  lv_label_set_text(splash_label, "Group 1\nVersion 0.9");
+  lv_obj_set_style_text_font(splash_label, &lv_font_montserrat_28, 0);
+  lv_obj_center(splash_label);
+  ui_tile_built[0] = true;
+
+  lv_obj_add_event_cb(tileview, tileview_event_cb, LV_EVENT_SCROLL_BEGIN,
+                      NULL);
+  lv_obj_add_event_cb(tileview, tileview_event_cb, LV_EVENT_VALUE_CHANGED,
+                      NULL);
+  lv_timer_t *t = lv_timer_create(build_tiles_ahead_cb, 0, NULL);
+  lv_timer_set_repeat_count(t, 1);
+
+  // Shown at once (no fade-in), so the first frame is the splash
+  lv_scr_load(tileview);
 }
 
 // --------------------------------------------------------------------
@@ -548,9 +614,58 @@ void setup() {
   }
   amoled.setBrightness(255);
   amoled.setRotation(0);
-  beginLvglHelper(amoled);
-  delay(200);
+  g_boot.mark(BOOT_DISPLAY);
+  beginLvglHelperDMA(amoled); // Double-buffered, flushed by async DMA
+  g_frame_profiler.begin();   // Serial commands p/c/j/f/r, see frameProfiler.hpp
+  g_boot.mark(BOOT_LVGL);
+
+  // Splash on the panel before anything else is set up
   create_ui();
+  g_boot.mark(BOOT_SPLASH);
+  lv_refr_now(NULL);
+  g_boot.mark(BOOT_FIRST_PIXEL);
+
+  series_cache_begin(); // Mount flash cache for observation series
+  settings_load_station_cache(); // Stations probed on earlier boots
+  fetch_worker_begin(); // Network I/O runs on core 0 from here on
+  g_boot.mark(BOOT_STORAGE);
+#ifdef WEATHER_ICON_BENCH
+  weather_icon_bench(); // Forecast icon objects vs. atlas, serial log only
+#endif
+}
+
+// --------------------------------------------------------------------
+// Display Flush Stats
+// Logs every 10 s while frames are drawn: per-frame render and transfer
+// time, and how much of the rendering ran while the bus was busy
+// --------------------------------------------------------------------
+static void log_flush_stats() {
+  static uint32_t last_log = 0;
+  if (millis() - last_log < 10000)
+    return;
+  last_log = millis();
+
+  LvglFlushStats st;
+  lvglHelperFlushStats(&st, true);
+  if (!st.frames)
+    return;
+  unsigned overlap_pct =
+      st.render_us ? (unsigned)(st.overlap_us * 100 / st.render_us) : 0;
+  Serial.printf("Display: %u frames, %u areas, render %.1f ms/frame, "
+                "transfer %.1f ms/frame, overlap %u%%, stall %.1f ms/frame\n",
+                (unsigned)st.frames, (unsigned)st.areas,
+                st.render_us / 1000.0f / st.frames,
+                st.transfer_us / 1000.0f / st.frames, overlap_pct,
+                st.stall_us / 1000.0f / st.frames);
+}
+
+// Deferred live check of the build-time station/parameter table
+static void param_index_verify_cb(lv_timer_t *t) {
+  (void)t;
+  if (g_param_index.verifyDue(time(nullptr)))
+    fetch_worker_request_param_index(PARAM_CODES, PARAM_COUNT);
+  else
+    Serial.println("ParamIndex: table checked recently, live check skipped");
 }
 
 /**
@@ -560,15 +675,37 @@ void setup() {
  * - Non-blocking WiFi connection
  * - Station list loading once WiFi is connected
  * - Initial weather data fetch with saved preferences
+ * - Picking up datasets finished by the fetch worker
  */
 void loop() {
-  lv_timer_handler();          // Process LVGL UI updates
+  uint32_t handler_start = micros();
+  lv_timer_handler(); // Process LVGL UI updates
+  g_frame_profiler.recordTimerHandler(micros() - handler_start);
+  if (g_boot.reached(BOOT_TILES_AHEAD))
+    g_boot.mark(BOOT_INTERACTIVE);
+  g_frame_profiler.pollSerial();
   connect_wifi_non_blocking(); // Maintain WiFi connection
 
+  // Swap in whatever the background fetch worker has completed
+  if (fetch_worker_take_series(weatherData)) {
+    series_failed = weatherData.empty();
+    update_chart_status();
+    update_chart_from_slider(NULL);
+  }
+  fetch_worker_take_forecast(g_week);
+  if (fetch_worker_busy() != fetch_loading) {
+    fetch_loading = !fetch_loading;
+    update_chart_status();
+  }
+  settings_poll_param_index();
+  log_flush_stats();
+
   // Load station list once WiFi is connected
   if (wifi_connected && !stations_loaded) {
     stations_loaded = fetch_and_select_top_stations(10.0f, 50);
     if (stations_loaded) {
+      // Build-time availability table, if compiled in: no probing needed
+      g_param_index.seedFromTable(PARAM_CODES, PARAM_COUNT);
       settings_update_city_options(); // Populate city dropdown
     }
   }
@@ -584,8 +721,8 @@ void loop() {
 
     // Try to find Karlskrona station as default
     for (size_t i = 0; i < gStations.size(); ++i) {
-      if (gStations[i].name.equalsIgnoreCase("Karlskrona") ||
-          gStations[i].name.startsWith("Karlskrona")) {
+      if (strcasecmp(gStations[i].name, "Karlskrona") == 0 ||
+          strncmp(gStations[i].name, "Karlskrona", 10) == 0) {
         station_idx = (int)i;
         break;
       }
@@ -593,7 +730,7 @@ void loop() {
 
     if (station_idx < 0) {
       for (size_t i = 0; i < gStations.size(); ++i) {
-        if (gStations[i].name.indexOf("Karlskrona") >= 0) {
+        if (strstr(gStations[i].name, "Karlskrona")) {
           station_idx = (int)i;
           break;
         }
@@ -609,12 +746,9 @@ void loop() {
       prefs.end();
 
       if (!st_id.isEmpty()) {
-        for (size_t i = 0; i < gStations.size(); ++i) {
-          if (gStations[i].id == st_id) {
-            station_idx = (int)i;
-            break;
-          }
-        }
+        int found = gStations.indexOf(st_id.c_str());
+        if (found >= 0)
+          station_idx = found;
       }
 
       if (saved_param > 0) {
@@ -637,14 +771,25 @@ void loop() {
     Serial.printf("Using station_idx=%d, param_code=%d, city=%s\n", station_idx,
                   param_code, city_name.c_str());
 
-    // Fetch and display initial weather data
+    // Queue initial weather data; chart and forecast update when it lands
     if (station_idx >= 0) {
-      weather.update_weather_data(station_idx, param_code, "latest-months");
-      update_chart_from_slider(NULL); // Update chart with fetched data
-      SevenDayForecast_OnStationSelected(station_idx); // Update 7-day forecast
+      fetch_worker_request_series(station_idx, param_code);
+      fetch_worker_request_forecast(station_idx);
       settings_sync_state(station_idx, param_code,
                           city_name); // Sync settings UI
     }
+
+    // Station/parameter metadata, queued behind the first data fetch. With
+    // the build-time table already in place it is only a background
+    // check, so it waits until the first downloads have settled and runs
+    // at most once a day
+    if (g_param_index.fromTable()) {
+      lv_timer_t *t = lv_timer_create(param_index_verify_cb,
+                                      PARAM_INDEX_VERIFY_DELAY_MS, NULL);
+      lv_timer_set_repeat_count(t, 1);
+    } else {
+      fetch_worker_request_param_index(PARAM_CODES, PARAM_COUNT);
+    }
   }
 
   delay(5);
@@ -0,0 +1,288 @@
+#pragma once
+#include <Arduino.h>
+#include <algorithm>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// Longest folded name or query kept, including the terminating NUL
+static const size_t SEARCH_FOLD_MAX = 64;
+
+/**
+ * UTF-8 Diacritic Folding for Swedish Text
+ * Maps Swedish characters (å,ä,ö,é,è,ø,æ) to ASCII, keeping their case,
+ * so names show with the ASCII-only LVGL fonts ("Gråstorp" -> "Grastorp").
+ * With lower set everything is lowercased too, for matching ("Goteborg"
+ * matches "Göteborg"). Writes into a caller buffer (truncated to cap - 1
+ * bytes); the folded text is never longer than the input.
+ *
+ * @return Length of the folded text
+ */
+static size_t fold_sv_ascii(const char *in, char *out, size_t cap,
+                            bool lower) {
+  size_t n = 0;
+  if (!cap)
+    return 0;
+  for (const unsigned char *s = (const unsigned char *)in; *s && n + 1 < cap;
+       ++s) {
+    const char *rep = nullptr;
+    if (s[0] == 0xC3 && s[1]) {
+      switch (s[1]) {
+      case 0xA5: case 0xA4: rep = "a"; break;  // å ä
+      case 0x85: case 0x84: rep = "A"; break;  // Å Ä
+      case 0xB6: case 0xB8: rep = "o"; break;  // ö ø
+      case 0x96: case 0x98: rep = "O"; break;  // Ö Ø
+      case 0xA9: case 0xA8: rep = "e"; break;  // é è
+      case 0x89: case 0x88: rep = "E"; break;  // É È
+      case 0xA6: rep = "ae"; break;            // æ
+      case 0x86: rep = "AE"; break;            // Æ
+      }
+    }
+    if (!rep) {
+      out[n++] = lower ? (char)tolower(*s) : (char)*s;
+      continue;
+    }
+    for (; *rep && n + 1 < cap; ++rep)
+      out[n++] = lower ? (char)tolower(*rep) : *rep;
+    ++s; // Second byte of the UTF-8 pair
+  }
+  out[n] = 0;
+  return n;
+}
+
+// Folded for matching: ASCII and lowercase
+static size_t fold_sv_ascii_lower(const char *in, char *out, size_t cap) {
+  return fold_sv_ascii(in, out, cap, true);
+}
+
+/**
+ * Folded Name Index
+ * Search index over a fixed list of names (the city dropdown, the
+ * station table), built once; lookups fold only the query and allocate
+ * nothing.
+ *
+ * Everything lives in one PSRAM block:
+ * - the folded names, NUL-terminated, back to back, with their offsets
+ * - entry ids sorted by folded name (exact lookup by binary search)
+ * - a trigram posting list: every 3-byte substring of the folded names
+ *   (sorted keys) with the ascending ids of the entries containing it.
+ *   A substring query only verifies the entries listed under its rarest
+ *   trigram; names shorter than 3 bytes are listed separately.
+ *
+ * Entry ids are the positions in the list the index was built from.
+ */
+class FoldedNameIndex {
+public:
+  FoldedNameIndex() = default;
+  ~FoldedNameIndex() { free(block); }
+  FoldedNameIndex(const FoldedNameIndex &) = delete;
+  FoldedNameIndex &operator=(const FoldedNameIndex &) = delete;
+
+  /**
+   * Build Index
+   * @param n Number of names (at most 65535)
+   * @param name_at Returns the UTF-8 name of entry i
+   * @return false if out of memory or the names don't fit 16-bit offsets
+   */
+  template <typename NameAt> bool build(size_t n, NameAt name_at) {
+    free(block);
+    block = nullptr;
+    count = 0;
+    if (n > 0xFFFF)
+      return false;
+
+    // Fold everything once into temporary storage
+    std::vector<char> text;
+    std::vector<uint32_t> offs(n);
+    char buf[SEARCH_FOLD_MAX];
+    for (size_t i = 0; i < n; i++) {
+      size_t len = fold_sv_ascii_lower(name_at(i), buf, sizeof(buf));
+      offs[i] = (uint32_t)text.size();
+      text.insert(text.end(), buf, buf + len + 1);
+    }
+    if (text.size() > 0xFFFF)
+      return false;
+
+    // (trigram << 16 | id), sorted: grouped by trigram, ids ascending
+    std::vector<uint64_t> grams;
+    std::vector<uint16_t> shorts;
+    for (size_t i = 0; i < n; i++) {
+      const char *s = &text[offs[i]];
+      size_t len = strlen(s);
+      if (len < 3)
+        shorts.push_back((uint16_t)i);
+      for (size_t k = 0; k + 3 <= len; k++)
+        grams.push_back((uint64_t)trigram(s + k) << 16 | i);
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    size_t keys = 0;
+    for (size_t g = 0; g < grams.size(); g++)
+      keys += g == 0 || (grams[g] >> 16) != (grams[g - 1] >> 16);
+    if (grams.size() > 0xFFFF)
+      return false;
+
+    // One block: keys | starts | postings | offsets | sorted | shorts | text
+    size_t bytes = keys * sizeof(uint32_t) + (keys + 1) * sizeof(uint16_t) +
+                   grams.size() * sizeof(uint16_t) +
+                   (2 * n + shorts.size()) * sizeof(uint16_t) + text.size();
+    block = (uint8_t *)ps_malloc(bytes);
+    if (!block)
+      block = (uint8_t *)malloc(bytes);
+    if (!block)
+      return false;
+
+    uint8_t *p = block;
+    tri_keys = (uint32_t *)p;
+    p += keys * sizeof(uint32_t);
+    tri_start = (uint16_t *)p;
+    p += (keys + 1) * sizeof(uint16_t);
+    postings = (uint16_t *)p;
+    p += grams.size() * sizeof(uint16_t);
+    offset = (uint16_t *)p;
+    p += n * sizeof(uint16_t);
+    by_name = (uint16_t *)p;
+    p += n * sizeof(uint16_t);
+    short_ids = (uint16_t *)p;
+    p += shorts.size() * sizeof(uint16_t);
+    memcpy(p, text.data(), text.size());
+    names = (const char *)p;
+    for (size_t i = 0; i < n; i++) {
+      offset[i] = (uint16_t)offs[i];
+      by_name[i] = (uint16_t)i;
+    }
+    count = n;
+    // Ties keep list order, so the first of equal names is found first
+    std::sort(by_name, by_name + n, [this](uint16_t a, uint16_t b) {
+      int c = strcmp(name(a), name(b));
+      return c ? c < 0 : a < b;
+    });
+    std::copy(shorts.begin(), shorts.end(), short_ids);
+    short_count = shorts.size();
+
+    tri_count = 0;
+    for (size_t g = 0; g < grams.size(); g++) {
+      uint32_t key = (uint32_t)(grams[g] >> 16);
+      if (tri_count == 0 || tri_keys[tri_count - 1] != key) {
+        tri_keys[tri_count] = key;
+        tri_start[tri_count++] = (uint16_t)g;
+      }
+      postings[g] = (uint16_t)(grams[g] & 0xFFFF);
+    }
+    tri_start[tri_count] = (uint16_t)grams.size();
+
+    Serial.printf("SearchIndex: %u names, %u trigrams, %u bytes\n",
+                  (unsigned)n, (unsigned)tri_count, (unsigned)bytes);
+    return true;
+  }
+
+  bool built() const { return block != nullptr; }
+  size_t size() const { return count; }
+
+  // Folded name of entry i
+  const char *name(size_t i) const { return names + offset[i]; }
+
+  /**
+   * Exact Lookup
+   * @param folded Folded query
+   * @return Lowest id with exactly that folded name, -1 if none
+   */
+  int find(const char *folded) const {
+    size_t k = lower_bound(folded);
+    if (k < count && strcmp(name(by_name[k]), folded) == 0)
+      return by_name[k];
+    return -1;
+  }
+
+  /**
+   * Substring Lookup
+   * Calls fn(id) for every entry whose folded name contains the folded
+   * query, in ascending id order. Queries under 3 bytes scan the names.
+   */
+  template <typename Fn> void forEachContaining(const char *folded, Fn fn) const {
+    size_t len = strlen(folded);
+    if (len < 3) {
+      for (size_t i = 0; i < count; i++)
+        if (!len || strstr(name(i), folded))
+          fn((uint16_t)i);
+      return;
+    }
+
+    // Entries holding the query hold each of its trigrams: verify the
+    // shortest posting list only
+    size_t best = 0, best_len = SIZE_MAX;
+    for (size_t k = 0; k + 3 <= len; k++) {
+      size_t t = find_trigram(trigram(folded + k));
+      if (t == SIZE_MAX)
+        return;
+      size_t l = tri_start[t + 1] - tri_start[t];
+      if (l < best_len) {
+        best = t;
+        best_len = l;
+      }
+    }
+    for (size_t j = tri_start[best]; j < tri_start[best + 1]; j++)
+      if (strstr(name(postings[j]), folded))
+        fn(postings[j]);
+  }
+
+  /**
+   * Names Inside a Text
+   * Calls fn(id, pos) for every entry whose folded name occurs in the
+   * folded text, pos being where. An entry may be reported once per
+   * occurrence, in no particular order.
+   */
+  template <typename Fn> void forEachContainedIn(const char *folded, Fn fn) const {
+    for (size_t s = 0; s < short_count; s++) {
+      const char *hit = strstr(folded, name(short_ids[s]));
+      if (hit)
+        fn(short_ids[s], (size_t)(hit - folded));
+    }
+    // A name of 3+ bytes at pos starts with the text's trigram at pos
+    size_t len = strlen(folded);
+    for (size_t k = 0; k + 3 <= len; k++) {
+      size_t t = find_trigram(trigram(folded + k));
+      if (t == SIZE_MAX)
+        continue;
+      for (size_t j = tri_start[t]; j < tri_start[t + 1]; j++) {
+        const char *n = name(postings[j]);
+        if (strncmp(n, folded + k, 3) == 0 &&
+            strncmp(n, folded + k, strlen(n)) == 0)
+          fn(postings[j], k);
+      }
+    }
+  }
+
+private:
+  uint8_t *block = nullptr;
+  size_t count = 0;
+  const char *names = nullptr;
+  uint16_t *offset = nullptr;
+  uint16_t *by_name = nullptr;
+  uint16_t *short_ids = nullptr;
+  size_t short_count = 0;
+  uint32_t *tri_keys = nullptr;
+  uint16_t *tri_start = nullptr; // tri_count + 1 entries
+  uint16_t *postings = nullptr;
+  size_t tri_count = 0;
+
+  static uint32_t trigram(const char *s) {
+    return (uint32_t)(uint8_t)s[0] << 16 | (uint32_t)(uint8_t)s[1] << 8 |
+           (uint8_t)s[2];
+  }
+
+  size_t find_trigram(uint32_t key) const {
+    const uint32_t *begin = tri_keys, *end = tri_keys + tri_count;
+    const uint32_t *it = std::lower_bound(begin, end, key);
+    return it != end && *it == key ? (size_t)(it - begin) : SIZE_MAX;
+  }
+
+  // First position in by_name whose name is not less than folded
+  size_t lower_bound(const char *folded) const {
+    const uint16_t *it = std::lower_bound(
+        by_name, by_name + count, folded,
+        [this](uint16_t id, const char *q) { return strcmp(name(id), q) < 0; });
+    return (size_t)(it - by_name);
+  }
+};
@@ -0,0 +1,268 @@
+#pragma once
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <algorithm>
+#include <stddef.h>
+#include <vector>
+
+#include "seriesStore.hpp"
+
+/**
+ * Series Cache
+ * Keeps the packed observation series on flash (LittleFS, "spiffs"
+ * partition) so a city/parameter change or a reboot can start from the
+ * cached history and only fetch the newest points.
+ *
+ * One file per (station id, parameter code): a small header followed by
+ * the three SeriesStore columns exactly as they sit in memory.
+ *
+ * The files share the partition with the station cache, so their total
+ * size is capped: before a save the least recently used files (by a use
+ * stamp in the header, bumped on every load and save) are removed until
+ * the new file fits in SERIES_CACHE_MAX_BYTES.
+ */
+
+// Upper bound on cached history per series (~11 months of hourly data)
+static const size_t SERIES_CACHE_MAX_POINTS = 8192;
+
+// Budget for all series files together (~14 full 74 KB series)
+static const size_t SERIES_CACHE_MAX_BYTES = 1024 * 1024;
+
+static const uint32_t SERIES_CACHE_MAGIC = 0x53524353; // "SCRS"
+static const uint16_t SERIES_CACHE_VERSION = 2;
+
+struct SeriesCacheHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint8_t resolution; // SeriesStore::Resolution
+  uint8_t reserved;
+  uint32_t count;      // Number of points that follow
+  int32_t last_epoch;  // Timestamp of the newest point (delta fetch start)
+  uint32_t last_used;  // g_series_cache_clock at the last load/save
+};
+
+static bool g_series_cache_ready = false;
+static uint32_t g_series_cache_clock = 0; // Use stamp, restored at mount
+
+// A cache file as seen by the eviction scan
+struct SeriesCacheFile {
+  String path;
+  size_t size;
+  uint32_t last_used; // 0 = no valid header (leftover .tmp), goes first
+};
+
+/**
+ * List Cache Files
+ * Every series file and leftover temp file in the filesystem root, with
+ * the use stamp from its header
+ */
+static void series_cache_list(std::vector<SeriesCacheFile> &out) {
+  File root = LittleFS.open("/", "r");
+  if (!root || !root.isDirectory())
+    return;
+  for (File f = root.openNextFile(); f; f = root.openNextFile()) {
+    String name = f.name();
+    if (!f.isDirectory() && name.startsWith("s_") &&
+        (name.endsWith(".bin") || name.endsWith(".bin.tmp"))) {
+      SeriesCacheHeader h;
+      bool valid = name.endsWith(".bin") &&
+                   f.read((uint8_t *)&h, sizeof(h)) == sizeof(h) &&
+                   h.magic == SERIES_CACHE_MAGIC &&
+                   h.version == SERIES_CACHE_VERSION;
+      out.push_back({String("/") + name, f.size(), valid ? h.last_used : 0});
+    }
+    f.close();
+  }
+  root.close();
+}
+
+/**
+ * Make Room
+ * Removes the least recently used files until `need` more bytes fit in
+ * SERIES_CACHE_MAX_BYTES. `replacing` is the file the save overwrites, so
+ * it neither counts nor gets evicted.
+ */
+static void series_cache_make_room(const String &replacing, size_t need) {
+  std::vector<SeriesCacheFile> files;
+  series_cache_list(files);
+
+  size_t used = 0;
+  for (const SeriesCacheFile &f : files) {
+    if (f.path != replacing)
+      used += f.size;
+  }
+  if (used + need <= SERIES_CACHE_MAX_BYTES)
+    return;
+
+  std::sort(files.begin(), files.end(),
+            [](const SeriesCacheFile &a, const SeriesCacheFile &b) {
+              return a.last_used < b.last_used;
+            });
+  for (const SeriesCacheFile &f : files) {
+    if (used + need <= SERIES_CACHE_MAX_BYTES)
+      break;
+    if (f.path == replacing || !LittleFS.remove(f.path))
+      continue;
+    used -= f.size;
+    Serial.printf("Cache: evicted %s (%u bytes)\n", f.path.c_str(),
+                  (unsigned)f.size);
+  }
+}
+
+// Stamp a file as just used (header rewrite only, columns untouched)
+static void series_cache_touch(const String &path) {
+  File f = LittleFS.open(path, "r+");
+  if (!f)
+    return;
+  uint32_t stamp = ++g_series_cache_clock;
+  if (f.seek(offsetof(SeriesCacheHeader, last_used)))
+    f.write((const uint8_t *)&stamp, sizeof(stamp));
+  f.close();
+}
+
+/**
+ * Mount Cache Filesystem
+ * Formats the partition on first use; without it caching is simply skipped
+ */
+static bool series_cache_begin() {
+  g_series_cache_ready = LittleFS.begin(true);
+  if (!g_series_cache_ready) {
+    Serial.println("Cache: LittleFS mount failed, caching disabled");
+    return false;
+  }
+
+  // Continue the use stamps where the files left off
+  std::vector<SeriesCacheFile> files;
+  series_cache_list(files);
+  size_t series_bytes = 0;
+  for (const SeriesCacheFile &f : files) {
+    series_bytes += f.size;
+    g_series_cache_clock = std::max(g_series_cache_clock, f.last_used);
+  }
+  Serial.printf("Cache: LittleFS %u/%u bytes used, %u series files (%u "
+                "bytes)\n",
+                (unsigned)LittleFS.usedBytes(),
+                (unsigned)LittleFS.totalBytes(), (unsigned)files.size(),
+                (unsigned)series_bytes);
+  return true;
+}
+
+static String series_cache_path(const String &stationId, int paramCode) {
+  String path = "/s_";
+  path += stationId;
+  path += "_";
+  path += String(paramCode);
+  path += ".bin";
+  return path;
+}
+
+/**
+ * Load Cached Series
+ *
+ * @param stationId SMHI station id
+ * @param paramCode SMHI parameter code
+ * @param out Replaced with the cached points on success
+ * @return true if a valid cache file was found
+ */
+static bool series_cache_load(const String &stationId, int paramCode,
+                              SeriesStore &out) {
+  if (!g_series_cache_ready)
+    return false;
+
+  String path = series_cache_path(stationId, paramCode);
+  if (!LittleFS.exists(path))
+    return false;
+
+  File f = LittleFS.open(path, "r");
+  if (!f)
+    return false;
+
+  SeriesCacheHeader h;
+  bool ok = f.read((uint8_t *)&h, sizeof(h)) == sizeof(h) &&
+            h.magic == SERIES_CACHE_MAGIC &&
+            h.version == SERIES_CACHE_VERSION && h.count > 0 &&
+            h.count <= SERIES_CACHE_MAX_POINTS &&
+            h.resolution <= SeriesStore::RES_MONTHLY;
+
+  if (ok) {
+    ok = out.loadColumns(
+        h.count, (SeriesStore::Resolution)h.resolution,
+        [&](int32_t *times, float *values, uint8_t *quality, size_t n) {
+          size_t tb = n * sizeof(int32_t), vb = n * sizeof(float);
+          return f.read((uint8_t *)times, tb) == tb &&
+                 f.read((uint8_t *)values, vb) == vb &&
+                 f.read(quality, n) == n;
+        });
+    ok = ok && out.lastTime() == h.last_epoch;
+  }
+  f.close();
+
+  if (!ok) {
+    Serial.printf("Cache: %s is corrupt, removing\n", path.c_str());
+    out.clear();
+    LittleFS.remove(path);
+    return false;
+  }
+
+  series_cache_touch(path);
+  Serial.printf("Cache: loaded %u points from %s\n", (unsigned)out.size(),
+                path.c_str());
+  return true;
+}
+
+/**
+ * Save Series to Cache
+ * Writes to a temp file and renames it so a reset mid-write never leaves
+ * a truncated cache behind. Only the newest SERIES_CACHE_MAX_POINTS are
+ * kept, and older series are evicted first if the budget is exceeded.
+ */
+static bool series_cache_save(const String &stationId, int paramCode,
+                              const SeriesStore &in) {
+  if (!g_series_cache_ready || in.empty())
+    return false;
+
+  size_t n = in.size();
+  size_t first = 0;
+  if (n > SERIES_CACHE_MAX_POINTS) {
+    first = n - SERIES_CACHE_MAX_POINTS;
+    n = SERIES_CACHE_MAX_POINTS;
+  }
+
+  SeriesCacheHeader h;
+  h.magic = SERIES_CACHE_MAGIC;
+  h.version = SERIES_CACHE_VERSION;
+  h.resolution = (uint8_t)in.resolution();
+  h.reserved = 0;
+  h.count = (uint32_t)n;
+  h.last_epoch = in.lastTime();
+  h.last_used = ++g_series_cache_clock;
+
+  String path = series_cache_path(stationId, paramCode);
+  String tmp = path + ".tmp";
+  series_cache_make_room(path, sizeof(h) + n * (sizeof(int32_t) +
+                                                sizeof(float) + 1));
+
+  File f = LittleFS.open(tmp, "w");
+  if (!f)
+    return false;
+
+  size_t tb = n * sizeof(int32_t), vb = n * sizeof(float);
+  bool ok = f.write((const uint8_t *)&h, sizeof(h)) == sizeof(h) &&
+            f.write((const uint8_t *)(in.times() + first), tb) == tb &&
+            f.write((const uint8_t *)(in.values() + first), vb) == vb &&
+            f.write(in.qualities() + first, n) == n;
+  f.close();
+
+  if (!ok) {
+    Serial.printf("Cache: write failed for %s\n", path.c_str());
+    LittleFS.remove(tmp);
+    return false;
+  }
+
+  LittleFS.remove(path);
+  if (!LittleFS.rename(tmp, path)) {
+    LittleFS.remove(tmp);
+    return false;
+  }
+  return true;
+}
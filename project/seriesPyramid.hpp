@@ -0,0 +1,245 @@
+#pragma once
+#include <Arduino.h>
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+#include "seriesStore.hpp"
+
+/**
+ * Range Min/Max Index
+ * Argmin/argmax of any index range of a value column in constant time
+ *
+ * A sparse table over blocks of RANGE_BLOCK points: row k holds the
+ * argmin/argmax of 2^k consecutive blocks, so any run of whole blocks is
+ * covered by two overlapping rows. The partial blocks at either end of a
+ * query are scanned directly (at most 2 * RANGE_BLOCK points). Blocking
+ * keeps the table at n / 16 * log2(n / 16) entries, about 12 KB for a
+ * latest-months hourly series.
+ *
+ * Appending a point only touches the last block and the log2 rows that
+ * cover it.
+ */
+class RangeMinMax {
+public:
+  static const size_t RANGE_BLOCK = 16;
+
+  void clear() {
+    rows.clear();
+    n = 0;
+  }
+
+  size_t size() const { return n; }
+
+  /**
+   * Extend Index
+   * Takes in values[size()..count); the prefix must be unchanged
+   */
+  void extend(const float *v, size_t count) {
+    for (; n < count; n++)
+      append_one(v, n);
+  }
+
+  /**
+   * Range Extremes
+   * Index of the minimum and maximum of v[a, b); earliest index on ties
+   * v must be the column the index was built from.
+   */
+  void query(const float *v, size_t a, size_t b, size_t &imin,
+             size_t &imax) const {
+    imin = imax = a;
+    if (b > n)
+      b = n;
+    if (b <= a)
+      return;
+
+    size_t ba = a / RANGE_BLOCK;
+    size_t bb = (b - 1) / RANGE_BLOCK;
+    if (ba == bb) {
+      scan(v, a, b, imin, imax);
+      return;
+    }
+
+    // Partial head and tail blocks
+    size_t fa = ba, fb = bb;
+    if (a % RANGE_BLOCK) {
+      scan(v, a, (ba + 1) * RANGE_BLOCK, imin, imax);
+      fa = ba + 1;
+    }
+    size_t tail_end = std::min(n, (bb + 1) * RANGE_BLOCK);
+    if (b < tail_end) {
+      scan(v, bb * RANGE_BLOCK, b, imin, imax);
+      if (bb == 0)
+        return;
+      fb = bb - 1;
+    }
+    if (fa > fb)
+      return;
+
+    // Whole blocks: two overlapping power-of-two rows
+    size_t len = fb - fa + 1;
+    int k = 0;
+    while (((size_t)2 << k) <= len)
+      k++;
+    const Extremes &x = rows[k][fa];
+    const Extremes &y = rows[k][fb + 1 - ((size_t)1 << k)];
+    pick(v, x.imin, x.imax, imin, imax);
+    pick(v, y.imin, y.imax, imin, imax);
+  }
+
+private:
+  struct Extremes {
+    uint32_t imin;
+    uint32_t imax;
+  };
+
+  std::vector<std::vector<Extremes>> rows; // rows[k][block]
+  size_t n = 0;
+
+  static void scan(const float *v, size_t a, size_t b, size_t &imin,
+                   size_t &imax) {
+    for (size_t i = a; i < b; i++)
+      pick(v, i, i, imin, imax);
+  }
+
+  // Keep the earlier index on ties so results don't depend on query shape
+  static void pick(const float *v, size_t cmin, size_t cmax, size_t &imin,
+                   size_t &imax) {
+    if (v[cmin] < v[imin] || (v[cmin] == v[imin] && cmin < imin))
+      imin = cmin;
+    if (v[cmax] > v[imax] || (v[cmax] == v[imax] && cmax < imax))
+      imax = cmax;
+  }
+
+  void append_one(const float *v, size_t i) {
+    size_t b = i / RANGE_BLOCK;
+    if (rows.empty())
+      rows.emplace_back();
+    if (b == rows[0].size()) {
+      rows[0].push_back({(uint32_t)i, (uint32_t)i});
+    } else {
+      size_t lo = rows[0][b].imin, hi = rows[0][b].imax;
+      pick(v, i, i, lo, hi);
+      rows[0][b] = {(uint32_t)lo, (uint32_t)hi};
+    }
+
+    // Rows whose last span now ends at block b
+    size_t blocks = rows[0].size();
+    for (size_t k = 1; ((size_t)1 << k) <= blocks; k++) {
+      if (rows.size() <= k)
+        rows.emplace_back();
+      size_t half = (size_t)1 << (k - 1);
+      size_t j = b + 1 - ((size_t)1 << k);
+      const Extremes &x = rows[k - 1][j];
+      const Extremes &y = rows[k - 1][j + half];
+      size_t lo = x.imin, hi = x.imax;
+      pick(v, y.imin, y.imax, lo, hi);
+      if (j == rows[k].size())
+        rows[k].push_back({(uint32_t)lo, (uint32_t)hi});
+      else
+        rows[k][j] = {(uint32_t)lo, (uint32_t)hi};
+    }
+  }
+};
+
+/**
+ * Aggregate Bucket
+ * Summary of the raw points falling in one day or week (UTC)
+ */
+struct SeriesBucket {
+  int32_t start;  // Bucket start (epoch seconds)
+  uint32_t first; // Index of the bucket's first raw point
+  uint32_t count; // Raw points in the bucket
+  float min;
+  float max;
+  float sum;
+
+  float mean() const { return count ? sum / (float)count : 0.0f; }
+};
+
+/**
+ * Series Pyramid
+ * Raw points -> daily -> weekly min/max/mean/sum, plus a RangeMinMax over
+ * the raw values, kept in step with one SeriesStore
+ *
+ * sync() is called before each use: a store that only grew (delta fetch)
+ * is folded in point by point; a different or trimmed store (see
+ * SeriesStore::revision) is rebuilt, which is once per fetch.
+ */
+class SeriesPyramid {
+public:
+  enum Level : uint8_t {
+    LEVEL_DAY = 0,
+    LEVEL_WEEK,
+    LEVEL_COUNT
+  };
+
+  /**
+   * Follow Store
+   * @return true if anything changed
+   */
+  bool sync(const SeriesStore &s) {
+    if (s.revision() != rev || s.size() < synced) {
+      clear();
+      rev = s.revision();
+    }
+    if (s.size() == synced)
+      return false;
+
+    for (size_t i = synced; i < s.size(); i++)
+      add_point(s.time(i), s.value(i), i);
+    range_.extend(s.values(), s.size());
+    synced = s.size();
+    return true;
+  }
+
+  void clear() {
+    for (int l = 0; l < LEVEL_COUNT; l++)
+      buckets[l].clear();
+    range_.clear();
+    synced = 0;
+  }
+
+  const RangeMinMax &range() const { return range_; }
+
+  size_t bucketCount(Level l) const { return buckets[l].size(); }
+  const SeriesBucket &bucket(Level l, size_t i) const {
+    return buckets[l][i];
+  }
+
+private:
+  std::vector<SeriesBucket> buckets[LEVEL_COUNT];
+  RangeMinMax range_;
+  uint32_t rev = 0;
+  size_t synced = 0;
+
+  // Monday 00:00 UTC of the week containing t (1970-01-01 was a Thursday)
+  static int32_t week_start(int32_t day_start) {
+    int32_t day = day_start / 86400;
+    int32_t dow = (day + 3) % 7; // 0 = Monday
+    if (dow < 0)
+      dow += 7;
+    return (day - dow) * 86400;
+  }
+
+  static void fold(std::vector<SeriesBucket> &level, int32_t start, float v,
+                   size_t i) {
+    if (level.empty() || level.back().start != start) {
+      level.push_back({start, (uint32_t)i, 1, v, v, v});
+      return;
+    }
+    SeriesBucket &b = level.back();
+    b.count++;
+    b.sum += v;
+    if (v < b.min)
+      b.min = v;
+    if (v > b.max)
+      b.max = v;
+  }
+
+  void add_point(int32_t t, float v, size_t i) {
+    int32_t day = t - (t % 86400 + 86400) % 86400;
+    fold(buckets[LEVEL_DAY], day, v, i);
+    fold(buckets[LEVEL_WEEK], week_start(day), v, i);
+  }
+};
@@ -0,0 +1,286 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <utility>
+
+/**
+ * Civil Date to Epoch Seconds (UTC)
+ * Days-from-civil conversion that doesn't depend on the TZ setting
+ * (mktime() would apply the local timezone configured for NTP)
+ */
+static inline int32_t epoch_from_civil(int y, int m, int d, int hh = 0,
+                                       int mm = 0, int ss = 0) {
+  y -= m <= 2;
+  const int era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = (unsigned)(y - era * 400);
+  const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  const int32_t days = era * 146097 + (int32_t)doe - 719468;
+  return days * 86400 + hh * 3600 + mm * 60 + ss;
+}
+
+/**
+ * Parse ISO-like Date String to Epoch Seconds (UTC)
+ * Accepts "YYYY-MM", "YYYY-MM-DD" and "YYYY-MM-DDTHH:MM[:SS]Z"
+ * Date-only values are placed at 12:00 so they sit mid-day on the chart
+ *
+ * @param s Input text
+ * @param out Parsed epoch seconds
+ * @param parts Optional: number of date parts found (2 = month, 3 = day,
+ *              4+ = with time)
+ * @return true on success
+ */
+static inline bool parse_iso_date(const char *s, int32_t &out,
+                                  int *parts = nullptr) {
+  int y = 0, mo = 0, d = 1, hh = 12, mi = 0, sec = 0;
+  int n = sscanf(s, "%d-%d-%dT%d:%d:%d", &y, &mo, &d, &hh, &mi, &sec);
+  if (n < 2 || mo < 1 || mo > 12 || d < 1 || d > 31)
+    return false;
+  if (n == 4) // "THH" without minutes isn't a valid SMHI time
+    return false;
+  out = epoch_from_civil(y, mo, d, hh, mi, sec);
+  if (parts)
+    *parts = n;
+  return true;
+}
+
+/**
+ * Series Store
+ * Packed columnar storage for one observation time series
+ *
+ * Each point is an epoch-seconds timestamp (int32), a value (float) and
+ * the SMHI quality flag ('G', 'Y', ... or 0), kept in three parallel arrays
+ * allocated in PSRAM. That is 9 bytes per point and one allocation per
+ * column instead of two String objects per point. Date/time text is only
+ * produced on demand for the few labels actually drawn.
+ *
+ * Points must arrive in ascending time order; a point that is not newer
+ * than the last one is ignored, so a short delta fetch can be appended
+ * straight onto existing history.
+ *
+ * revision() changes whenever the contents change other than by appends
+ * (clear, trim, load, swap), so derived data such as SeriesPyramid can
+ * tell "new points at the end" from "different series".
+ */
+class SeriesStore {
+public:
+  enum Resolution : uint8_t {
+    RES_SUBDAILY = 0, // Hourly / 15 min observations (epoch timestamps)
+    RES_DAILY,        // One value per day ("ref": "YYYY-MM-DD")
+    RES_MONTHLY       // One value per month ("ref": "YYYY-MM")
+  };
+
+  SeriesStore() : rev(next_revision()) {}
+  ~SeriesStore() { release(); }
+  SeriesStore(const SeriesStore &) = delete;
+  SeriesStore &operator=(const SeriesStore &) = delete;
+
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  size_t capacity() const { return cap; }
+
+  void clear() {
+    count = 0;
+    res = RES_SUBDAILY;
+    rev = next_revision();
+  }
+
+  /**
+   * Reserve Capacity
+   * Grows all three columns to hold at least n points
+   * @return false if PSRAM (and the internal heap fallback) is exhausted
+   */
+  bool reserve(size_t n) {
+    if (n <= cap)
+      return true;
+    int32_t *t = (int32_t *)grow(times_, n * sizeof(int32_t));
+    if (!t)
+      return false;
+    times_ = t;
+    float *v = (float *)grow(values_, n * sizeof(float));
+    if (!v)
+      return false;
+    values_ = v;
+    uint8_t *q = (uint8_t *)grow(quality_, n);
+    if (!q)
+      return false;
+    quality_ = q;
+    cap = n;
+    return true;
+  }
+
+  /**
+   * Append Point
+   * @return false if the point was not newer than the last one or
+   *         memory ran out
+   */
+  bool append(int32_t epoch, float value, uint8_t quality = 0) {
+    if (count > 0 && epoch <= times_[count - 1])
+      return false;
+    if (count == cap && !reserve(cap ? cap * 2 : 256))
+      return false;
+    times_[count] = epoch;
+    values_[count] = value;
+    quality_[count] = quality;
+    count++;
+    return true;
+  }
+
+  // Element access (no bounds checks, callers iterate 0..size()-1)
+  int32_t time(size_t i) const { return times_[i]; }
+  float value(size_t i) const { return values_[i]; }
+  uint8_t quality(size_t i) const { return quality_[i]; }
+
+  // Raw column access for tight loops (chart scaling, decimation)
+  const int32_t *times() const { return times_; }
+  const float *values() const { return values_; }
+  const uint8_t *qualities() const { return quality_; }
+
+  int32_t firstTime() const { return count ? times_[0] : 0; }
+  int32_t lastTime() const { return count ? times_[count - 1] : 0; }
+
+  Resolution resolution() const { return res; }
+  void setResolution(Resolution r) { res = r; }
+
+  // Content identity; unchanged by append()
+  uint32_t revision() const { return rev; }
+
+  // Bytes held by the columns (for diagnostics)
+  size_t memoryBytes() const {
+    return cap * (sizeof(int32_t) + sizeof(float) + sizeof(uint8_t));
+  }
+
+  /**
+   * Keep Newest Points
+   * Drops the oldest points so at most n remain (bounds merged history)
+   */
+  void keepLast(size_t n) {
+    if (count <= n)
+      return;
+    size_t drop = count - n;
+    memmove(times_, times_ + drop, n * sizeof(int32_t));
+    memmove(values_, values_ + drop, n * sizeof(float));
+    memmove(quality_, quality_ + drop, n);
+    count = n;
+    rev = next_revision();
+  }
+
+  /**
+   * Bulk Load Columns
+   * Replaces the contents with n points that the callback reads straight
+   * into the column arrays: read(int32_t *times, float *values,
+   * uint8_t *quality, size_t n) -> bool. Used by the flash cache.
+   *
+   * @return false if memory ran out, the callback failed or the loaded
+   *         timestamps are not strictly ascending (store is left empty)
+   */
+  template <typename ReadFn>
+  bool loadColumns(size_t n, Resolution r, ReadFn read) {
+    clear();
+    if (!reserve(n) || !read(times_, values_, quality_, n))
+      return false;
+    for (size_t i = 1; i < n; i++) {
+      if (times_[i] <= times_[i - 1])
+        return false;
+    }
+    count = n;
+    res = r;
+    return true;
+  }
+
+  /**
+   * Exchange Contents
+   * O(1) pointer swap, used to hand a freshly filled store to the UI
+   */
+  void swap(SeriesStore &other) {
+    std::swap(times_, other.times_);
+    std::swap(values_, other.values_);
+    std::swap(quality_, other.quality_);
+    std::swap(count, other.count);
+    std::swap(cap, other.cap);
+    std::swap(res, other.res);
+    std::swap(rev, other.rev);
+  }
+
+  /**
+   * Format Date of Point i
+   * "YYYY-MM-DD" (or "YYYY-MM" for monthly series), UTC
+   */
+  void formatDate(size_t i, char *buf, size_t len) const {
+    struct tm tmres;
+    to_tm(i, tmres);
+    if (res == RES_MONTHLY)
+      snprintf(buf, len, "%04d-%02d", tmres.tm_year + 1900, tmres.tm_mon + 1);
+    else
+      snprintf(buf, len, "%04d-%02d-%02d", tmres.tm_year + 1900,
+               tmres.tm_mon + 1, tmres.tm_mday);
+  }
+
+  /**
+   * Format Time of Point i
+   * "HH:MM", UTC
+   */
+  void formatTime(size_t i, char *buf, size_t len) const {
+    struct tm tmres;
+    to_tm(i, tmres);
+    snprintf(buf, len, "%02d:%02d", tmres.tm_hour, tmres.tm_min);
+  }
+
+  /**
+   * Format Short X-axis Label of Point i
+   * MM/DD for hourly and daily data, MM/YY for monthly data
+   */
+  void formatTickLabel(size_t i, char *buf, size_t len) const {
+    struct tm tmres;
+    to_tm(i, tmres);
+    if (res == RES_MONTHLY)
+      snprintf(buf, len, "%02d/%02d", tmres.tm_mon + 1,
+               (tmres.tm_year + 1900) % 100);
+    else
+      snprintf(buf, len, "%02d/%02d", tmres.tm_mon + 1, tmres.tm_mday);
+  }
+
+private:
+  int32_t *times_ = nullptr;
+  float *values_ = nullptr;
+  uint8_t *quality_ = nullptr;
+  size_t count = 0;
+  size_t cap = 0;
+  Resolution res = RES_SUBDAILY;
+  uint32_t rev;
+
+  // Unique across all stores (the worker fills one while the UI reads
+  // another)
+  static uint32_t next_revision() {
+    static std::atomic<uint32_t> counter(0);
+    return ++counter;
+  }
+
+  // Prefer PSRAM, fall back to the internal heap
+  static void *grow(void *p, size_t bytes) {
+    void *n = ps_realloc(p, bytes);
+    return n ? n : realloc(p, bytes);
+  }
+
+  void release() {
+    free(times_);
+    free(values_);
+    free(quality_);
+    times_ = nullptr;
+    values_ = nullptr;
+    quality_ = nullptr;
+    count = cap = 0;
+  }
+
+  void to_tm(size_t i, struct tm &out) const {
+    time_t t = (time_t)times_[i];
+#if defined(ESP32)
+    gmtime_r(&t, &out);
+#else
+    out = *gmtime(&t);
+#endif
+  }
+};
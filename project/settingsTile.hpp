@@ -6,21 +6,26 @@
  * - City search with fuzzy matching (handles Swedish characters)
  * - Dynamic station validation (checks if station has data)
  * - Parameter discovery (finds which weather parameters each station provides)
- * - Intelligent caching to minimize API calls
+ * - Intelligent caching to minimize API calls, kept across reboots
  * - Save/load preferences for default city and parameter
  *
  * Complex algorithms:
- * - UTF-8 diacritic folding for Swedish city name search
+ * - Folded-name search index for city and station lookup (searchIndex.hpp)
  * - Multi-step station selection with fallback
  * - Streaming parameter validation
  */
 
 #pragma once
+#include "fetchWorker.hpp"
+#include "httpsPool.hpp"
+#include "paramIndex.hpp"
+#include "searchIndex.hpp"
 #include "smhiApi.hpp"
+#include "stationCache.hpp"
 #include "stationPicker.hpp"
-#include <HTTPClient.h>
+#include "stationProbe.hpp"
+#include "virtualList.hpp"
 #include <Preferences.h>
-#include <WiFiClientSecure.h>
 #include <algorithm>
 #include <lvgl.h>
 #include <map>
@@ -28,9 +33,7 @@
 #include <vector>
 
 // External references (defined in project.ino)
-extern lv_obj_t *t4;     // Settings tile container
-extern SMHI_API weather; // Weather API instance
-extern void SevenDayForecast_OnStationSelected(int station_idx);
+extern lv_obj_t *t4; // Settings tile container
 
 // ==================================================================
 // UI Component References
@@ -43,11 +46,15 @@ static lv_obj_t *param_dropdown = NULL;      // Parameter selection dropdown
 static lv_obj_t *param_loading_label = NULL; // "Checking parameters..." label
 static lv_obj_t *save_btn_label = NULL;      // "Set Default" button label
 static lv_timer_t *save_reset_timer = NULL;  // Timer to reset "Saved!" text
+static VirtualList search_list;              // Search results under the box
+static lv_timer_t *search_timer = NULL;      // Pending search (one per frame)
 
 // ==================================================================
 // Application State
 // ==================================================================
 static int current_station_idx = -1; // Currently selected station index
+static String current_city_name;      // City shown in the dropdown
+static int current_param_code = 1;    // Parameter shown in the dropdown
 
 // Legacy station validity map (currently unused but kept for compatibility)
 static std::map<String, bool> stationValidity;
@@ -65,6 +72,11 @@ static std::map<String, std::vector<int>> g_param_cache;
 // Negative cache: stations known to have NO data (avoids retrying)
 static std::map<String, bool> g_station_no_data_cache;
 
+// Station waiting for the parameter index (g_param_index) to finish, and
+// the parameter code to select once its real list is known
+static String g_param_pending_station;
+static int g_param_pending_code = 1;
+
 // ==================================================================
 // SMHI Parameter Definitions
 // All 39 tested and working parameter codes and their display names
@@ -116,72 +128,84 @@ static const char *PARAM_NAMES[] = {"Temperature (1h)",
                                     "Ground State"};
 
 // ==================================================================
-// Search Index
-// Folded (normalized) station names for fast case-insensitive search
+// Persistent Caches
+// Both caches are mirrored in g_station_cache (stationCache.hpp) and
+// restored at boot, so known stations open without a single probe. The
+// fetch worker writes the file a few seconds after the first change.
 // ==================================================================
-static bool g_index_built = false;
-static std::vector<String> g_station_names_folded;
+static const uint32_t STATION_CACHE_SAVE_DELAY_MS = 5000;
+static lv_timer_t *g_station_cache_timer = nullptr;
 
-// UI Constants
-static const int DROPDOWN_WIDTH = 300;
+static void station_cache_save_cb(lv_timer_t *t) {
+  (void)t;
+  g_station_cache_timer = nullptr; // One-shot, LVGL deletes it
+  fetch_worker_request_station_cache_save();
+}
 
-// ==================================================================
-// UTF-8 Diacritic Folding for Swedish Text
-// Normalizes Swedish characters (å,ä,ö,é,è,æ) to ASCII equivalents
-// Enables fuzzy search: "Goteborg" matches "Göteborg", etc.
-// ==================================================================
-static String fold_sv_ascii_lower(const String &s) {
-  String out;
-  out.reserve(s.length());
-  for (unsigned i = 0; i < s.length(); ++i) {
-    unsigned char c = (unsigned char)s[i];
-    if (c == 0xC3 && i + 1 < s.length()) {
-      unsigned char d = (unsigned char)s[i + 1];
-      if (d == 0xA5 || d == 0x85) {
-        out += 'a';
-        ++i;
-        continue;
-      }
-      if (d == 0xA4 || d == 0x84) {
-        out += 'a';
-        ++i;
-        continue;
-      }
-      if (d == 0xB6 || d == 0x96) {
-        out += 'o';
-        ++i;
-        continue;
-      }
-      if (d == 0xA9 || d == 0x89) {
-        out += 'e';
-        ++i;
-        continue;
-      }
-      if (d == 0xA8 || d == 0x88) {
-        out += 'e';
-        ++i;
-        continue;
-      }
-      if (d == 0xB8 || d == 0x98) {
-        out += 'o';
-        ++i;
-        continue;
-      }
-      if (d == 0xA6 || d == 0x86) {
-        out += "ae";
-        ++i;
-        continue;
-      }
-    }
-    out += (char)tolower(c);
+// Coalesces the changes of a selection into one write
+static void station_cache_changed() {
+  if (g_station_cache_timer)
+    return;
+  g_station_cache_timer =
+      lv_timer_create(station_cache_save_cb, STATION_CACHE_SAVE_DELAY_MS, NULL);
+  lv_timer_set_repeat_count(g_station_cache_timer, 1);
+}
+
+static void param_indices_from_mask(uint64_t mask, std::vector<int> &out) {
+  out.clear();
+  for (int idx = 0; idx < PARAM_COUNT; idx++) {
+    if ((mask >> idx) & 1)
+      out.push_back(idx);
   }
-  return out;
 }
 
-static bool contains_folded(const String &hay, const String &needle) {
-  return fold_sv_ascii_lower(hay).indexOf(fold_sv_ascii_lower(needle)) >= 0;
+static uint64_t param_mask_from_indices(const std::vector<int> &indices) {
+  uint64_t mask = 0;
+  for (int idx : indices)
+    mask |= 1ULL << idx;
+  return mask;
+}
+
+static void remember_station_params(const String &stationId,
+                                    const std::vector<int> &indices) {
+  g_param_cache[stationId] = indices;
+  g_station_cache.putParams(stationId, param_mask_from_indices(indices));
+  station_cache_changed();
 }
 
+static void remember_station_no_data(const String &stationId) {
+  g_station_no_data_cache[stationId] = true;
+  g_station_cache.putNoData(stationId);
+  station_cache_changed();
+}
+
+/**
+ * Restore Station Caches
+ * Call from setup() after series_cache_begin()
+ */
+static void settings_load_station_cache() {
+  g_station_cache.load();
+  for (size_t i = 0; i < g_station_cache.size(); i++) {
+    const StationCacheEntry &e = g_station_cache[i];
+    String stationId((unsigned long)e.id);
+    if (e.mask)
+      param_indices_from_mask(e.mask, g_param_cache[stationId]);
+    else
+      g_station_no_data_cache[stationId] = true;
+  }
+}
+
+// ==================================================================
+// Search Indexes
+// Folded (normalized) city and station names for fast case-insensitive
+// search, built once the station list is loaded
+// ==================================================================
+static FoldedNameIndex g_city_index;    // TOP_100_CITIES, same order
+static FoldedNameIndex g_station_index; // gStations, same order
+
+// UI Constants
+static const int DROPDOWN_WIDTH = 300;
+
 // ==================================================================
 // City Alias System
 // Maps English/ASCII city names to Swedish variants for search
@@ -218,8 +242,9 @@ static std::map<String, std::vector<String>> g_city_alias = {
 
 static std::vector<String> city_search_terms(const String &englishCity) {
   std::vector<String> terms;
-  String key = fold_sv_ascii_lower(englishCity);
-  auto it = g_city_alias.find(key);
+  char key[SEARCH_FOLD_MAX];
+  fold_sv_ascii_lower(englishCity.c_str(), key, sizeof(key));
+  auto it = g_city_alias.find(String(key));
   if (it != g_city_alias.end()) {
     for (const auto &t : it->second)
       terms.push_back(t);
@@ -228,50 +253,46 @@ static std::vector<String> city_search_terms(const String &englishCity) {
   return terms;
 }
 
-// =================================================================="Normalized
-// Station Name Index Pre-computes lowercased, diacritic-folded station names
-// Built once on first use for fast fuzzy searching
 // ==================================================================
-static void build_station_index_once() {
-  if (g_index_built)
-    return;
-  g_station_names_folded.clear();
-  g_station_names_folded.reserve(gStations.size());
-  for (size_t i = 0; i < gStations.size(); ++i) {
-    g_station_names_folded.push_back(fold_sv_ascii_lower(gStations[i].name));
-  }
-  g_index_built = true;
+// Search Index Construction
+// The city index is built on first use; the station index once gStations
+// is loaded (its ids are gStations indices)
+// ==================================================================
+static void build_search_indexes_once() {
+  if (!g_city_index.built())
+    g_city_index.build(TOP_100_COUNT,
+                       [](size_t i) { return TOP_100_CITIES[i]; });
+  if (!g_station_index.built() && !gStations.empty())
+    g_station_index.build(gStations.size(),
+                          [](size_t i) { return gStations[i].name; });
 }
 
 // ==================================================================
 // City Name Extraction from Station Name
 // Attempts to match station name to TOP_100_CITIES list
-// Uses multiple strategies: exact match, prefix match, contains
+// Uses multiple strategies: exact match, prefix match, contains; the
+// first city in list order wins within each
 // ==================================================================
-static String find_city_name_for_station(const String &stationName) {
-  String foldedStation = fold_sv_ascii_lower(stationName);
-
-  for (size_t i = 0; i < TOP_100_COUNT; ++i) {
-    String cityFolded = fold_sv_ascii_lower(String(TOP_100_CITIES[i]));
-    if (foldedStation == cityFolded) {
-      return String(TOP_100_CITIES[i]);
-    }
-  }
-
-  for (size_t i = 0; i < TOP_100_COUNT; ++i) {
-    String cityFolded = fold_sv_ascii_lower(String(TOP_100_CITIES[i]));
-    if (foldedStation.startsWith(cityFolded)) {
-      return String(TOP_100_CITIES[i]);
-    }
-  }
-
-  for (size_t i = 0; i < TOP_100_COUNT; ++i) {
-    String cityFolded = fold_sv_ascii_lower(String(TOP_100_CITIES[i]));
-    if (foldedStation.indexOf(cityFolded) >= 0) {
-      return String(TOP_100_CITIES[i]);
-    }
-  }
-
+static String find_city_name_for_station(const char *stationName) {
+  build_search_indexes_once();
+  char folded[SEARCH_FOLD_MAX];
+  fold_sv_ascii_lower(stationName, folded, sizeof(folded));
+
+  int exact = g_city_index.find(folded);
+  if (exact >= 0)
+    return String(TOP_100_CITIES[exact]);
+
+  // Cities occurring in the station name, via the index's trigrams
+  size_t prefix = TOP_100_COUNT, contains = TOP_100_COUNT;
+  g_city_index.forEachContainedIn(folded, [&](uint16_t id, size_t pos) {
+    if (pos == 0)
+      prefix = std::min(prefix, (size_t)id);
+    contains = std::min(contains, (size_t)id);
+  });
+  if (prefix < TOP_100_COUNT)
+    return String(TOP_100_CITIES[prefix]);
+  if (contains < TOP_100_COUNT)
+    return String(TOP_100_CITIES[contains]);
   return "";
 }
 
@@ -297,6 +318,7 @@ static void select_city_in_dropdown(const String &cityName) {
 // Build dropdown options
 // ------------------------------------------------------------------
 static void settings_update_city_options() {
+  build_search_indexes_once(); // Stations are loaded by now (loop())
   if (!city_dropdown)
     return;
 
@@ -311,68 +333,45 @@ static void settings_update_city_options() {
 }
 
 // ------------------------------------------------------------------
-// Filter dropdown
+// Find gStations index for a station id (-1 if unknown)
 // ------------------------------------------------------------------
-static void filter_city_dropdown(const char *filter) {
-  if (!city_dropdown)
-    return;
-  String f = filter ? filter : "";
-  std::string out;
-  for (size_t i = 0; i < TOP_100_COUNT; ++i) {
-    String city = TOP_100_CITIES[i];
-    if (f.isEmpty() || contains_folded(city, f)) {
-      out += city.c_str();
-      out += "\n";
-    }
-  }
-  if (out.empty())
-    out = "No match\n";
-  lv_dropdown_clear_options(city_dropdown);
-  lv_dropdown_set_options(city_dropdown, out.c_str());
+static int station_index_of(const String &stationId) {
+  return gStations.indexOf(stationId.c_str());
 }
 
 // ------------------------------------------------------------------
-// Check if station has actual data for parameter 1
-// Returns true if HTTP 200 and data exists
+// What is known without a request about parameter 1 data of a station
+// Returns 1 (has data), 0 (no data) or -1 (unknown, needs a probe)
 // ------------------------------------------------------------------
-static bool station_has_param1_data(const String &stationId) {
-  // Check negative cache first
+static int station_param1_known(const String &stationId) {
   auto neg_it = g_station_no_data_cache.find(stationId);
-  if (neg_it != g_station_no_data_cache.end()) {
-    Serial.printf("  Station %s known to have no data (cached)\n",
-                  stationId.c_str());
-    return false;
-  }
 
-  WiFiClientSecure client;
-  client.setInsecure();
-  client.setTimeout(5000);
-  HTTPClient http;
-
-  String url = "https://opendata-download-metobs.smhi.se/api/version/1.0/"
-               "parameter/1/station/";
-  url += stationId;
-  url += "/period/latest-months/data.json";
-
-  Serial.printf("  Checking param 1 data: %s\n", url.c_str());
-
-  if (!http.begin(client, url)) {
-    Serial.println("  HTTP begin failed");
-    return false;
+  // Metadata index (build-time table or live): bit 0 = parameter 1. It is
+  // authoritative, so it goes first and overrides a cached probe answer
+  if (g_param_index.ready()) {
+    int idx = station_index_of(stationId);
+    bool has = g_param_index.has(idx, 0);
+    int32_t from, to;
+    if (!has && g_param_index.activeRange(idx, from, to))
+      Serial.printf("  Station %s inactive (data %ld..%ld)\n",
+                    stationId.c_str(), (long)from, (long)to);
+    if (has && neg_it != g_station_no_data_cache.end()) {
+      Serial.printf("  Station %s has data again, dropping cached no-data\n",
+                    stationId.c_str());
+      g_station_no_data_cache.erase(neg_it);
+      g_station_cache.forget(stationId);
+      station_cache_changed();
+    }
+    return has ? 1 : 0;
   }
 
-  int code = http.GET();
-  http.end();
-
-  Serial.printf("  HTTP response: %d\n", code);
-
-  if (code != 200) {
-    // Cache this station as having no data
-    g_station_no_data_cache[stationId] = true;
-    return false;
+  // Then the negative cache (probe answers from this boot or the last day)
+  if (neg_it != g_station_no_data_cache.end()) {
+    Serial.printf("  Station %s known to have no data (cached)\n",
+                  stationId.c_str());
+    return 0;
   }
-
-  return true;
+  return -1;
 }
 
 // ==================================================================
@@ -381,21 +380,16 @@ static bool station_has_param1_data(const String &stationId) {
 // Makes HTTP request to SMHI API metadata endpoint
 // ==================================================================
 static bool check_param_available(const String &stationId, int paramCode) {
-  WiFiClientSecure client;
-  client.setInsecure();
-  client.setTimeout(5000);
-  HTTPClient http;
-
-  String url ="https://opendata-download-metobs.smhi.se/api/version/1.0/parameter/";
+  String url = "/api/version/1.0/parameter/";
   url += String(paramCode);
   url += "/station/";
   url += stationId;
   url += "/";
 
-  if (!http.begin(client, url))
-    return false;
-  int code = http.GET();
-  http.end();
+  // Small metadata body: drain it so the next probe reuses the connection
+  HttpsRequest req(g_metobs_host);
+  int code = req.get(url, 5000);
+  req.discardBody();
 
   return (code >= 200 && code < 400);
 }
@@ -423,9 +417,11 @@ static void update_param_dropdown_from_indices() {
 
 // ==================================================================
 // Parameter Discovery
-// Scans all 39 parameters to find which ones are available
-// Priority parameters (Wind, Precip, Humidity) are checked first
-// Results are cached to avoid repeated API calls
+// Normally a single lookup in the station/parameter metadata index
+// (paramIndex.hpp). While the index is still downloading, parameter 1
+// is offered and the list is filled in by settings_poll_param_index().
+// If the index could not be built, falls back to scanning all 39
+// parameters (Wind, Precip, Humidity first). Results are cached.
 // ==================================================================
 static void fetch_available_parameters(const String &stationId) {
   // Check cache first
@@ -442,7 +438,32 @@ static void fetch_available_parameters(const String &stationId) {
     return;
   }
 
-  // Not in cache, fetch from API
+  if (g_param_index.ready()) {
+    uint64_t mask = g_param_index.mask(station_index_of(stationId));
+    param_indices_from_mask(mask, g_available_param_indices);
+    remember_station_params(stationId, g_available_param_indices);
+    Serial.printf("Parameters for station %s from index: %d\n",
+                  stationId.c_str(), (int)g_available_param_indices.size());
+    update_param_dropdown_from_indices();
+    if (param_loading_label)
+      lv_obj_add_flag(param_loading_label, LV_OBJ_FLAG_HIDDEN);
+    return;
+  }
+
+  if (!g_param_index.failed()) {
+    // Index still downloading: param 1 for now, the rest when it lands
+    g_available_param_indices.assign(1, 0);
+    update_param_dropdown_from_indices();
+    g_param_pending_station = stationId;
+    g_param_pending_code = 1;
+    if (param_loading_label) {
+      lv_label_set_text(param_loading_label, "Finding parameters...");
+      lv_obj_clear_flag(param_loading_label, LV_OBJ_FLAG_HIDDEN);
+    }
+    return;
+  }
+
+  // No index, probe the API parameter by parameter
   g_available_param_indices.clear();
 
   // Parameter 1 is already confirmed to work, add it first
@@ -511,7 +532,7 @@ static void fetch_available_parameters(const String &stationId) {
   std::sort(g_available_param_indices.begin(), g_available_param_indices.end());
 
   // Store in cache
-  g_param_cache[stationId] = g_available_param_indices;
+  remember_station_params(stationId, g_available_param_indices);
   Serial.printf("Cached %d parameters for station %s\n",
                 (int)g_available_param_indices.size(), stationId.c_str());
 
@@ -548,6 +569,122 @@ static int find_dropdown_idx_for_code(int param_code) {
   return 0;
 }
 
+// ==================================================================
+// City and Station Search
+// Matching cities (population order), then stations (by name), in a
+// virtual list under the search box. Edits are coalesced into one search
+// per display refresh, and typing on only narrows the previous results
+// instead of querying the indexes again.
+// ==================================================================
+static const lv_coord_t SEARCH_LIST_Y = 58;
+static const lv_coord_t SEARCH_ROW_HEIGHT = 30;
+
+// Result ids: TOP_100_CITIES index, or TOP_100_COUNT + gStations index
+static std::vector<uint16_t> g_search_hits;
+static char g_search_query[SEARCH_FOLD_MAX]; // Folded query behind the hits
+static bool g_search_had_stations = false;   // Station index was built then
+
+static void close_keyboard();
+static void city_chosen(const String &city);
+static void station_chosen(int idx);
+
+static const char *search_hit_folded(uint16_t id) {
+  return id < TOP_100_COUNT ? g_city_index.name(id)
+                            : g_station_index.name(id - TOP_100_COUNT);
+}
+
+static const char *search_row_text(uint32_t row, char *buf, size_t cap,
+                                   bool &secondary) {
+  uint16_t id = g_search_hits[row];
+  if (id < TOP_100_COUNT)
+    return TOP_100_CITIES[id];
+  // Stations in grey under the cities, ASCII-friendly like the city names
+  secondary = true;
+  fold_sv_ascii(gStations[id - TOP_100_COUNT].name, buf, cap, false);
+  return buf;
+}
+
+static void run_search(const char *text) {
+  unsigned long start = micros();
+  build_search_indexes_once();
+  char folded[SEARCH_FOLD_MAX];
+  size_t len = fold_sv_ascii_lower(text ? text : "", folded, sizeof(folded));
+
+  if (len == 0) {
+    g_search_hits.clear();
+    g_search_query[0] = '\0';
+    search_list.setCount(0);
+    lv_obj_add_flag(search_list.obj(), LV_OBJ_FLAG_HIDDEN);
+    return;
+  }
+
+  // Whatever contains the longer query contains the previous one
+  size_t prev = strlen(g_search_query);
+  bool narrow = prev > 0 && strncmp(folded, g_search_query, prev) == 0 &&
+                g_search_had_stations == g_station_index.built();
+  if (narrow) {
+    g_search_hits.erase(std::remove_if(g_search_hits.begin(),
+                                       g_search_hits.end(),
+                                       [&](uint16_t id) {
+                                         return !strstr(search_hit_folded(id),
+                                                        folded);
+                                       }),
+                        g_search_hits.end());
+  } else {
+    g_search_hits.clear();
+    g_city_index.forEachContaining(
+        folded, [](uint16_t id) { g_search_hits.push_back(id); });
+    g_station_index.forEachContaining(folded, [](uint16_t id) {
+      g_search_hits.push_back((uint16_t)(TOP_100_COUNT + id));
+    });
+    g_search_had_stations = g_station_index.built();
+  }
+  memcpy(g_search_query, folded, len + 1);
+
+  search_list.setCount(g_search_hits.size());
+  lv_obj_clear_flag(search_list.obj(), LV_OBJ_FLAG_HIDDEN);
+  Serial.printf("Search \"%s\": %u results (%s) in %lu us\n", folded,
+                (unsigned)g_search_hits.size(),
+                narrow ? "narrowed" : "indexed", micros() - start);
+}
+
+static void search_row_clicked(uint32_t row) {
+  uint16_t id = g_search_hits[row];
+  lv_textarea_set_text(search_box, "");
+  run_search("");
+  close_keyboard();
+  if (id < TOP_100_COUNT) {
+    select_city_in_dropdown(TOP_100_CITIES[id]);
+    city_chosen(TOP_100_CITIES[id]);
+  } else {
+    station_chosen(id - TOP_100_COUNT);
+  }
+}
+
+static void search_timer_cb(lv_timer_t *t) {
+  (void)t;
+  search_timer = NULL; // One-shot: LVGL deletes it after this call
+  run_search(lv_textarea_get_text(search_box));
+}
+
+// Search box edited: search once at the next refresh, with whatever the
+// box holds by then
+static void schedule_search() {
+  if (search_timer)
+    return;
+  search_timer =
+      lv_timer_create(search_timer_cb, LV_DISP_DEF_REFR_PERIOD, NULL);
+  lv_timer_set_repeat_count(search_timer, 1);
+}
+
+// Results fill the space down to the keyboard, or to the bottom
+static void search_list_layout() {
+  lv_coord_t bottom = lv_disp_get_ver_res(NULL);
+  if (kb)
+    bottom -= lv_disp_get_ver_res(NULL) / 2;
+  search_list.setHeight(bottom - SEARCH_LIST_Y - 4);
+}
+
 // ------------------------------------------------------------------
 // Keyboard helpers
 // ------------------------------------------------------------------
@@ -555,6 +692,7 @@ static void close_keyboard() {
   if (kb) {
     lv_obj_del(kb);
     kb = NULL;
+    search_list_layout();
   }
 }
 
@@ -573,11 +711,11 @@ static void ta_event_cb(lv_event_t *e) {
     lv_obj_add_flag(kb, LV_OBJ_FLAG_SCROLL_CHAIN_HOR);
     lv_obj_set_size(kb, lv_disp_get_hor_res(NULL),lv_disp_get_ver_res(NULL) / 2);
     lv_obj_add_event_cb(kb, kb_event_cb, LV_EVENT_ALL, NULL);
+    search_list_layout();
   } else if (code == LV_EVENT_DEFOCUSED) {
     close_keyboard();
   } else if (code == LV_EVENT_VALUE_CHANGED) {
-    const char *txt = lv_textarea_get_text(search_box);
-    filter_city_dropdown(txt);
+    schedule_search();
   }
 }
 
@@ -585,63 +723,115 @@ static void ta_event_cb(lv_event_t *e) {
 // Find city candidates
 // ------------------------------------------------------------------
 static void find_city_candidates(const String &englishCity,std::vector<int> &out) {
-  build_station_index_once();
+  build_search_indexes_once();
   out.clear();
   auto terms = city_search_terms(englishCity);
 
-  std::vector<String> folded_terms;
-  folded_terms.reserve(terms.size());
-  for (const auto &t : terms)
-    folded_terms.push_back(fold_sv_ascii_lower(t));
-
-  for (int i = 0; i < (int)gStations.size(); ++i) {
-    const String &foldedName = g_station_names_folded[(size_t)i];
-    for (const auto &ft : folded_terms) {
-      if (foldedName.indexOf(ft) >= 0) {
-        out.push_back(i);
-        break;
-      }
-    }
+  // Aliases mostly fold to the same text; look each distinct one up once
+  char folded_terms[4][SEARCH_FOLD_MAX];
+  size_t term_count = 0;
+  for (const auto &t : terms) {
+    if (term_count == 4)
+      break;
+    char *ft = folded_terms[term_count];
+    fold_sv_ascii_lower(t.c_str(), ft, SEARCH_FOLD_MAX);
+    bool seen = false;
+    for (size_t k = 0; k < term_count && !seen; k++)
+      seen = strcmp(folded_terms[k], ft) == 0;
+    if (!seen)
+      term_count++;
   }
 
+  for (size_t k = 0; k < term_count; k++)
+    g_station_index.forEachContaining(
+        folded_terms[k], [&](uint16_t id) { out.push_back(id); });
+  std::sort(out.begin(), out.end());
+  out.erase(std::unique(out.begin(), out.end()), out.end());
+
+  auto starts_with_term = [&](const char *name) {
+    for (size_t k = 0; k < term_count; k++)
+      if (strncmp(name, folded_terms[k], strlen(folded_terms[k])) == 0)
+        return true;
+    return false;
+  };
   std::stable_sort(out.begin(), out.end(), [&](int a, int b) {
-    const String &na = g_station_names_folded[(size_t)a];
-    const String &nb = g_station_names_folded[(size_t)b];
-    bool ast = false, bst = false;
-    for (const auto &ft : folded_terms) {
-      if (!ast && na.startsWith(ft))
-        ast = true;
-      if (!bst && nb.startsWith(ft))
-        bst = true;
-    }
+    const char *na = g_station_index.name((size_t)a);
+    const char *nb = g_station_index.name((size_t)b);
+    bool ast = starts_with_term(na), bst = starts_with_term(nb);
     if (ast != bst)
       return ast;
-    return na.length() < nb.length();
+    return strlen(na) < strlen(nb);
   });
 }
 
+// ------------------------------------------------------------------
+// Nearest stations with data
+// With the parameter index ready, replaces the name candidates with the
+// stations closest to the best name match that are active for parameter
+// 1, nearest first (the match itself first if it is active), so the
+// candidate loop below needs no probing at all
+// ------------------------------------------------------------------
+static const size_t NEAREST_CANDIDATES = 8;
+static const float NEAREST_RADIUS_KM = 50.0f;
+
+static void rank_candidates_by_distance(std::vector<int> &cand) {
+  if (cand.empty() || !g_param_index.ready())
+    return;
+  unsigned long start = micros();
+  int anchor = cand[0];
+  StationHit hits[NEAREST_CANDIDATES];
+  size_t n = stations_within(
+      STATIONS[anchor].lat, STATIONS[anchor].lon, NEAREST_RADIUS_KM, hits,
+      NEAREST_CANDIDATES, [](int idx) { return g_param_index.has(idx, 0); });
+  if (n == 0)
+    return; // Nothing active nearby: keep probing the name matches
+
+  cand.clear();
+  for (size_t i = 0; i < n; i++) {
+    if (hits[i].idx == anchor)
+      cand.insert(cand.begin(), anchor);
+    else
+      cand.push_back(hits[i].idx);
+  }
+  Serial.printf("%u active stations within %.0f km of %s (farthest "
+                "%.1f km) in %lu us\n",
+                (unsigned)n, NEAREST_RADIUS_KM, gStations[anchor].name,
+                hits[n - 1].km, micros() - start);
+}
+
 // ==================================================================
 // Multi-Step Station Selection Algorithm
 // Complex flow that ensures selected station actually has data:
 //
 // 1. Check positive cache (station with known parameters) -> instant
-// 2. Check negative cache (station known to have no data) -> skip
-// 3. Validate param 1 data availability (quick HTTP check)
+// 2. Check negative cache / parameter index (known to have no data) -> skip
+// 3. Validate param 1 data availability: the next candidates whose status
+//    is unknown are probed in parallel (stationProbe.hpp), and the
+//    best-ranked one that answers with data wins
 // 4. If param 1 works, scan all parameters (caches result)
 // 5. If param 1 fails, try next candidate station
 //
 // This approach minimizes failed selections and API calls
 // ==================================================================
+static int use_station_with_params(int idx, const String &cityKey) {
+  stationValidity[cityKey] = true;
+  fetch_worker_request_forecast(idx);
+  current_station_idx = idx;
+  return idx;
+}
+
 static int ensure_station_has_data_from_candidates(const std::vector<int> &cand,
                                                    const String &cityKey) {
   Serial.printf("Trying %d candidate stations for %s\n", (int)cand.size(),
                 cityKey.c_str());
 
-  for (int idx : cand) {
-    const String &stationId = gStations[(size_t)idx].id;
-    const String &stationName = gStations[(size_t)idx].name;
+  size_t pos = 0;
+  while (pos < cand.size()) {
+    int idx = cand[pos];
+    const String stationId(gStations[(size_t)idx].id);
+    const char *stationName = gStations[(size_t)idx].name;
 
-    Serial.printf("Trying station: %s (ID %s)\n", stationName.c_str(),stationId.c_str());
+    Serial.printf("Trying station: %s (ID %s)\n", stationName,stationId.c_str());
 
     // 1. Check if we have cached params for this station
     auto cache_it = g_param_cache.find(stationId);
@@ -649,38 +839,64 @@ static int ensure_station_has_data_from_candidates(const std::vector<int> &cand,
       Serial.printf("  Using cached data (%d params)\n",(int)cache_it->second.size());
       g_available_param_indices = cache_it->second;
       update_param_dropdown_from_indices();
-      stationValidity[cityKey] = true;
-      SevenDayForecast_OnStationSelected(idx);
-      current_station_idx = idx;
-      return idx;
+      return use_station_with_params(idx, cityKey);
     }
 
-    // 2. Check if station is in negative cache (known to have no data)
-    auto neg_it = g_station_no_data_cache.find(stationId);
-    if (neg_it != g_station_no_data_cache.end()) {
+    // 2. Negative cache or parameter index
+    int known = station_param1_known(stationId);
+    if (known == 0) {
       Serial.printf("  Skipping - known to have no data\n");
+      pos++;
       continue;
     }
 
-    // 3. Check if parameter 1 has actual data
-    if (!station_has_param1_data(stationId)) {
-      Serial.printf("  No param 1 data, trying next station\n");
-      continue;
+    // 3. Unknown: probe it together with the next unknown candidates, up
+    // to one with cached parameters (that one would win without a request)
+    if (known < 0) {
+      const char *ids[PROBE_MAX];
+      size_t window[PROBE_MAX];
+      int n = 0;
+      for (size_t k = pos; k < cand.size() && n < PROBE_MAX; k++) {
+        const char *id = gStations[(size_t)cand[k]].id;
+        auto c = g_param_cache.find(String(id));
+        if (c != g_param_cache.end() && !c->second.empty())
+          break;
+        if (k > pos && station_param1_known(String(id)) == 0)
+          continue;
+        ids[n] = id;
+        window[n++] = k;
+      }
+
+      uint8_t results[PROBE_MAX];
+      int found = g_station_probes.run(ids, n, results);
+      // Only a real "no data" answer is remembered; a failed request says
+      // nothing about the station and is simply skipped this time
+      for (int i = 0; i < n; i++)
+        if (results[i] == PROBE_NO_DATA)
+          remember_station_no_data(String(ids[i]));
+      if (found < 0) {
+        Serial.printf("  No param 1 data in %d probed stations\n", n);
+        // Candidates left unanswered (deadline) are skipped, not retried
+        pos = window[n - 1] + 1;
+        continue;
+      }
+      pos = window[found];
+      idx = cand[pos];
     }
 
     // 4. Param 1 works! Now fetch all available parameters
-    Serial.printf("  Param 1 OK! Fetching all parameters...\n");
-    fetch_available_parameters(stationId);
+    const String okId(gStations[(size_t)idx].id);
+    Serial.printf("  Param 1 OK (%s)! Fetching all parameters...\n",
+                  okId.c_str());
+    fetch_available_parameters(okId);
 
     if (!g_available_param_indices.empty()) {
-      stationValidity[cityKey] = true;
       Serial.printf("SUCCESS: Using station %s (ID %s) with %d params\n",
-                    stationName.c_str(), stationId.c_str(),
+                    gStations[(size_t)idx].name, okId.c_str(),
                     (int)g_available_param_indices.size());
-      SevenDayForecast_OnStationSelected(idx);
-      current_station_idx = idx;
-      return idx;
+      return use_station_with_params(idx, cityKey);
     }
+    pos++;
   }
 
   Serial.printf("FAILED: No working station found for %s\n", cityKey.c_str());
@@ -688,35 +904,21 @@ static int ensure_station_has_data_from_candidates(const std::vector<int> &cand,
 }
 
 // ------------------------------------------------------------------
-// City selection changed
+// Use the first candidate station with data for the chosen city
 // ------------------------------------------------------------------
-static void city_selection_changed(lv_event_t *e) {
-  (void)e;
-  char buf[128];
-  buf[0] = '\0';
-  lv_dropdown_get_selected_str(city_dropdown, buf, sizeof(buf));
-  String city(buf);
-  if (city.isEmpty())
-    return;
-
-  Serial.printf("\n=== City selected: %s ===\n", buf);
-
-  std::vector<int> cand;
-  find_city_candidates(city, cand);
-  if (cand.empty()) {
-    Serial.printf("No station candidates found for %s\n", buf);
-    return;
-  }
-
+static void use_station_from_candidates(const std::vector<int> &cand,
+                                        const String &city) {
   int ok_idx = ensure_station_has_data_from_candidates(cand, city);
   if (ok_idx >= 0) {
     int param_code = g_available_param_indices.empty()
                          ? 1
                          : PARAM_CODES[g_available_param_indices[0]];
-    weather.update_weather_data(ok_idx, param_code, "latest-months");
+    fetch_worker_request_series(ok_idx, param_code);
     current_station_idx = ok_idx;
+    current_city_name = city;
+    current_param_code = param_code;
   } else {
-    Serial.printf("No working station found for %s\n", buf);
+    Serial.printf("No working station found for %s\n", city.c_str());
 
     // Update UI to show no data
     if (param_dropdown) {
@@ -726,6 +928,49 @@ static void city_selection_changed(lv_event_t *e) {
   }
 }
 
+// ------------------------------------------------------------------
+// City selection changed
+// ------------------------------------------------------------------
+static void city_chosen(const String &city) {
+  if (city.isEmpty())
+    return;
+
+  Serial.printf("\n=== City selected: %s ===\n", city.c_str());
+
+  std::vector<int> cand;
+  find_city_candidates(city, cand);
+  if (cand.empty()) {
+    Serial.printf("No station candidates found for %s\n", city.c_str());
+    return;
+  }
+  rank_candidates_by_distance(cand);
+  use_station_from_candidates(cand, city);
+}
+
+static void city_selection_changed(lv_event_t *e) {
+  (void)e;
+  char buf[128];
+  buf[0] = '\0';
+  lv_dropdown_get_selected_str(city_dropdown, buf, sizeof(buf));
+  city_chosen(String(buf));
+}
+
+// ------------------------------------------------------------------
+// Station picked from the search results
+// Uses that station only; the city shown is the one its name contains
+// ------------------------------------------------------------------
+static void station_chosen(int idx) {
+  const char *name = gStations[(size_t)idx].name;
+  Serial.printf("\n=== Station selected: %s ===\n", name);
+
+  String city = find_city_name_for_station(name);
+  if (city.isEmpty())
+    city = name;
+  else
+    select_city_in_dropdown(city);
+  use_station_from_candidates(std::vector<int>(1, idx), city);
+}
+
 // ------------------------------------------------------------------
 // Parameter selection changed
 // ------------------------------------------------------------------
@@ -744,7 +989,8 @@ static void param_selection_changed(lv_event_t *e) {
                   PARAM_NAMES[g_available_param_indices[dropdown_idx]]);
   }
 
-  weather.update_weather_data(current_station_idx, actual_param_code,"latest-months");
+  fetch_worker_request_series(current_station_idx, actual_param_code);
+  current_param_code = actual_param_code;
 }
 
 // ------------------------------------------------------------------
@@ -783,7 +1029,7 @@ static void save_btn_event_cb(lv_event_t *e) {
     prefs.putString("city_name", city_buf);
     prefs.end();
     Serial.printf("Settings saved: station=%s, param_code=%d, city=%s\n",
-                  gStations[current_station_idx].id.c_str(), actual_param_code,city_buf);
+                  gStations[current_station_idx].id, actual_param_code,city_buf);
 
     if (save_btn_label) {
       lv_label_set_text(save_btn_label, "Saved!");
@@ -816,12 +1062,9 @@ static void reset_btn_event_cb(lv_event_t *e) {
 
   int new_idx = 0;
   if (!st_id.isEmpty()) {
-    for (size_t i = 0; i < gStations.size(); ++i) {
-      if (gStations[i].id == st_id) {
-        new_idx = (int)i;
-        break;
-      }
-    }
+    int found = station_index_of(st_id);
+    if (found >= 0)
+      new_idx = found;
   }
 
   current_station_idx = new_idx;
@@ -835,14 +1078,15 @@ static void reset_btn_event_cb(lv_event_t *e) {
 
   if (new_idx >= 0 && new_idx < (int)gStations.size()) {
     fetch_available_parameters(gStations[new_idx].id);
+    g_param_pending_code = p_code;
 
     int dropdown_idx = find_dropdown_idx_for_code(p_code);
 
     if (param_dropdown)
       lv_dropdown_set_selected(param_dropdown, dropdown_idx);
 
-    weather.update_weather_data(new_idx, p_code, "latest-months");
-    SevenDayForecast_OnStationSelected(new_idx);
+    fetch_worker_request_series(new_idx, p_code);
+    fetch_worker_request_forecast(new_idx);
   }
 
   lv_obj_t *btn = lv_event_get_target(e);
@@ -856,26 +1100,29 @@ static void reset_btn_event_cb(lv_event_t *e) {
 static void clear_param_cache() {
   g_param_cache.clear();
   g_station_no_data_cache.clear();
+  g_station_cache.clear();
+  station_cache_changed();
   Serial.println("All caches cleared");
 }
 
 static void print_cache_stats() {
   Serial.printf("Parameter cache: %d stations\n", (int)g_param_cache.size());
   Serial.printf("No-data cache: %d stations\n",(int)g_station_no_data_cache.size());
+  Serial.printf("Stored on flash: %d stations\n", (int)g_station_cache.size());
 }
 
 // ==================================================================
 // Settings UI Creation
 // Builds the complete settings interface:
 // - Search box with on-screen keyboard
-// - City dropdown (filtered by search)
+// - City dropdown, and city/station search results over it
 // - Parameter dropdown (dynamically populated)
 // - Save/Reset buttons for preferences
 // ==================================================================
 static void create_settings_tile() {
   search_box = lv_textarea_create(t4);
   lv_textarea_set_one_line(search_box, true);
-  lv_textarea_set_placeholder_text(search_box, "Search city...");
+  lv_textarea_set_placeholder_text(search_box, "Search city or station...");
   lv_obj_set_size(search_box, DROPDOWN_WIDTH, 40);
   lv_obj_align(search_box, LV_ALIGN_TOP_MID, 0, 15);
   lv_obj_add_event_cb(search_box, ta_event_cb, LV_EVENT_ALL, NULL);
@@ -916,6 +1163,26 @@ static void create_settings_tile() {
   lv_obj_t *reset_label = lv_label_create(reset_btn);
   lv_label_set_text(reset_label, "Reset");
   lv_obj_center(reset_label);
+
+  // Created last so the results cover the controls below the search box
+  search_list.create(t4, DROPDOWN_WIDTH,
+                     lv_disp_get_ver_res(NULL) - SEARCH_LIST_Y - 4,
+                     SEARCH_ROW_HEIGHT, search_row_text, search_row_clicked);
+  lv_obj_align(search_list.obj(), LV_ALIGN_TOP_MID, 0, SEARCH_LIST_Y);
+  lv_obj_add_flag(search_list.obj(), LV_OBJ_FLAG_HIDDEN);
+
+  // The tile is built on first approach, usually after settings_sync_state()
+  // has already picked the city and parameter: show them
+  if (current_station_idx >= 0) {
+    select_city_in_dropdown(current_city_name);
+    update_param_dropdown_from_indices();
+    lv_dropdown_set_selected(param_dropdown,
+                             find_dropdown_idx_for_code(current_param_code));
+    if (!g_param_pending_station.isEmpty()) {
+      lv_label_set_text(param_loading_label, "Finding parameters...");
+      lv_obj_clear_flag(param_loading_label, LV_OBJ_FLAG_HIDDEN);
+    }
+  }
 }
 
 // ==================================================================
@@ -940,13 +1207,52 @@ static void settings_sync_state(int station_idx, int param_code,
   if (!cityToSelect.isEmpty()) {
     select_city_in_dropdown(cityToSelect);
   }
+  current_city_name = cityToSelect;
+  current_param_code = param_code;
 
   if (station_idx >= 0 && station_idx < (int)gStations.size()) {
     fetch_available_parameters(gStations[station_idx].id);
+    g_param_pending_code = param_code;
 
     int dropdown_idx = find_dropdown_idx_for_code(param_code);
 
     if (param_dropdown)
       lv_dropdown_set_selected(param_dropdown, dropdown_idx);
   }
-}
\ No newline at end of file
+}
+
+// ==================================================================
+// Parameter Index Completion
+// Called from loop(): publishes a finished live index build, then fills in
+// the parameter list of the station that was waiting for it
+// ==================================================================
+static void settings_poll_param_index() {
+  // Live metadata replaced the build-time table: lists derived from the
+  // old masks (or restored from flash) may be wrong now, refresh them
+  if (g_param_index.poll()) {
+    for (auto &kv : g_param_cache) {
+      uint64_t mask = g_param_index.mask(station_index_of(kv.first));
+      param_indices_from_mask(mask, kv.second);
+      g_station_cache.putParams(kv.first, mask);
+    }
+    station_cache_changed();
+  }
+
+  if (g_param_pending_station.isEmpty())
+    return;
+  if (!g_param_index.ready() && !g_param_index.failed())
+    return;
+
+  String stationId = g_param_pending_station;
+  g_param_pending_station = "";
+
+  // The user has moved on to another station in the meantime
+  if (current_station_idx < 0 || current_station_idx >= (int)gStations.size() ||
+      stationId != gStations[current_station_idx].id)
+    return;
+
+  fetch_available_parameters(stationId);
+  if (param_dropdown)
+    lv_dropdown_set_selected(param_dropdown,
+                             find_dropdown_idx_for_code(g_param_pending_code));
+}
@@ -1,83 +1,18 @@
 #pragma once
 #include <Arduino.h>
-#include <ArduinoJson.h>
-#include <HTTPClient.h>
-#include <WiFiClientSecure.h>
 #include <vector>
 
-#include "stations.hpp"
+#include "httpsPool.hpp"
+#include "jsonPull.hpp"
+#include "seriesCache.hpp"
+#include "seriesStore.hpp"
+#include "stationTable.hpp"
 
 // Global station list defined in project.ino
-extern std::vector<StationInfo> gStations;
-
-/**
- * Data Point Structure
- * Represents a single weather measurement with date, time, and value
- * Used for both historical observation data and forecast data
- */
-struct DataPoint {
-  String date; // YYYY-MM-DD or YYYY-MM format
-  String time; // HH:MM format
-  float temp;  // Temperature or other parameter value
-};
+extern StationTable gStations;
 
 // Global weather data storage (accessed from project.ino for chart rendering)
-extern std::vector<DataPoint> weatherData;
-
-/**
- * Convert epoch milliseconds to date and time strings
- * Applies timezone offset and formats as YYYY-MM-DD and HH:MM
- *
- * @param ms Epoch time in milliseconds
- * @param outDate Output date string
- * @param outTime Output time string
- * @param tz_offset_minutes Timezone offset in minutes (default 0 for UTC)
- */
-static inline void epoch_ms_to_date_time(uint64_t ms, String &outDate,
-                                         String &outTime,
-                                         int tz_offset_minutes = 0) {
-  int64_t sec = (int64_t)(ms / 1000) + (int64_t)tz_offset_minutes * 60;
-  time_t t = (time_t)sec;
-  struct tm tmres;
-#if defined(ESP32)
-  gmtime_r(&t, &tmres);
-#else
-  tmres = *gmtime(&t);
-#endif
-  char dBuf[11];
-  char tBuf[6];
-  snprintf(dBuf, sizeof(dBuf), "%04d-%02d-%02d", tmres.tm_year + 1900,
-           tmres.tm_mon + 1, tmres.tm_mday);
-  snprintf(tBuf, sizeof(tBuf), "%02d:%02d", tmres.tm_hour, tmres.tm_min);
-  outDate = dBuf;
-  outTime = tBuf;
-}
-
-/**
- * Safely Parse JSON Value to Float
- * Handles multiple JSON value types (string, int, float)
- * SMHI API sometimes returns numbers as strings, this handles all cases
- */
-static float parseValueToFloat(JsonVariant val) {
-  if (val.isNull()) {
-    return 0.0f;
-  }
-
-  if (val.is<const char *>()) {
-    return atof(val.as<const char *>());
-  }
-
-  if (val.is<float>()) {
-    return val.as<float>();
-  }
-
-  if (val.is<int>()) {
-    return (float)val.as<int>();
-  }
-
-  // Fallback
-  return val.as<String>().toFloat();
-}
+extern SeriesStore weatherData;
 
 /**
  * SMHI_API Class
@@ -86,66 +21,143 @@ static float parseValueToFloat(JsonVariant val) {
  *
  * Uses streaming JSON parsing to minimize memory usage when handling
  * large datasets (e.g., "latest-months" can contain thousands of data points)
+ *
+ * Requests go through the pooled observation-host connection
+ * (httpsPool.hpp), so back-to-back fetches skip the TLS handshake.
  */
 class SMHI_API {
 public:
+  // apiRoot: path prefix on the observation host, ending in "/parameter/"
   explicit SMHI_API(const char *apiRoot) : apiUrl(apiRoot) {}
 
+  /**
+   * Set Abort Check
+   * Polled between requests and while streaming; once it returns true the
+   * current update stops and reports failure without touching the cache
+   */
+  void setAbortCheck(JsonPullParser::AbortFn fn, void *ctx) {
+    abort_fn = fn;
+    abort_ctx = ctx;
+  }
+
   /**
    * Fetch Weather Data from SMHI API
    *
-   * @param station_idx Index into gStations vector
+   * @param station_idx Index into gStations
    * @param param_code SMHI parameter code (1=temp, 7=precip, etc.)
    * @param period "latest-day", "latest-months", etc.
    * @return true if data was successfully fetched and parsed
    *
-   * Clears weatherData vector and populates it with new data
-   * Uses streaming parsing to handle large responses without excessive RAM
+   * Replaces weatherData with the requested series (blocking, see
+   * fetchWorker.hpp for the background variant)
    */
   bool update_weather_data(int station_idx, int param_code, String period) {
-    weatherData.clear();
+    return update_series(station_idx, param_code, period, weatherData);
+  }
 
-    if (station_idx < 0 || station_idx >= (int)gStations.size())
+  /**
+   * Fetch Series Into a Store
+   * For "latest-months" the flash cache is tried first: when it holds this
+   * station/parameter only "latest-hour"/"latest-day" is downloaded and
+   * merged onto it.
+   *
+   * @param out Replaced with the requested series
+   * @return true if out holds a complete series (false if aborted)
+   */
+  bool update_series(int station_idx, int param_code, const String &period,
+                     SeriesStore &out) {
+    if (station_idx < 0 || station_idx >= (int)gStations.size()) {
+      out.clear();
       return false;
+    }
+
+    const String stationId(gStations[station_idx].id);
+    unsigned long start = millis();
+    last_bytes = 0;
+
+    bool cacheable = period == "latest-months";
+    bool ok = false;
 
-    String url = apiUrl;
-    url += String(param_code);
-    url += "/station/";
-    url += gStations[station_idx].id;
-    url += "/period/" + period + "/data.json";
+    if (cacheable && series_cache_load(stationId, param_code, out))
+      ok = refresh_cached_series(stationId, param_code, out);
+
+    if (!ok && !abort_requested()) {
+      ok = fetch_series(stationId, param_code, period, out);
+      if (ok && cacheable)
+        series_cache_save(stationId, param_code, out);
+    }
+
+    if (abort_requested()) {
+      Serial.printf("SMHI: Update for %s/%d cancelled\n", stationId.c_str(),
+                    param_code);
+      return false;
+    }
 
-    Serial.printf("Fetching data: %s\n", url.c_str());
+    Serial.printf("SMHI: %d points ready in %lu ms, %d bytes transferred\n",
+                  (int)out.size(), millis() - start, last_bytes);
+    return ok;
+  }
 
-    WiFiClientSecure client;
-    client.setInsecure();
-    client.setTimeout(15000);
+  /**
+   * Fetch One Series Into a Store
+   * Downloads and stream-parses a single period for a station/parameter
+   *
+   * @param out Cleared and filled with the parsed points
+   * @return true if at least one point was parsed
+   */
+  bool fetch_series(const String &stationId, int param_code,
+                    const String &period, SeriesStore &out) {
+    out.clear();
 
-    HTTPClient https;
-    https.setTimeout(15000);
+    String path = apiUrl;
+    path += String(param_code);
+    path += "/station/";
+    path += stationId;
+    path += "/period/" + period + "/data.json";
 
-    if (!https.begin(client, url))
+    if (abort_requested())
       return false;
 
-    int code = https.GET();
+    Serial.printf("Fetching data: %s%s\n", g_metobs_host.name(), path.c_str());
+
+    HttpsRequest req(g_metobs_host);
+    int code = req.get(path, 15000);
     if (code != 200) {
       Serial.printf("SMHI: HTTP error %d\n", code);
-      https.end();
+      req.discardBody();
       return false;
     }
 
     // Get stream instead of string to save memory
-    Stream &stream = https.getStream();
+    Stream &stream = req.stream();
 
-    Serial.printf("SMHI: Response size: %d bytes\n", https.getSize());
+    int size = req.size();
+    Serial.printf("SMHI: Response size: %d bytes\n", size);
 
-    // Parse using streaming approach
-    bool success = parseWeatherDataStream(stream);
+    // ~50 bytes per {date,value,quality} element; avoids regrowing columns
+    if (size > 0)
+      out.reserve((size_t)size / 48);
 
-    https.end();
+    // Parse using streaming approach
+    unsigned long parse_start = millis();
+    JsonPullParser json(stream);
+    json.setAbortCheck(abort_fn, abort_ctx);
+    bool success = parse_observation_document(json, out) && !json.wasAborted();
+    unsigned long parse_ms = millis() - parse_start;
+
+    // Read the trailing station/period metadata so the connection is reusable
+    if (success)
+      json.finish();
+    last_bytes += (int)json.bytesRead();
+    req.setBodyBytes(json.bytesRead());
+    if (!success)
+      req.abandon();
 
     Serial.printf("SMHI: %s (%d points)\n",
-                  success ? "Data OK" : "No data parsed",
-                  (int)weatherData.size());
+                  success ? "Data OK" : "No data parsed", (int)out.size());
+    Serial.printf("SMHI: Parse took %lu ms (%.0f points/s), %u bytes stored\n",
+                  parse_ms, parse_ms ? out.size() * 1000.0f / parse_ms : 0.0f,
+                  (unsigned)out.memoryBytes());
 
     return success;
   }
@@ -153,9 +165,10 @@ public:
   /**
    * Stream-based Weather Data Parser
    *
-   * Parses SMHI observation API responses without loading entire JSON into
-   * memory Handles both hourly data (with epoch timestamps) and daily data
-   * (with dates)
+   * Parses SMHI observation API responses in a single pass with
+   * JsonPullParser: the stream is read in chunks and every {date,value}
+   * element is appended to weatherData as its fields go by, without
+   * buffering the object or building a JSON document for it.
    *
    * Data formats supported:
    * - Hourly: { "date": 1753318800000, "value": "18.7" }
@@ -165,238 +178,322 @@ public:
    * @param stream HTTP response stream
    * @return true if at least one data point was parsed
    */
-  bool parseWeatherDataStream(Stream &stream) {
-    weatherData.clear();
+  bool parseWeatherDataStream(Stream &stream, SeriesStore &out = weatherData) {
+    JsonPullParser json(stream);
+    return parse_observation_document(json, out);
+  }
 
-    // First, find the "value" array in the stream (observation API format)
-    if (!stream.find("\"value\"")) {
-      Serial.println("SMHI: 'value' key not found, trying 'timeSeries'");
+  /**
+   * Parse Forecast Time Series Data
+   * Used for SMHI forecast API (different format than observation API)
+   *
+   * Format: { "validTime": "2025-01-15T12:00:00Z", "parameters": [...] }
+   */
+  bool parseTimeSeriesStream(Stream &stream, SeriesStore &out = weatherData) {
+    out.clear();
+    JsonPullParser json(stream);
+    if (!json.findKey("timeSeries", 1) ||
+        json.next() != JsonPullParser::TOKEN_BEGIN_ARRAY)
+      return false;
+    return parseTimeSeriesArray(json, out);
+  }
 
-      // Try timeSeries format (forecast API, though usually handled separately)
-      if (!stream.find("\"timeSeries\"")) {
-        Serial.println("SMHI: No recognized data array found");
+private:
+  const char *apiUrl;
+  int last_bytes = 0; // Body bytes read during the current update
+  JsonPullParser::AbortFn abort_fn = nullptr;
+  void *abort_ctx = nullptr;
+
+  bool abort_requested() const { return abort_fn && abort_fn(abort_ctx); }
+
+  // Copies the current token into buf, truncated to fit and terminated
+  static void copy_text(const JsonPullParser &json, char *buf, size_t size) {
+    size_t n = json.textLength() < size - 1 ? json.textLength() : size - 1;
+    memcpy(buf, json.text(), n);
+    buf[n] = '\0';
+  }
+
+  /**
+   * Refresh Cached Series
+   * series holds the cached history; fetch only the newest period and
+   * append it. "latest-hour" is used when the cache is less than ~1.5 h old
+   * (and the clock is NTP-synced), "latest-day" otherwise.
+   *
+   * The delta must overlap or directly follow the cached tail, otherwise
+   * there is a hole in the history and the caller does a full fetch.
+   *
+   * @return true if series is usable without a full fetch
+   */
+  bool refresh_cached_series(const String &stationId, int param_code,
+                             SeriesStore &series) {
+    SeriesStore::Resolution res = series.resolution();
+    if (res == SeriesStore::RES_MONTHLY)
+      return false; // Only a handful of points, not worth a delta
+
+    // Expected spacing between points, taken from the cached tail
+    size_t n = series.size();
+    int32_t step = res == SeriesStore::RES_DAILY ? 86400 : 3600;
+    if (n >= 2)
+      step = series.time(n - 1) - series.time(n - 2);
+    int32_t max_gap = step + step / 2;
+
+    time_t now = time(nullptr);
+    bool clock_ok = now > 1600000000; // NTP has synced
+    const char *period = "latest-day";
+    if (clock_ok && res == SeriesStore::RES_SUBDAILY &&
+        now - series.lastTime() < 5400)
+      period = "latest-hour";
+
+    SeriesStore delta;
+    if (!fetch_series(stationId, param_code, period, delta)) {
+      if (abort_requested())
         return false;
-      }
-      return parseTimeSeriesStream(stream);
+      // No network / nothing new published: the cached history still stands
+      Serial.printf("SMHI: Delta fetch failed, using cached data\n");
+      return true;
     }
 
-    // Find the start of the array
-    if (!stream.find("[")) {
-      Serial.println("SMHI: Array start not found");
+    if (delta.firstTime() > series.lastTime() + max_gap) {
+      Serial.printf("SMHI: Cache is stale (gap %ld s), refetching\n",
+                    (long)(delta.firstTime() - series.lastTime()));
       return false;
     }
 
-    Serial.println("SMHI: Parsing value array...");
+    size_t added = 0;
+    for (size_t i = 0; i < delta.size(); i++) {
+      if (series.append(delta.time(i), delta.value(i), delta.quality(i)))
+        added++;
+    }
+    series.keepLast(SERIES_CACHE_MAX_POINTS);
+
+    Serial.printf("SMHI: Merged %u new points from %s\n", (unsigned)added,
+                  period);
+    if (added > 0)
+      series_cache_save(stationId, param_code, series);
+    return true;
+  }
 
-    // Create a JSON filter to parse only needed fields (memory optimization)
-    StaticJsonDocument<128> filter;
-    filter["date"] = true;  // Epoch timestamp
-    filter["value"] = true; // Measurement value
-    filter["ref"] = true;   // Date reference (daily data)
-    filter["from"] = true;  // Alternative timestamp
+  /**
+   * Parse Observation Document
+   * Walks the top-level keys: "value" (observation API) or "timeSeries"
+   * (forecast API, though usually handled separately)
+   */
+  bool parse_observation_document(JsonPullParser &json, SeriesStore &out) {
+    out.clear();
+
+    if (json.next() != JsonPullParser::TOKEN_BEGIN_OBJECT) {
+      Serial.println("SMHI: Response is not a JSON object");
+      return false;
+    }
+
+    JsonPullParser::Token tok;
+    while ((tok = json.next()) == JsonPullParser::TOKEN_KEY) {
+      if (json.textEquals("value")) {
+        if (json.next() != JsonPullParser::TOKEN_BEGIN_ARRAY) {
+          Serial.println("SMHI: 'value' is not an array");
+          return false;
+        }
+        return parseValueArray(json, out);
+      }
+      if (json.textEquals("timeSeries")) {
+        if (json.next() != JsonPullParser::TOKEN_BEGIN_ARRAY)
+          return false;
+        return parseTimeSeriesArray(json, out);
+      }
+      if (!json.skipValue())
+        break;
+    }
+
+    Serial.println("SMHI: No recognized data array found");
+    return false;
+  }
+
+  /**
+   * Parse Observation Value Array
+   * Expects the parser positioned just inside the "value" array
+   * Reads each element field by field and appends it to the store
+   * Series resolution is taken from the timestamp form of the first point
+   */
+  bool parseValueArray(JsonPullParser &json, SeriesStore &out) {
+    Serial.println("SMHI: Parsing value array...");
 
-    // Buffer for reading individual JSON objects
-    char objBuffer[256];
     int parseCount = 0;
     int errorCount = 0;
 
     while (true) {
-      // Read one JSON object from the array
-      if (!readNextJsonObject(stream, objBuffer, sizeof(objBuffer))) {
-        break; // End of array or error
+      JsonPullParser::Token tok = json.next();
+      if (tok == JsonPullParser::TOKEN_END_ARRAY)
+        break;
+      if (tok != JsonPullParser::TOKEN_BEGIN_OBJECT) {
+        // Anything but an object here means a broken/cut-off stream
+        if (tok == JsonPullParser::TOKEN_ERROR ||
+            tok == JsonPullParser::TOKEN_END) {
+          Serial.println("SMHI: Stream ended inside value array");
+          break;
+        }
+        errorCount++;
+        continue;
       }
 
-      // Parse the small JSON object with filtering
-      StaticJsonDocument<256> doc;
-      DeserializationError err = deserializeJson(
-          doc, objBuffer, DeserializationOption::Filter(filter));
+      bool hasDate = false, hasRef = false, hasFrom = false, hasValue = false;
+      uint64_t dateMs = 0, fromMs = 0;
+      char ref[11] = {0};
+      float value = 0.0f;
+      uint8_t quality = 0;
+
+      while ((tok = json.next()) == JsonPullParser::TOKEN_KEY) {
+        if (json.textEquals("date")) {
+          hasDate = json.next() == JsonPullParser::TOKEN_NUMBER;
+          dateMs = (uint64_t)json.textAsInt64();
+        } else if (json.textEquals("value")) {
+          // SMHI sends numbers as strings ("18.7"), accept both
+          tok = json.next();
+          hasValue = tok == JsonPullParser::TOKEN_STRING ||
+                     tok == JsonPullParser::TOKEN_NUMBER;
+          value = hasValue ? json.textAsFloat() : 0.0f;
+        } else if (json.textEquals("ref")) {
+          hasRef = json.next() == JsonPullParser::TOKEN_STRING;
+          copy_text(json, ref, sizeof(ref));
+        } else if (json.textEquals("from")) {
+          hasFrom = json.next() == JsonPullParser::TOKEN_NUMBER;
+          fromMs = (uint64_t)json.textAsInt64();
+        } else if (json.textEquals("quality")) {
+          if (json.next() == JsonPullParser::TOKEN_STRING)
+            quality = (uint8_t)json.text()[0];
+        } else if (!json.skipValue()) {
+          tok = JsonPullParser::TOKEN_ERROR;
+          break;
+        }
+      }
 
-      if (err) {
+      if (tok != JsonPullParser::TOKEN_END_OBJECT) {
         errorCount++;
-        if (errorCount <= 3) { // Only log first 3 errors to avoid spam
-          Serial.printf("SMHI: Parse error: %s\n", err.c_str());
+        // Only log first 3 errors to avoid spam (a cancel is not an error)
+        if (errorCount <= 3 && !json.wasAborted()) {
+          Serial.printf("SMHI: Parse error at byte %u\n",
+                        (unsigned)json.bytesRead());
         }
+        if (json.failedState())
+          break;
         continue;
       }
 
-      DataPoint dp;
-      bool parsed = false;
+      if (!hasValue)
+        continue;
 
-      // Hourly format: { "date": 1753318800000, "value": "18.7" }
-      if (doc.containsKey("date") && doc.containsKey("value")) {
-        uint64_t ms = doc["date"].as<uint64_t>();
-        epoch_ms_to_date_time(ms, dp.date, dp.time);
-        dp.temp = parseValueToFloat(doc["value"]);
-        parsed = true;
-      }
-      // Daily format: { "ref": "2025-07-24", "value": "18.3" }
-      else if (doc.containsKey("ref") && doc.containsKey("value")) {
-        dp.date = doc["ref"].as<String>();
-        dp.time = "12:00";
-        dp.temp = parseValueToFloat(doc["value"]);
-        parsed = true;
-      }
-      // Fallback: use "from" timestamp
-      else if (doc.containsKey("from") && doc.containsKey("value")) {
-        uint64_t ms = doc["from"].as<uint64_t>();
-        epoch_ms_to_date_time(ms, dp.date, dp.time);
-        dp.temp = parseValueToFloat(doc["value"]);
-        parsed = true;
+      // Hourly format first, then daily "ref", then "from" fallback
+      int32_t epoch;
+      SeriesStore::Resolution res = SeriesStore::RES_SUBDAILY;
+      if (hasDate) {
+        epoch = (int32_t)(dateMs / 1000);
+      } else if (hasRef) {
+        int parts = 0;
+        if (!parse_iso_date(ref, epoch, &parts))
+          continue;
+        res = parts == 2 ? SeriesStore::RES_MONTHLY : SeriesStore::RES_DAILY;
+      } else if (hasFrom) {
+        epoch = (int32_t)(fromMs / 1000);
+      } else {
+        continue;
       }
 
-      if (parsed) {
-        weatherData.push_back(dp);
-        parseCount++;
+      if (parseCount == 0)
+        out.setResolution(res);
+      if (!out.append(epoch, value, quality))
+        continue; // Out of order / duplicate timestamp
+      parseCount++;
 
-        // Print progress every 500 entries
-        if (parseCount % 500 == 0) {
-          Serial.printf("SMHI: Parsed %d entries...\n", parseCount);
-        }
+      // Print progress every 500 entries
+      if (parseCount % 500 == 0) {
+        Serial.printf("SMHI: Parsed %d entries...\n", parseCount);
       }
     }
 
-    Serial.printf("SMHI: Finished parsing - %d entries, %d errors\n",
-                  parseCount, errorCount);
+    Serial.printf("SMHI: Finished parsing - %d entries, %d errors, %u bytes\n",
+                  parseCount, errorCount, (unsigned)json.bytesRead());
 
     return parseCount > 0;
   }
 
   /**
-   * Parse Forecast Time Series Data
-   * Used for SMHI forecast API (different format than observation API)
-   *
-   * Format: { "validTime": "2025-01-15T12:00:00Z", "parameters": [...] }
+   * Parse Forecast timeSeries Array
+   * Expects the parser positioned just inside the "timeSeries" array
+   * Keeps the "t" (temperature) parameter of every entry
    */
-  bool parseTimeSeriesStream(Stream &stream) {
-    // Find array start
-    if (!stream.find("[")) {
-      return false;
-    }
-
-    char objBuffer[2048]; // TimeSeries objects are larger
+  bool parseTimeSeriesArray(JsonPullParser &json, SeriesStore &out) {
     int parseCount = 0;
 
-    StaticJsonDocument<256> filter;
-    filter["validTime"] = true;
-    filter["parameters"][0]["name"] = true;
-    filter["parameters"][0]["values"][0] = true;
-
-    while (readNextJsonObject(stream, objBuffer, sizeof(objBuffer))) {
-      DynamicJsonDocument doc(2048);
-      DeserializationError err = deserializeJson(
-          doc, objBuffer, DeserializationOption::Filter(filter));
-      if (err)
-        continue;
+    while (json.next() == JsonPullParser::TOKEN_BEGIN_OBJECT) {
+      char validTime[25] = {0};
+      bool hasTemp = false;
+      float temp = 0.0f;
+
+      JsonPullParser::Token tok;
+      while ((tok = json.next()) == JsonPullParser::TOKEN_KEY) {
+        if (json.textEquals("validTime")) {
+          json.next();
+          copy_text(json, validTime, sizeof(validTime));
+        } else if (json.textEquals("parameters")) {
+          if (json.next() != JsonPullParser::TOKEN_BEGIN_ARRAY)
+            return parseCount > 0;
+          hasTemp |= readTemperatureParam(json, temp);
+        } else if (!json.skipValue()) {
+          return parseCount > 0;
+        }
+      }
+      if (tok != JsonPullParser::TOKEN_END_OBJECT)
+        break;
 
-      String t = doc["validTime"].as<String>();
-      if (t.length() < 16)
+      int32_t epoch;
+      if (!hasTemp || !parse_iso_date(validTime, epoch))
         continue;
 
-      for (JsonObject p : doc["parameters"].as<JsonArray>()) {
-        const char *name = p["name"] | "";
-        if (strcmp(name, "t") == 0) {
-          DataPoint dp;
-          dp.date = t.substring(0, 10);
-          dp.time = t.substring(11, 16);
-          dp.temp = p["values"][0].as<float>();
-          weatherData.push_back(dp);
-          parseCount++;
-          break;
-        }
-      }
+      if (out.append(epoch, temp))
+        parseCount++;
     }
 
     return parseCount > 0;
   }
 
-private:
-  const char *apiUrl;
-
   /**
-   * Read Next JSON Object from Stream
-   *
-   * Reads a single {} object from a JSON array in the stream
-   * Handles nested braces, string escapes, and buffer overflow
-   *
-   * This is the core of the streaming parser - allows processing
-   * huge JSON arrays one object at a time without loading the entire
-   * response into memory
-   *
-   * @param stream HTTP response stream
-   * @param buffer Output buffer for JSON object
-   * @param bufSize Size of output buffer
-   * @return true if object was successfully read, false on end of array or
-   * error
+   * Read "t" From Forecast Parameters Array
+   * Consumes the whole parameters array, returning the first value of the
+   * entry named "t" (name and values may come in any order)
    */
-  bool readNextJsonObject(Stream &stream, char *buffer, size_t bufSize) {
-    size_t pos = 0;
-    int braceCount = 0;
-    bool started = false;
-    bool inString = false;
-    bool escaped = false;
-    unsigned long timeout = millis() + 10000;
-
-    while (millis() < timeout) {
-      if (!stream.available()) {
-        delay(1);
-        continue;
-      }
-
-      char c = stream.read();
-
-      // Track string state to ignore braces inside string literals
-      if (!escaped && c == '"') {
-        inString = !inString;
-      }
-      escaped = (!escaped && c == '\\'); // Handle escape sequences
-
-      if (!started) {
-        if (c == '{') {
-          started = true;
-          braceCount = 1;
-          if (pos < bufSize - 1)
-            buffer[pos++] = c;
-        } else if (c == ']') {
-          return false; // End of JSONarray
-        }
-        // Skip whitespace and commas before object start
-      } else {
-        if (pos < bufSize - 1) {
-          buffer[pos++] = c;
-        } else {
-          // Buffer overflow - skip this object
-          while (braceCount > 0 && millis() < timeout) {
-            if (stream.available()) {
-              char skip = stream.read();
-              if (!inString) {
-                if (skip == '{')
-                  braceCount++;
-                else if (skip == '}')
-                  braceCount--;
-              }
-              if (!escaped && skip == '"')
-                inString = !inString;
-              escaped = (!escaped && skip == '\\');
-            }
-          }
-          return false;
-        }
-
-        if (!inString) {
-          if (c == '{') {
-            braceCount++;
-          } else if (c == '}') {
-            braceCount--;
-            if (braceCount == 0) {
-              buffer[pos] = '\0';
-              return true;
+  bool readTemperatureParam(JsonPullParser &json, float &out) {
+    bool found = false;
+    while (json.next() == JsonPullParser::TOKEN_BEGIN_OBJECT) {
+      bool isTemp = false;
+      bool hasValue = false;
+      float first = 0.0f;
+
+      JsonPullParser::Token tok;
+      while ((tok = json.next()) == JsonPullParser::TOKEN_KEY) {
+        if (json.textEquals("name")) {
+          json.next();
+          isTemp = json.textEquals("t");
+        } else if (json.textEquals("values")) {
+          if (json.next() != JsonPullParser::TOKEN_BEGIN_ARRAY)
+            return found;
+          while ((tok = json.next()) != JsonPullParser::TOKEN_END_ARRAY) {
+            if (tok == JsonPullParser::TOKEN_ERROR)
+              return found;
+            if (!hasValue && tok == JsonPullParser::TOKEN_NUMBER) {
+              first = json.textAsFloat();
+              hasValue = true;
             }
           }
+        } else if (!json.skipValue()) {
+          return found;
         }
       }
+      if (tok != JsonPullParser::TOKEN_END_OBJECT)
+        return found;
+      if (isTemp && hasValue && !found) {
+        out = first;
+        found = true;
+      }
     }
-
-    Serial.println("SMHI: Timeout reading JSON object");
-    return false;
+    return found;
   }
-};
\ No newline at end of file
+};
@@ -0,0 +1,229 @@
+#pragma once
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <algorithm>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+#include "seriesCache.hpp"
+
+/**
+ * Station Cache Store
+ * Keeps what the settings tile learned about stations across reboots:
+ * the parameter list of stations that have data, and the stations whose
+ * parameter 1 probe answered that there is no data. Without it every boot repeats the probes
+ * (up to 39 requests for a station when the parameter index is missing).
+ *
+ * One file on the series cache filesystem: a header and 16-byte entries
+ * (numeric station id, time learned, parameter bitmask; mask 0 = no
+ * data). Entries expire after a TTL and the oldest are dropped beyond
+ * STATION_CACHE_MAX_ENTRIES. Learned times are wall-clock seconds; an
+ * entry learned before NTP is stamped when the clock is next known, and
+ * nothing is expired while it isn't.
+ *
+ * The store is shared: the UI updates it and the fetch worker writes the
+ * file (save()), so entries are guarded by a mutex.
+ */
+static const size_t STATION_CACHE_MAX_ENTRIES = 256;       // 4 KB file
+static const uint32_t STATION_CACHE_PARAMS_TTL_S = 7 * 86400; // Lists rarely change
+static const uint32_t STATION_CACHE_NO_DATA_TTL_S = 86400;   // Stations come back
+static const char *STATION_CACHE_PATH = "/station_cache.bin";
+
+static const uint32_t STATION_CACHE_MAGIC = 0x53434353; // "SCCS"
+static const uint16_t STATION_CACHE_VERSION = 1;
+
+// Anything earlier means NTP has not set the clock yet
+static const time_t STATION_CACHE_CLOCK_VALID = 1700000000;
+
+struct StationCacheHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t reserved;
+  uint32_t count; // Number of entries that follow
+};
+
+struct StationCacheEntry {
+  uint32_t id;      // SMHI station id
+  uint32_t learned; // Epoch seconds, 0 = before the clock was set
+  uint64_t mask;    // Bit n = PARAM_CODES[n] available, 0 = no data
+};
+
+class StationCacheStore {
+public:
+  /**
+   * Load Store
+   * Call once after series_cache_begin(); a missing or corrupt file just
+   * leaves the store empty
+   */
+  void load() {
+    if (!lock)
+      lock = xSemaphoreCreateMutex();
+    if (!g_series_cache_ready || !LittleFS.exists(STATION_CACHE_PATH))
+      return;
+
+    File f = LittleFS.open(STATION_CACHE_PATH, "r");
+    if (!f)
+      return;
+    StationCacheHeader h;
+    std::vector<StationCacheEntry> read;
+    bool ok = f.read((uint8_t *)&h, sizeof(h)) == sizeof(h) &&
+              h.magic == STATION_CACHE_MAGIC &&
+              h.version == STATION_CACHE_VERSION &&
+              h.count <= STATION_CACHE_MAX_ENTRIES;
+    if (ok) {
+      read.resize(h.count);
+      size_t bytes = h.count * sizeof(StationCacheEntry);
+      ok = f.read((uint8_t *)read.data(), bytes) == bytes;
+    }
+    f.close();
+    if (!ok) {
+      Serial.printf("StationCache: %s is corrupt, removing\n",
+                    STATION_CACHE_PATH);
+      LittleFS.remove(STATION_CACHE_PATH);
+      return;
+    }
+
+    take();
+    entries.swap(read);
+    size_t expired = expire(time(nullptr));
+    give();
+    Serial.printf("StationCache: %u stations loaded, %u expired\n",
+                  (unsigned)entries.size(), (unsigned)expired);
+  }
+
+  size_t size() const { return entries.size(); }
+  const StationCacheEntry &operator[](size_t i) const { return entries[i]; }
+
+  // Station has data: mask of its parameters (0 removes the entry)
+  void putParams(const String &stationId, uint64_t mask) {
+    put(stationId, mask, mask == 0);
+  }
+
+  // Station answered its parameter 1 probe with no data
+  void putNoData(const String &stationId) { put(stationId, 0, false); }
+
+  void forget(const String &stationId) { put(stationId, 0, true); }
+
+  void clear() {
+    take();
+    entries.clear();
+    give();
+  }
+
+  /**
+   * Save Store
+   * Blocking file write (temp file + rename); runs on the fetch worker
+   */
+  bool save() {
+    if (!g_series_cache_ready)
+      return false;
+
+    take();
+    expire(time(nullptr));
+    std::vector<StationCacheEntry> copy(entries);
+    give();
+
+    StationCacheHeader h;
+    h.magic = STATION_CACHE_MAGIC;
+    h.version = STATION_CACHE_VERSION;
+    h.reserved = 0;
+    h.count = (uint32_t)copy.size();
+
+    String tmp = String(STATION_CACHE_PATH) + ".tmp";
+    File f = LittleFS.open(tmp, "w");
+    if (!f)
+      return false;
+    size_t bytes = copy.size() * sizeof(StationCacheEntry);
+    bool ok = f.write((const uint8_t *)&h, sizeof(h)) == sizeof(h) &&
+              f.write((const uint8_t *)copy.data(), bytes) == bytes;
+    f.close();
+
+    if (!ok) {
+      Serial.printf("StationCache: write failed for %s\n", STATION_CACHE_PATH);
+      LittleFS.remove(tmp);
+      return false;
+    }
+    LittleFS.remove(STATION_CACHE_PATH);
+    if (!LittleFS.rename(tmp, STATION_CACHE_PATH)) {
+      LittleFS.remove(tmp);
+      return false;
+    }
+    Serial.printf("StationCache: saved %u stations\n", (unsigned)copy.size());
+    return true;
+  }
+
+private:
+  std::vector<StationCacheEntry> entries;
+  SemaphoreHandle_t lock = NULL;
+
+  void take() {
+    if (lock)
+      xSemaphoreTake(lock, portMAX_DELAY);
+  }
+  void give() {
+    if (lock)
+      xSemaphoreGive(lock);
+  }
+
+  void put(const String &stationId, uint64_t mask, bool remove) {
+    char *end;
+    unsigned long id = strtoul(stationId.c_str(), &end, 10);
+    if (stationId.isEmpty() || *end)
+      return; // Only numeric ids fit an entry
+
+    time_t now = time(nullptr);
+    uint32_t learned = now >= STATION_CACHE_CLOCK_VALID ? (uint32_t)now : 0;
+    take();
+    auto it = std::find_if(
+        entries.begin(), entries.end(),
+        [id](const StationCacheEntry &e) { return e.id == (uint32_t)id; });
+    if (remove) {
+      if (it != entries.end())
+        entries.erase(it);
+    } else if (it != entries.end()) {
+      it->learned = learned;
+      it->mask = mask;
+    } else {
+      entries.push_back({(uint32_t)id, learned, mask});
+      if (entries.size() > STATION_CACHE_MAX_ENTRIES)
+        expire(now);
+    }
+    give();
+  }
+
+  // Drop entries past their TTL, then the oldest beyond the size bound
+  // (caller holds the lock)
+  size_t expire(time_t now) {
+    size_t before = entries.size();
+    if (now >= STATION_CACHE_CLOCK_VALID) {
+      uint32_t t = (uint32_t)now;
+      entries.erase(
+          std::remove_if(entries.begin(), entries.end(),
+                         [t](StationCacheEntry &e) {
+                           if (!e.learned || e.learned > t) {
+                             e.learned = t; // Learned before NTP
+                             return false;
+                           }
+                           uint32_t ttl = e.mask ? STATION_CACHE_PARAMS_TTL_S
+                                                 : STATION_CACHE_NO_DATA_TTL_S;
+                           return t - e.learned > ttl;
+                         }),
+          entries.end());
+    }
+    if (entries.size() > STATION_CACHE_MAX_ENTRIES) {
+      // Unknown (0) counts as newest, it was learned this boot
+      std::stable_sort(entries.begin(), entries.end(),
+                       [](const StationCacheEntry &a,
+                          const StationCacheEntry &b) {
+                         uint32_t ta = a.learned ? a.learned : UINT32_MAX;
+                         uint32_t tb = b.learned ? b.learned : UINT32_MAX;
+                         return ta > tb;
+                       });
+      entries.resize(STATION_CACHE_MAX_ENTRIES);
+    }
+    return before - entries.size();
+  }
+};
+
+static StationCacheStore g_station_cache;
@@ -0,0 +1,140 @@
+// Generated by tools/gen_stations.py - do not edit
+#pragma once
+#include <stdint.h>
+
+#include "stations.hpp"
+
+// Cell (row, col) covers latitudes LAT0 + row * DLAT and up,
+// longitudes LON0 + col * DLON and up
+static constexpr float STATION_GRID_LAT0 = 55.0f;
+static constexpr float STATION_GRID_LON0 = 11.0f;
+static constexpr float STATION_GRID_DLAT = 0.5f;
+static constexpr float STATION_GRID_DLON = 1.0f;
+static constexpr int STATION_GRID_ROWS = 28;
+static constexpr int STATION_GRID_COLS = 14;
+
+// Cell row * COLS + col holds STATION_GRID_IDS[START[cell] .. START[cell + 1])
+static constexpr uint16_t STATION_GRID_START[] = {
+  0, 0, 2, 9, 12, 12, 12, 12, 12, 12, 12, 12,
+  12, 12, 12, 12, 20, 46, 55, 56, 56, 56, 56, 56,
+  56, 56, 56, 56, 56, 56, 67, 77, 85, 91, 94, 94,
+  94, 94, 94, 94, 94, 94, 94, 94, 102, 114, 124, 129,
+  137, 137, 139, 139, 139, 139, 139, 139, 139, 140, 150, 157,
+  165, 175, 177, 181, 191, 191, 191, 191, 191, 191, 191, 201,
+  210, 218, 233, 237, 242, 242, 248, 249, 249, 249, 249, 249,
+  249, 258, 271, 288, 295, 308, 315, 317, 317, 319, 319, 319,
+  319, 319, 319, 326, 332, 342, 352, 362, 376, 383, 386, 387,
+  387, 387, 387, 387, 387, 390, 397, 402, 410, 417, 430, 451,
+  466, 470, 470, 470, 470, 470, 470, 473, 478, 484, 493, 505,
+  514, 527, 535, 536, 536, 536, 536, 536, 536, 536, 541, 546,
+  549, 558, 568, 578, 583, 583, 583, 583, 583, 583, 583, 583,
+  584, 588, 592, 600, 608, 616, 618, 618, 618, 618, 618, 618,
+  618, 618, 620, 624, 628, 633, 635, 638, 638, 638, 638, 638,
+  638, 638, 638, 638, 641, 643, 648, 649, 654, 658, 658, 658,
+  658, 658, 658, 658, 658, 658, 661, 665, 670, 671, 673, 680,
+  680, 680, 680, 680, 680, 680, 680, 680, 682, 684, 686, 692,
+  697, 700, 705, 705, 705, 705, 705, 705, 705, 705, 712, 722,
+  730, 730, 734, 740, 745, 750, 751, 751, 751, 751, 751, 751,
+  752, 755, 760, 767, 773, 774, 776, 779, 786, 786, 786, 786,
+  786, 786, 787, 787, 788, 791, 795, 799, 801, 806, 810, 814,
+  814, 814, 814, 814, 814, 815, 818, 820, 824, 826, 828, 832,
+  834, 837, 837, 837, 837, 837, 837, 837, 841, 845, 848, 851,
+  853, 855, 859, 865, 867, 867, 867, 867, 867, 867, 868, 873,
+  876, 880, 882, 885, 887, 894, 899, 903, 905, 905, 905, 905,
+  905, 905, 906, 908, 908, 910, 915, 921, 924, 925, 925, 925,
+  925, 925, 925, 925, 928, 930, 933, 936, 938, 939, 942, 944,
+  944, 944, 944, 944, 944, 944, 945, 945, 950, 951, 956, 956,
+  958, 960, 960, 960, 960, 960, 960, 960, 960, 962, 964, 966,
+  968, 971, 973, 974, 974, 974, 974, 974, 974, 974, 974, 974,
+  982, 986, 986, 987, 989, 989, 989, 989, 989, 989, 989, 989,
+  989, 989, 989, 989, 989, 991, 991, 991, 991,
+};
+// STATIONS[] indices, grouped by cell
+static constexpr uint16_t STATION_GRID_IDS[] = {
+  142, 143, 345, 434, 489, 683, 690, 814, 918, 71, 647, 681,
+  282, 438, 494, 584, 776, 869, 915, 972, 13, 14, 15, 29,
+  55, 120, 133, 330, 334, 337, 430, 476, 477, 478, 493, 495,
+  496, 666, 700, 703, 760, 768, 796, 816, 976, 985, 228, 252,
+  409, 413, 613, 651, 662, 710, 829, 856, 92, 245, 265, 271,
+  272, 320, 419, 522, 566, 930, 931, 160, 316, 317, 398, 465,
+  506, 582, 583, 636, 688, 256, 366, 367, 374, 408, 578, 626,
+  853, 369, 504, 573, 623, 624, 847, 962, 963, 964, 140, 193,
+  248, 249, 250, 251, 255, 344, 135, 148, 173, 188, 395, 452,
+  463, 464, 659, 663, 809, 810, 121, 665, 785, 800, 839, 855,
+  909, 910, 911, 912, 16, 405, 451, 634, 888, 122, 359, 360,
+  533, 646, 677, 766, 965, 283, 284, 542, 137, 200, 427, 611,
+  612, 625, 831, 863, 864, 967, 20, 190, 281, 383, 720, 914,
+  951, 22, 44, 244, 442, 535, 574, 686, 803, 10, 62, 110,
+  297, 382, 529, 530, 627, 870, 948, 365, 585, 519, 719, 960,
+  961, 17, 66, 88, 278, 280, 528, 572, 621, 860, 977, 238,
+  239, 242, 243, 428, 782, 783, 808, 821, 881, 70, 76, 126,
+  170, 240, 241, 295, 649, 827, 98, 176, 516, 521, 629, 799,
+  833, 932, 23, 157, 237, 267, 301, 354, 355, 356, 357, 471,
+  571, 600, 604, 698, 743, 166, 289, 315, 877, 192, 214, 576,
+  811, 902, 182, 270, 620, 711, 884, 885, 181, 318, 410, 466,
+  531, 532, 632, 691, 775, 828, 19, 186, 187, 205, 397, 786,
+  787, 817, 818, 819, 868, 894, 913, 72, 141, 307, 310, 326,
+  387, 425, 441, 483, 606, 630, 660, 672, 673, 674, 675, 689,
+  204, 763, 812, 886, 887, 955, 966, 4, 54, 279, 313, 459,
+  460, 490, 491, 622, 813, 900, 953, 957, 139, 285, 309, 685,
+  824, 861, 990, 263, 264, 196, 197, 107, 549, 746, 765, 852,
+  892, 893, 41, 86, 130, 414, 954, 956, 60, 333, 453, 454,
+  480, 505, 541, 667, 901, 935, 34, 37, 91, 177, 211, 236,
+  364, 692, 798, 923, 153, 154, 195, 380, 420, 429, 502, 520,
+  908, 922, 127, 296, 399, 400, 509, 553, 554, 555, 556, 567,
+  569, 614, 661, 702, 215, 439, 440, 568, 570, 587, 820, 302,
+  699, 859, 303, 78, 450, 929, 63, 64, 426, 777, 933, 942,
+  947, 371, 372, 373, 527, 865, 102, 222, 368, 381, 411, 876,
+  952, 984, 25, 325, 422, 882, 968, 969, 970, 48, 112, 123,
+  131, 132, 159, 329, 510, 707, 708, 745, 862, 959, 5, 40,
+  42, 314, 322, 482, 503, 562, 565, 680, 695, 716, 744, 767,
+  789, 792, 823, 836, 895, 916, 934, 45, 46, 79, 136, 145,
+  216, 293, 635, 648, 671, 676, 717, 718, 735, 897, 11, 208,
+  771, 772, 108, 319, 327, 6, 31, 32, 82, 292, 165, 370,
+  515, 592, 757, 758, 35, 95, 149, 185, 594, 728, 748, 749,
+  926, 147, 180, 207, 390, 391, 433, 458, 501, 547, 609, 682,
+  857, 80, 336, 639, 641, 642, 802, 903, 904, 905, 8, 27,
+  28, 33, 128, 129, 656, 715, 835, 849, 850, 851, 936, 125,
+  300, 431, 559, 560, 694, 761, 891, 788, 807, 980, 981, 982,
+  983, 115, 124, 199, 217, 218, 169, 432, 448, 74, 75, 203,
+  338, 472, 628, 722, 781, 830, 36, 50, 81, 162, 163, 221,
+  379, 407, 696, 714, 58, 101, 150, 151, 335, 581, 645, 848,
+  874, 898, 261, 615, 664, 845, 971, 332, 396, 455, 497, 498,
+  158, 514, 517, 658, 38, 73, 109, 144, 206, 449, 784, 866,
+  229, 230, 231, 232, 650, 883, 940, 941, 119, 138, 233, 234,
+  235, 308, 858, 907, 202, 975, 201, 633, 727, 778, 794, 822,
+  421, 518, 924, 925, 96, 99, 117, 118, 759, 114, 638, 730,
+  790, 791, 161, 339, 725, 779, 780, 254, 415, 456, 546, 838,
+  341, 51, 103, 104, 353, 468, 7, 294, 331, 417, 209, 739,
+  825, 111, 266, 268, 470, 394, 769, 770, 919, 920, 152, 462,
+  806, 83, 198, 487, 654, 655, 754, 755, 155, 469, 94, 738,
+  393, 687, 43, 219, 227, 298, 299, 943, 171, 172, 350, 467,
+  588, 312, 756, 793, 311, 321, 479, 551, 832, 65, 113, 684,
+  732, 733, 734, 774, 89, 324, 352, 389, 513, 534, 815, 846,
+  945, 946, 174, 461, 548, 579, 586, 637, 978, 979, 49, 93,
+  416, 558, 164, 406, 484, 575, 693, 873, 77, 253, 906, 973,
+  974, 351, 375, 668, 669, 670, 773, 116, 404, 723, 989, 12,
+  183, 184, 938, 939, 191, 246, 247, 577, 657, 747, 834, 156,
+  347, 348, 603, 726, 753, 797, 276, 277, 39, 550, 896, 286,
+  287, 840, 841, 842, 843, 844, 56, 523, 210, 403, 561, 290,
+  291, 616, 706, 340, 921, 949, 950, 167, 168, 304, 305, 306,
+  418, 880, 90, 608, 619, 899, 52, 53, 488, 944, 346, 24,
+  223, 224, 85, 323, 447, 729, 737, 875, 412, 837, 481, 762,
+  563, 564, 595, 731, 392, 678, 175, 679, 854, 388, 704, 705,
+  740, 61, 189, 386, 508, 105, 106, 486, 212, 213, 709, 499,
+  500, 194, 643, 97, 178, 179, 526, 260, 457, 596, 597, 598,
+  958, 146, 631, 0, 69, 273, 274, 275, 826, 21, 100, 878,
+  87, 557, 697, 879, 3, 724, 30, 736, 750, 871, 872, 67,
+  84, 269, 288, 752, 927, 928, 328, 473, 474, 475, 580, 57,
+  358, 741, 742, 257, 258, 349, 26, 436, 712, 801, 68, 259,
+  343, 525, 751, 437, 444, 445, 552, 601, 602, 220, 986, 987,
+  988, 511, 512, 890, 545, 713, 361, 423, 424, 342, 599, 605,
+  539, 652, 540, 507, 538, 589, 402, 917, 701, 9, 18, 59,
+  644, 721, 937, 225, 226, 262, 446, 492, 401, 640, 590, 591,
+  617, 618, 653, 795, 543, 544, 384, 385, 134, 764, 889, 435,
+  593, 524, 1, 2, 376, 377, 485, 610, 804, 867, 47, 378,
+  607, 805, 443, 362, 363, 536, 537,
+};
+static_assert(sizeof(STATION_GRID_IDS) / sizeof(STATION_GRID_IDS[0]) ==
+                  sizeof(STATIONS) / sizeof(STATIONS[0]),
+              "regenerate stations.hpp and stationGrid.hpp together");
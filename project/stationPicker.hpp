@@ -1,14 +1,15 @@
 #pragma once
-#include "stations.hpp" // generated full SMHI station list (id, name, lat, lon)
+#include "stationGrid.hpp" // generated lat/lon grid over STATIONS[]
+#include "stationTable.hpp" // view of the generated list (id, name, lat, lon)
 #include <Arduino.h>
 #include <algorithm>
 #include <math.h>
 #include <vector>
 
 
-// Global station list used across app (populated in loop(), defined in
+// Global station list used across app (loaded in loop(), defined in
 // project.ino)
-extern std::vector<StationInfo> gStations;
+extern StationTable gStations;
 
 // ------------------------------------------------------------------
 // Top 100 Swedish Cities by Population
@@ -62,20 +63,107 @@ static float distance_km(float lat1, float lon1, float lat2, float lon2) {
   return 6371.0f * 2.0f * asinf(sqrtf(a)); // Earth radius = 6371 km
 }
 
+// ------------------------------------------------------------------
+// Nearest-Station Queries
+// Use the generated grid (stationGrid.hpp) instead of a haversine scan over
+// every station: cells are visited in rings around the query point, and
+// the search stops once no unvisited cell can hold a closer station than
+// the ones found, so a query measures a few dozen stations at most.
+// accept(idx) filters stations, e.g. by parameter availability.
+// Results are nearest first; indices are into STATIONS[] / gStations.
+// ------------------------------------------------------------------
+struct StationHit {
+  int idx;
+  float km;
+};
+
+template <typename Accept>
+static size_t stations_nearest_within(float lat, float lon, size_t k,
+                                      float radius_km, StationHit *out,
+                                      Accept accept) {
+  if (k == 0)
+    return 0;
+  int row = (int)floorf((lat - STATION_GRID_LAT0) / STATION_GRID_DLAT);
+  int col = (int)floorf((lon - STATION_GRID_LON0) / STATION_GRID_DLON);
+  row = std::min(std::max(row, 0), STATION_GRID_ROWS - 1);
+  col = std::min(std::max(col, 0), STATION_GRID_COLS - 1);
+
+  // Shortest cell side over the grid: a station r rings out is at least
+  // r - 1 of them away (a few percent of slack for the sphere)
+  const float lat_max = STATION_GRID_LAT0 + STATION_GRID_ROWS * STATION_GRID_DLAT;
+  const float cell_km =
+      0.97f * 111.19f *
+      std::min(STATION_GRID_DLAT,
+               STATION_GRID_DLON * cosf(lat_max * 0.01745329252f));
+
+  size_t n = 0;
+  auto visit = [&](int r, int c) {
+    int cell = r * STATION_GRID_COLS + c;
+    for (int j = STATION_GRID_START[cell]; j < STATION_GRID_START[cell + 1];
+         j++) {
+      int idx = STATION_GRID_IDS[j];
+      float d = distance_km(lat, lon, STATIONS[idx].lat, STATIONS[idx].lon);
+      if (d > radius_km)
+        continue;
+      // Ties go to the lower index, so results don't depend on cell order
+      if (n == k && (d > out[n - 1].km || (d == out[n - 1].km &&
+                                           idx > out[n - 1].idx)))
+        continue;
+      if (!accept(idx))
+        continue;
+      size_t pos = n < k ? n++ : n - 1;
+      while (pos > 0 && (out[pos - 1].km > d ||
+                         (out[pos - 1].km == d && out[pos - 1].idx > idx))) {
+        out[pos] = out[pos - 1];
+        pos--;
+      }
+      out[pos] = {idx, d};
+    }
+  };
+
+  int rings = std::max(std::max(row, STATION_GRID_ROWS - 1 - row),
+                       std::max(col, STATION_GRID_COLS - 1 - col));
+  for (int ring = 0; ring <= rings; ring++) {
+    float bound = ring > 0 ? (ring - 1) * cell_km : 0.0f;
+    if (bound > radius_km || (n == k && out[n - 1].km < bound))
+      break;
+    for (int r = row - ring; r <= row + ring; r++) {
+      if (r < 0 || r >= STATION_GRID_ROWS)
+        continue;
+      // Full rows at the ring's top and bottom, both ends in between
+      int step = (r == row - ring || r == row + ring) ? 1 : 2 * ring;
+      for (int c = col - ring; c <= col + ring; c += step) {
+        if (c >= 0 && c < STATION_GRID_COLS)
+          visit(r, c);
+      }
+    }
+  }
+  return n;
+}
+
+// k nearest stations accepted by the filter
+template <typename Accept>
+static size_t stations_nearest(float lat, float lon, size_t k,
+                               StationHit *out, Accept accept) {
+  return stations_nearest_within(lat, lon, k, INFINITY, out, accept);
+}
+
+// Up to max accepted stations within radius_km, nearest first
+template <typename Accept>
+static size_t stations_within(float lat, float lon, float radius_km,
+                              StationHit *out, size_t max, Accept accept) {
+  return stations_nearest_within(lat, lon, max, radius_km, out, accept);
+}
+
 // ------------------------------------------------------------------
 // Station List Loader
-// Loads all stations from stations.hpp into global gStations vector
+// Makes all stations of stations.hpp available through gStations (the
+// table stays in flash, nothing is copied)
 // Original parameters (radius, max_stations) are unused - loads all stations
 // for comprehensive city/station search and validation
 // ------------------------------------------------------------------
 static bool fetch_and_select_top_stations(float /*unused*/, int /*unused*/) {
-  gStations.clear();
-  gStations.reserve(STATION_COUNT);
-
-  // Copy ALL stations for fuzzy matching and validation
-  for (size_t i = 0; i < STATION_COUNT; ++i) {
-    gStations.push_back(STATIONS[i]);
-  }
+  gStations.load();
 
   Serial.printf("Loaded %u stations from stations.hpp\n",
                 (unsigned)STATION_COUNT);
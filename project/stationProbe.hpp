@@ -0,0 +1,226 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include <string.h>
+
+#include "httpsPool.hpp"
+
+/**
+ * Parallel Station Probes
+ * Asks SMHI whether candidate stations have parameter 1 data, several at
+ * a time. The settings tile used to probe one candidate after the other
+ * (a latest-months GET with a 5 s timeout each), so a city whose first
+ * candidates were dead took many seconds to resolve.
+ *
+ * A batch holds up to PROBE_MAX candidates, best first. PROBE_WORKERS
+ * tasks take them in that order, each on its own connection of
+ * g_probe_host, so at most PROBE_WORKERS requests are in flight. The batch
+ * resolves as soon as the best-ranked candidate with data is known (every
+ * better one has answered no). Candidates not started by then are
+ * skipped; probes still in flight finish in the background and their
+ * answers are ignored.
+ *
+ * Like the sequential probe, only the status line is read and the
+ * connection is closed rather than drained.
+ */
+static const int PROBE_WORKERS = 3;
+static const int PROBE_MAX = 8;
+static const uint32_t PROBE_TIMEOUT_MS = 5000;
+static const uint32_t PROBE_WORKER_STACK = 8192; // TLS handshake
+static const UBaseType_t PROBE_WORKER_PRIORITY = 1;
+static const BaseType_t PROBE_WORKER_CORE = 0;
+
+// Probes get their own slots so they don't queue behind the fetch worker
+static HttpsHost g_probe_host(SMHI_METOBS_HOST, SMHI_HTTPS_PORT,
+                              PROBE_WORKERS);
+
+enum ProbeResult : uint8_t {
+  PROBE_PENDING = 0, // Not asked, or the answer came too late
+  PROBE_HAS_DATA,
+  PROBE_NO_DATA, // SMHI answered that there is no data (404/204)
+  PROBE_FAILED   // Transport error or any other status: nothing learned
+};
+
+/**
+ * Probe One Station
+ * Blocking, any thread
+ *
+ * @return HTTP status (200 = the station has parameter 1 data)
+ */
+static int probe_station_param1(const char *station_id) {
+  String url = "/api/version/1.0/parameter/1/station/";
+  url += station_id;
+  url += "/period/latest-months/data.json";
+
+  HttpsRequest req(g_probe_host, PROBE_TIMEOUT_MS);
+  int code = req.get(url, PROBE_TIMEOUT_MS);
+  req.abandon();
+  return code;
+}
+
+static uint8_t probe_result_of(int code) {
+  if (code == 200)
+    return PROBE_HAS_DATA;
+  return code == 404 || code == 204 ? PROBE_NO_DATA : PROBE_FAILED;
+}
+
+class StationProbes {
+public:
+  /**
+   * Probe Candidates
+   * Blocks the caller until the best-ranked candidate with data is known,
+   * which is about one request when the first candidates are dead. Falls
+   * back to probing one by one on the caller if the tasks can't start.
+   *
+   * @param ids Station ids, best first (at most PROBE_MAX)
+   * @param results Filled per candidate (PROBE_PENDING = no answer used)
+   * @return Position of the best candidate with data, -1 if none
+   */
+  int run(const char *const *ids, int count, uint8_t *results) {
+    if (count > PROBE_MAX)
+      count = PROBE_MAX;
+    for (int i = 0; i < count; i++)
+      results[i] = PROBE_PENDING;
+    if (count <= 0)
+      return -1;
+
+    unsigned long start = millis();
+    if (!begin()) {
+      for (int i = 0; i < count; i++) {
+        results[i] = probe_result_of(probe_station_param1(ids[i]));
+        if (results[i] == PROBE_HAS_DATA)
+          return i;
+      }
+      return -1;
+    }
+
+    // New batch: jobs of the previous one left in the queue are dropped
+    uint32_t b = batch.load() + 1;
+    Job stale;
+    while (xQueueReceive(queue, &stale, 0) == pdTRUE) {
+    }
+    for (int i = 0; i < count; i++) {
+      strncpy(ids_[i], ids[i], sizeof(ids_[i]) - 1);
+      ids_[i][sizeof(ids_[i]) - 1] = '\0';
+      state[i].store(tag_of(b) | PROBE_PENDING);
+    }
+    best.store(tag_of(b) | PROBE_MAX);
+    batch.store(b);
+    for (int i = 0; i < count; i++) {
+      Job job = {b, (uint8_t)i};
+      xQueueSend(queue, &job, 0);
+    }
+
+    // Every candidate could time out, PROBE_WORKERS at a time
+    uint32_t deadline =
+        PROBE_TIMEOUT_MS * ((count + PROBE_WORKERS - 1) / PROBE_WORKERS + 1);
+    int found = -1;
+    int asked = 0;
+    while (true) {
+      int pos = 0;
+      for (; pos < count; pos++) {
+        uint32_t s = state[pos].load();
+        uint8_t r = (s & ~0xFFu) == tag_of(b) ? (uint8_t)(s & 0xFF)
+                                               : (uint8_t)PROBE_PENDING;
+        if (r == PROBE_PENDING)
+          break;
+        results[pos] = r;
+        if (r == PROBE_HAS_DATA) {
+          found = pos;
+          break;
+        }
+      }
+      if (found >= 0 || pos == count || millis() - start > deadline)
+        break;
+      vTaskDelay(pdMS_TO_TICKS(5));
+    }
+    // Cancel the rest: queued jobs are skipped, late answers ignored
+    batch.store(b + 1);
+    for (int i = 0; i < count; i++)
+      asked += results[i] != PROBE_PENDING;
+
+    Serial.printf("Probes: %d candidates, %s after %lu ms (%d answers used)\n",
+                  count, found >= 0 ? ids[found] : "none with data",
+                  millis() - start, asked);
+    return found;
+  }
+
+private:
+  struct Job {
+    uint32_t batch;
+    uint8_t pos;
+  };
+
+  QueueHandle_t queue = NULL;
+  bool started = false;
+  bool failed = false;
+  std::atomic<uint32_t> batch{0};
+  // Both are tagged with the batch they belong to and only ever changed
+  // by compare-exchange against that tag, so a worker still finishing an
+  // older batch cannot touch the current one.
+  // Best position with data so far: tag_of(batch) | position
+  std::atomic<uint32_t> best{PROBE_MAX};
+  // Per position: tag_of(batch) | ProbeResult
+  std::atomic<uint32_t> state[PROBE_MAX] = {};
+  char ids_[PROBE_MAX][12] = {};
+
+  // Low 24 bits of a batch number, above an 8-bit value
+  static uint32_t tag_of(uint32_t b) { return (b & 0xFFFFFF) << 8; }
+
+  bool begin() {
+    if (started || failed)
+      return started;
+    queue = xQueueCreate(PROBE_MAX * 2, sizeof(Job));
+    for (int i = 0; queue && i < PROBE_WORKERS; i++) {
+      if (xTaskCreatePinnedToCore(task, "probe", PROBE_WORKER_STACK, this,
+                                  PROBE_WORKER_PRIORITY, NULL,
+                                  PROBE_WORKER_CORE) != pdPASS)
+        break;
+      started = true; // Fewer workers only means less parallelism
+    }
+    if (!started) {
+      Serial.println("Probes: task creation failed, probing sequentially");
+      failed = true;
+    }
+    return started;
+  }
+
+  static void task(void *arg) {
+    StationProbes *self = (StationProbes *)arg;
+    Job job;
+    while (true) {
+      if (xQueueReceive(self->queue, &job, portMAX_DELAY) == pdTRUE)
+        self->serve(job);
+    }
+  }
+
+  void serve(const Job &job) {
+    uint32_t tag = tag_of(job.batch);
+    // Cancelled, or a better-ranked candidate already has data
+    uint32_t b = best.load();
+    if (job.batch != batch.load() || (b & ~0xFFu) != tag ||
+        (b & 0xFF) < job.pos)
+      return;
+    char id[sizeof(ids_[0])];
+    memcpy(id, ids_[job.pos], sizeof(id));
+    if (job.batch != batch.load())
+      return;
+
+    int code = probe_station_param1(id);
+    Serial.printf("  Probe %s: HTTP %d\n", id, code);
+    uint8_t r = probe_result_of(code);
+    if (job.batch != batch.load())
+      return; // Resolved without us
+    uint32_t pending = tag | PROBE_PENDING;
+    if (!state[job.pos].compare_exchange_strong(pending, tag | r))
+      return; // A newer batch has taken the slot
+    if (r == PROBE_HAS_DATA) {
+      b = best.load();
+      while ((b & ~0xFFu) == tag && job.pos < (b & 0xFF) &&
+             !best.compare_exchange_weak(b, tag | job.pos)) {
+      }
+    }
+  }
+};
+
+static StationProbes g_station_probes;
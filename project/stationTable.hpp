@@ -0,0 +1,50 @@
+#pragma once
+#include <stddef.h>
+#include <string.h>
+
+#include "stations.hpp"
+
+/**
+ * Station Table
+ * Read-only view of the generated STATIONS[] table, which stays in flash.
+ * It replaces the std::vector<StationInfo> copy that held two heap Strings
+ * per station. The interface is unchanged (size(), empty(), operator[]),
+ * and indices are STATIONS[] indices.
+ *
+ * The view is empty until load(), so code that waits for the station
+ * list (loaded in loop() once Wi-Fi is up) behaves as before.
+ */
+class StationTable {
+public:
+  void load() { loaded = true; }
+
+  size_t size() const { return loaded ? STATION_COUNT : 0; }
+  bool empty() const { return !loaded; }
+  const StationInfo &operator[](size_t i) const { return STATIONS[i]; }
+
+  /**
+   * Index of a Station Id
+   * Binary search over the generated STATION_ID_ORDER table
+   *
+   * @return STATIONS[] index, -1 if unknown or not loaded
+   */
+  int indexOf(const char *id) const {
+    if (!loaded || !id)
+      return -1;
+    size_t lo = 0, hi = STATION_COUNT;
+    while (lo < hi) {
+      size_t mid = (lo + hi) / 2;
+      int c = strcmp(STATIONS[STATION_ID_ORDER[mid]].id, id);
+      if (c == 0)
+        return STATION_ID_ORDER[mid];
+      if (c < 0)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return -1;
+  }
+
+private:
+  bool loaded = false;
+};
@@ -1,8 +1,17 @@
+// Generated by tools/gen_stations.py - do not edit
 #pragma once
-#include <Arduino.h>
+#include <stddef.h>
+#include <stdint.h>
 
-struct StationInfo { String id; String name; float lat; float lon; };
-static const StationInfo STATIONS[] = {
+struct StationInfo {
+  const char *id;
+  const char *name; // UTF-8
+  float lat;
+  float lon;
+};
+
+// Sorted by name
+static constexpr StationInfo STATIONS[] = {
   {"154860", "Abelvattnet Aut", 65.53000f, 14.97000f},
   {"188800", "Abisko", 68.35380f, 18.81660f},
   {"188790", "Abisko Aut", 68.35380f, 18.81640f},
@@ -995,4 +1004,91 @@ static const StationInfo STATIONS[] = {
   {"133470", "Överäng", 63.77880f, 13.07340f},
   {"86700", "Övre Gränsö", 58.35000f, 16.83330f},
 };
-static const size_t STATION_COUNT = sizeof(STATIONS)/sizeof(STATIONS[0]);
+static constexpr size_t STATION_COUNT = sizeof(STATIONS) / sizeof(STATIONS[0]);
+
+// STATIONS[] indices in strcmp() order of their ids
+static constexpr uint16_t STATION_ID_ORDER[] = {
+  8, 694, 983, 980, 981, 982, 332, 115, 807, 217, 218, 124,
+  199, 497, 498, 396, 455, 169, 448, 514, 158, 658, 517, 432,
+  203, 472, 628, 781, 722, 338, 75, 74, 73, 206, 144, 784,
+  449, 38, 830, 866, 109, 81, 696, 36, 162, 50, 163, 379,
+  221, 714, 407, 650, 883, 940, 941, 232, 229, 230, 231, 874,
+  58, 335, 645, 101, 151, 150, 898, 581, 848, 138, 234, 308,
+  235, 119, 858, 907, 664, 615, 845, 202, 975, 261, 971, 841,
+  633, 201, 161, 725, 339, 778, 794, 822, 779, 780, 727, 925,
+  924, 421, 415, 838, 254, 456, 518, 546, 99, 759, 118, 117,
+  341, 96, 638, 114, 353, 103, 104, 468, 706, 51, 791, 790,
+  7, 331, 417, 294, 730, 825, 469, 155, 739, 209, 111, 470,
+  266, 268, 94, 738, 769, 770, 919, 920, 394, 393, 687, 152,
+  943, 299, 298, 43, 219, 227, 806, 172, 462, 588, 467, 350,
+  171, 83, 487, 654, 655, 755, 756, 312, 198, 793, 311, 479,
+  551, 321, 832, 774, 65, 684, 733, 734, 113, 116, 732, 89,
+  324, 815, 534, 846, 389, 945, 352, 946, 989, 404, 723, 513,
+  548, 978, 979, 174, 637, 461, 183, 184, 939, 12, 579, 938,
+  577, 657, 247, 246, 834, 747, 191, 49, 416, 558, 603, 726,
+  348, 347, 156, 93, 753, 873, 406, 575, 164, 693, 484, 797,
+  906, 253, 974, 77, 277, 276, 669, 670, 375, 351, 550, 896,
+  39, 668, 240, 773, 286, 287, 842, 843, 840, 56, 346, 523,
+  223, 224, 24, 210, 561, 403, 323, 85, 291, 290, 616, 875,
+  447, 737, 729, 950, 949, 921, 340, 837, 213, 212, 168, 167,
+  412, 481, 762, 880, 306, 595, 563, 564, 731, 418, 304, 305,
+  242, 608, 619, 90, 899, 678, 392, 488, 53, 52, 679, 175,
+  944, 854, 740, 388, 705, 704, 0, 61, 508, 386, 189, 69,
+  826, 273, 275, 274, 486, 105, 106, 100, 878, 21, 557, 709,
+  697, 87, 879, 500, 499, 724, 3, 736, 643, 194, 30, 750,
+  243, 97, 179, 178, 526, 871, 872, 269, 752, 927, 596, 598,
+  260, 597, 958, 457, 928, 84, 67, 288, 473, 631, 146, 475,
+  474, 328, 580, 57, 742, 741, 358, 257, 258, 349, 890, 512,
+  511, 545, 26, 436, 713, 423, 424, 361, 712, 801, 342, 605,
+  599, 68, 259, 751, 525, 343, 652, 539, 445, 444, 552, 437,
+  601, 602, 540, 538, 220, 987, 986, 507, 589, 988, 917, 402,
+  701, 617, 618, 644, 9, 18, 59, 653, 721, 795, 937, 543,
+  544, 129, 262, 226, 492, 225, 446, 385, 384, 764, 889, 134,
+  401, 640, 593, 435, 591, 590, 524, 485, 2, 1, 867, 376,
+  610, 804, 377, 607, 805, 378, 438, 329, 639, 536, 537, 443,
+  362, 363, 322, 293, 28, 818, 909, 973, 844, 754, 47, 586,
+  568, 903, 656, 354, 142, 143, 495, 584, 972, 869, 282, 915,
+  776, 690, 489, 814, 345, 918, 434, 496, 493, 494, 14, 476,
+  477, 478, 976, 430, 816, 334, 337, 703, 133, 760, 796, 330,
+  13, 55, 666, 683, 985, 120, 700, 15, 29, 768, 647, 681,
+  71, 252, 662, 651, 413, 710, 409, 829, 228, 856, 271, 272,
+  265, 522, 566, 320, 931, 419, 245, 249, 248, 250, 251, 140,
+  255, 193, 344, 92, 930, 465, 316, 317, 160, 583, 582, 688,
+  506, 395, 188, 659, 663, 135, 463, 464, 173, 810, 809, 398,
+  148, 452, 636, 256, 408, 374, 366, 367, 578, 853, 800, 121,
+  785, 855, 911, 910, 912, 613, 626, 665, 839, 847, 573, 369,
+  504, 624, 888, 634, 16, 451, 405, 623, 962, 964, 963, 533,
+  360, 359, 766, 122, 677, 965, 283, 284, 233, 542, 821, 881,
+  239, 808, 782, 783, 428, 863, 200, 864, 831, 137, 427, 611,
+  612, 967, 625, 649, 70, 241, 76, 170, 295, 827, 126, 238,
+  720, 190, 914, 281, 20, 176, 98, 833, 629, 521, 516, 383,
+  799, 951, 932, 44, 244, 574, 803, 698, 237, 571, 267, 157,
+  600, 357, 356, 355, 301, 604, 23, 471, 22, 535, 442, 743,
+  686, 10, 948, 110, 62, 627, 529, 530, 315, 877, 297, 289,
+  870, 382, 166, 646, 365, 585, 811, 192, 214, 902, 576, 519,
+  719, 961, 960, 860, 572, 66, 278, 88, 280, 977, 621, 620,
+  528, 711, 884, 885, 270, 182, 181, 370, 775, 632, 532, 531,
+  466, 410, 828, 691, 107, 765, 892, 549, 746, 893, 318, 852,
+  19, 913, 186, 397, 187, 819, 205, 894, 787, 786, 414, 130,
+  41, 817, 86, 954, 956, 660, 141, 483, 868, 72, 307, 674,
+  441, 689, 673, 310, 675, 672, 606, 453, 901, 454, 541, 505,
+  480, 935, 326, 630, 60, 425, 387, 667, 333, 812, 887, 886,
+  955, 966, 364, 37, 177, 923, 236, 692, 204, 91, 798, 34,
+  211, 763, 622, 813, 490, 491, 953, 54, 313, 279, 957, 460,
+  459, 900, 685, 520, 420, 153, 154, 195, 380, 922, 502, 4,
+  908, 429, 824, 309, 139, 861, 285, 509, 555, 554, 553, 556,
+  296, 399, 702, 661, 569, 614, 400, 567, 707, 990, 264, 263,
+  215, 587, 440, 439, 959, 820, 570, 859, 699, 302, 197, 196,
+  303, 17, 929, 78, 108, 319, 450, 327, 942, 777, 64, 63,
+  82, 947, 31, 32, 292, 6, 933, 426, 527, 373, 372, 865,
+  371, 758, 515, 592, 757, 165, 952, 102, 876, 411, 381, 368,
+  728, 35, 95, 185, 149, 594, 926, 748, 222, 749, 984, 325,
+  882, 970, 968, 969, 25, 547, 147, 458, 207, 180, 609, 682,
+  390, 391, 857, 422, 501, 862, 745, 159, 510, 112, 123, 132,
+  708, 131, 433, 904, 905, 802, 336, 641, 642, 48, 80, 916,
+  823, 792, 934, 562, 503, 565, 42, 716, 836, 767, 482, 40,
+  744, 5, 128, 27, 715, 835, 850, 849, 851, 695, 314, 895,
+  33, 936, 789, 680, 45, 671, 735, 676, 648, 216, 897, 717,
+  718, 635, 79, 300, 431, 559, 761, 560, 891, 46, 145, 125,
+  136, 11, 208, 771, 772, 788, 127,
+};
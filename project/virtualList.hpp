@@ -0,0 +1,195 @@
+#pragma once
+#include <lvgl.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * Virtual List
+ * Scrolling list of text rows that only has label objects for the rows in
+ * view: a pool of height / row height + 2 labels is moved and given new
+ * text as the list scrolls, so a thousand rows cost no more objects than
+ * ten.
+ *
+ * The list scrolls itself instead of using LVGL scrolling: with 16-bit
+ * lv_coord_t (LV_COORD_MAX 8191) the content of ~1000 rows would not fit.
+ * Vertical drags scroll it, horizontal ones still reach the tileview.
+ *
+ * Labels show their text without a copy (lv_label_set_text_static): a
+ * row's text is either a string that outlives the list, like the city
+ * table in flash, or written into the label's own buffer.
+ */
+class VirtualList {
+public:
+  // Longest row text written into a label's buffer, with the NUL
+  static const size_t ROW_TEXT_MAX = 64;
+
+  // Text of a row (a lasting string, or buf filled in), and whether it
+  // is drawn in the secondary color
+  typedef const char *(*RowText)(uint32_t row, char *buf, size_t cap,
+                                 bool &secondary);
+  typedef void (*RowClicked)(uint32_t row);
+
+  /**
+   * Create List
+   * @param max_h Tallest the list will be made (sizes the label pool)
+   * @param row_h Row height in pixels
+   */
+  void create(lv_obj_t *parent, lv_coord_t w, lv_coord_t max_h,
+              lv_coord_t row_h, RowText text_cb, RowClicked clicked_cb) {
+    text = text_cb;
+    clicked = clicked_cb;
+    row_height = row_h;
+
+    cont = lv_obj_create(parent);
+    lv_obj_set_size(cont, w, max_h);
+    lv_obj_set_style_pad_all(cont, 0, 0);
+    lv_obj_clear_flag(cont, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_clear_flag(cont, LV_OBJ_FLAG_SCROLL_CHAIN_VER);
+    lv_obj_add_event_cb(cont, event_cb, LV_EVENT_ALL, this);
+
+    pool_count = max_h / row_h + 2;
+    if (pool_count > MAX_POOL)
+      pool_count = MAX_POOL;
+    const lv_font_t *font = lv_obj_get_style_text_font(cont, LV_PART_MAIN);
+    lv_coord_t pad_y = (row_h - lv_font_get_line_height(font)) / 2;
+    for (int i = 0; i < pool_count; i++) {
+      lv_obj_t *l = lv_label_create(cont);
+      lv_obj_set_size(l, lv_pct(100), row_h);
+      lv_label_set_long_mode(l, LV_LABEL_LONG_DOT);
+      lv_obj_set_style_pad_left(l, 10, 0);
+      lv_obj_set_style_pad_right(l, 10, 0);
+      lv_obj_set_style_pad_top(l, pad_y > 0 ? pad_y : 0, 0);
+      lv_obj_set_style_text_color(l, lv_color_hex(0x666666), LV_STATE_USER_1);
+      lv_obj_add_flag(l, LV_OBJ_FLAG_HIDDEN);
+      pool[i] = l;
+      pool_row[i] = NO_ROW;
+    }
+
+    thumb = lv_obj_create(cont);
+    lv_obj_remove_style_all(thumb);
+    lv_obj_set_style_bg_opa(thumb, LV_OPA_50, 0);
+    lv_obj_set_style_bg_color(thumb, lv_color_hex(0x808080), 0);
+    lv_obj_set_style_radius(thumb, 2, 0);
+    lv_obj_add_flag(thumb, LV_OBJ_FLAG_HIDDEN);
+  }
+
+  lv_obj_t *obj() const { return cont; }
+  uint32_t count() const { return row_count; }
+
+  void setHeight(lv_coord_t h) {
+    lv_obj_set_height(cont, h);
+    lv_obj_update_layout(cont);
+    scrollTo(scroll);
+  }
+
+  // New contents: n rows, back at the top
+  void setCount(uint32_t n) {
+    row_count = n;
+    for (int i = 0; i < pool_count; i++)
+      pool_row[i] = NO_ROW;
+    scroll = 0;
+    refresh();
+  }
+
+private:
+  static const int MAX_POOL = 16;
+  static const uint32_t NO_ROW = UINT32_MAX;
+  // Movement before a press counts as a drag rather than a tap
+  static const lv_coord_t DRAG_LIMIT = 10;
+
+  lv_obj_t *cont = nullptr;
+  lv_obj_t *thumb = nullptr;
+  lv_obj_t *pool[MAX_POOL] = {};
+  uint32_t pool_row[MAX_POOL] = {}; // Row each label shows (NO_ROW = none)
+  char pool_text[MAX_POOL][ROW_TEXT_MAX] = {};
+  int pool_count = 0;
+  RowText text = nullptr;
+  RowClicked clicked = nullptr;
+  lv_coord_t row_height = 1;
+  uint32_t row_count = 0;
+  int32_t scroll = 0; // Pixels scrolled from the top
+  int32_t drag = 0;   // Movement since the press
+
+  int32_t viewHeight() const { return lv_obj_get_content_height(cont); }
+
+  int32_t maxScroll() const {
+    int32_t m = (int32_t)row_count * row_height - viewHeight();
+    return m > 0 ? m : 0;
+  }
+
+  void scrollTo(int32_t y) {
+    int32_t m = maxScroll();
+    scroll = y < 0 ? 0 : (y > m ? m : y);
+    refresh();
+  }
+
+  // Point the pooled labels at the rows in view
+  void refresh() {
+    int32_t h = viewHeight();
+    uint32_t first = (uint32_t)(scroll / row_height);
+    for (int i = 0; i < pool_count; i++) {
+      lv_obj_t *l = pool[i];
+      uint32_t row = first + i;
+      int32_t y = (int32_t)row * row_height - scroll;
+      if (row >= row_count || y >= h) {
+        if (pool_row[i] != NO_ROW) {
+          lv_obj_add_flag(l, LV_OBJ_FLAG_HIDDEN);
+          pool_row[i] = NO_ROW;
+        }
+        continue;
+      }
+      if (pool_row[i] != row) {
+        bool secondary = false;
+        lv_label_set_text_static(
+            l, text(row, pool_text[i], ROW_TEXT_MAX, secondary));
+        if (secondary)
+          lv_obj_add_state(l, LV_STATE_USER_1);
+        else
+          lv_obj_clear_state(l, LV_STATE_USER_1);
+        lv_obj_clear_flag(l, LV_OBJ_FLAG_HIDDEN);
+        pool_row[i] = row;
+      }
+      lv_obj_set_y(l, (lv_coord_t)y);
+    }
+
+    // Scroll position indicator, only when the rows don't fit
+    int32_t total = (int32_t)row_count * row_height;
+    if (total <= h || h <= 0) {
+      lv_obj_add_flag(thumb, LV_OBJ_FLAG_HIDDEN);
+      return;
+    }
+    int32_t th = h * h / total;
+    if (th < 12)
+      th = 12;
+    int32_t ty = (h - th) * scroll / (total - h);
+    lv_obj_set_size(thumb, 4, (lv_coord_t)th);
+    lv_obj_set_pos(thumb, lv_obj_get_content_width(cont) - 6, (lv_coord_t)ty);
+    lv_obj_clear_flag(thumb, LV_OBJ_FLAG_HIDDEN);
+  }
+
+  static void event_cb(lv_event_t *e) {
+    VirtualList *self = (VirtualList *)lv_event_get_user_data(e);
+    lv_event_code_t code = lv_event_get_code(e);
+    lv_indev_t *indev = lv_indev_get_act();
+    if (!indev)
+      return;
+
+    if (code == LV_EVENT_PRESSED) {
+      self->drag = 0;
+    } else if (code == LV_EVENT_PRESSING) {
+      lv_point_t v;
+      lv_indev_get_vect(indev, &v);
+      self->drag += abs(v.y);
+      if (self->drag > DRAG_LIMIT && v.y)
+        self->scrollTo(self->scroll - v.y);
+    } else if (code == LV_EVENT_CLICKED && self->drag <= DRAG_LIMIT) {
+      lv_point_t p;
+      lv_indev_get_point(indev, &p);
+      lv_area_t a;
+      lv_obj_get_content_coords(self->cont, &a);
+      int32_t y = p.y - a.y1 + self->scroll;
+      if (y >= 0 && (uint32_t)(y / self->row_height) < self->row_count)
+        self->clicked((uint32_t)(y / self->row_height));
+    }
+  }
+};
@@ -1,11 +1,19 @@
 #pragma once
+#include <Arduino.h>
 #include <lvgl.h>
+#include <math.h>
+#include <string.h>
 
 /**
  * Weather Icon Drawing System
  * Renders weather condition icons using simple geometric shapes
  * Based on SMHI Wsymb2 weather symbol codes (1-27)
  * Icons are composed of: sun, clouds, rain, snow, lightning, sleet
+ *
+ * The shapes are rasterized once per icon size into an atlas of
+ * RGB565 + A8 images in PSRAM (WeatherIconAtlas), and each card shows its
+ * icon as a single lv_img. The object-composed version below (4-12 lv_obj
+ * children per icon) is only used if the atlas can't be allocated.
  */
 
 // ------------------------------------------------------------------
@@ -130,7 +138,8 @@ static void draw_sleet(lv_obj_t *parent, int size) {
 }
 
 /**
- * Main Weather Icon Renderer
+ * Object-Composed Weather Icon
+ * Builds the icon from lv_obj shapes (fallback for draw_weather_icon)
  * Maps SMHI Wsymb2 symbol codes to visual representations
  *
  * Symbol codes:
@@ -142,7 +151,7 @@ static void draw_sleet(lv_obj_t *parent, int size) {
  * 12-14, 22-24: Sleet
  * 15-17, 25-27: Snow
  */
-static void draw_weather_icon(lv_obj_t *parent, int s, int size) {
+static void draw_weather_icon_objects(lv_obj_t *parent, int s, int size) {
   if (s == 1) {
     // Clear sky - sun only
     draw_sun(parent, (int)(size * 0.75), 0xFFD700);
@@ -183,3 +192,262 @@ static void draw_weather_icon(lv_obj_t *parent, int s, int size) {
     lv_obj_center(l);
   }
 }
+
+// ==================================================================
+// Icon Atlas
+// ==================================================================
+
+/**
+ * Icon Artwork
+ * Wsymb2 codes that share a picture share one atlas image
+ */
+enum WeatherIconArt : int8_t {
+  ICON_ART_NONE = -1,
+  ICON_ART_CLEAR = 0,
+  ICON_ART_PARTLY_CLOUDY,
+  ICON_ART_CLOUDY,
+  ICON_ART_RAIN,
+  ICON_ART_THUNDER,
+  ICON_ART_SLEET,
+  ICON_ART_SNOW,
+  ICON_ART_COUNT
+};
+
+static WeatherIconArt weather_icon_art(int s) {
+  if (s == 1)
+    return ICON_ART_CLEAR;
+  if (s >= 2 && s <= 4)
+    return ICON_ART_PARTLY_CLOUDY;
+  if (s >= 5 && s <= 7)
+    return ICON_ART_CLOUDY;
+  if ((s >= 8 && s <= 10) || (s >= 18 && s <= 20))
+    return ICON_ART_RAIN;
+  if (s == 11 || s == 21)
+    return ICON_ART_THUNDER;
+  if ((s >= 12 && s <= 14) || (s >= 22 && s <= 24))
+    return ICON_ART_SLEET;
+  if ((s >= 15 && s <= 17) || (s >= 25 && s <= 27))
+    return ICON_ART_SNOW;
+  return ICON_ART_NONE;
+}
+
+/**
+ * Weather Icon Atlas
+ * Pre-rasterized icons for one size, drawn with the same shapes, colours
+ * and offsets as draw_weather_icon_objects()
+ *
+ * Each image is (size + 10)^2 pixels of LV_IMG_CF_TRUE_COLOR_ALPHA
+ * (RGB565 + 8-bit alpha, 30 KB at size 90), matching the 100x100 icon box
+ * of the forecast cards. Images are rasterized on first use through a
+ * temporary lv_canvas and then shared by every card showing that weather.
+ */
+class WeatherIconAtlas {
+public:
+  explicit WeatherIconAtlas(int icon_size) : size(icon_size) {
+    memset(img, 0, sizeof(img));
+  }
+
+  int iconSize() const { return size; }
+
+  /**
+   * Image For Symbol
+   * Rasterizes on first use. LVGL thread only.
+   *
+   * @return nullptr for unknown symbols or when PSRAM is exhausted
+   */
+  const lv_img_dsc_t *get(int symbol) {
+    WeatherIconArt art = weather_icon_art(symbol);
+    if (art == ICON_ART_NONE)
+      return nullptr;
+    if (!img[art].data && !rasterize(art))
+      return nullptr;
+    return &img[art];
+  }
+
+  // PSRAM held by rasterized images
+  size_t memoryBytes() const {
+    size_t total = 0;
+    for (int i = 0; i < ICON_ART_COUNT; i++)
+      total += img[i].data_size;
+    return total;
+  }
+
+private:
+  int size;
+  lv_img_dsc_t img[ICON_ART_COUNT];
+
+  struct Painter {
+    lv_obj_t *canvas;
+    int cx, cy; // Icon box centre
+
+    // Filled rounded rect placed like LV_ALIGN_CENTER with offset dx/dy
+    void fill(int w, int h, int dx, int dy, lv_coord_t radius,
+              uint32_t color) const {
+      lv_draw_rect_dsc_t dsc;
+      lv_draw_rect_dsc_init(&dsc);
+      dsc.bg_color = lv_color_hex(color);
+      dsc.bg_opa = LV_OPA_COVER;
+      dsc.radius = radius;
+      lv_canvas_draw_rect(canvas, cx - w / 2 + dx, cy - h / 2 + dy, w, h,
+                          &dsc);
+    }
+
+    void sun(int d, uint32_t color) const {
+      fill(d, d, 0, 0, LV_RADIUS_CIRCLE, color);
+    }
+
+    void cloud(int s, int ox, int oy, uint32_t color) const {
+      fill((int)(s * 0.6), (int)(s * 0.6), ox, oy + 2, LV_RADIUS_CIRCLE,
+           color);
+      fill((int)(s * 0.4), (int)(s * 0.4), ox - (int)(s * 0.3), oy + 5,
+           LV_RADIUS_CIRCLE, color);
+      fill((int)(s * 0.45), (int)(s * 0.45), ox + (int)(s * 0.3), oy + 4,
+           LV_RADIUS_CIRCLE, color);
+      fill((int)(s * 0.7), (int)(s * 0.3), ox, oy + 8, 10, color);
+    }
+
+    void drops(int count, int spacing, int shift, int dy) const {
+      for (int i = 0; i < count; i++)
+        fill(4, 10, (i - 1) * spacing + shift, dy, 2, 0x209CEE);
+    }
+
+    void flakes(int count, int spacing, int shift, int dy) const {
+      for (int i = 0; i < count; i++)
+        fill(6, 6, (i - 1) * spacing + shift, dy, 3, 0xFFFFFF);
+    }
+
+    // 5x18 bar turned 30 degrees about its top-left corner (the transform
+    // pivot of the object version)
+    void bolt() const {
+      const float a = 30.0f * (float)M_PI / 180.0f;
+      const float ca = cosf(a), sa = sinf(a);
+      const int x0 = cx - 5 / 2, y0 = cy - 18 / 2 + 5;
+      const int corner[4][2] = {{0, 0}, {5, 0}, {5, 18}, {0, 18}};
+      lv_point_t pts[4];
+      for (int i = 0; i < 4; i++) {
+        pts[i].x = x0 + (lv_coord_t)lroundf(corner[i][0] * ca -
+                                             corner[i][1] * sa);
+        pts[i].y = y0 + (lv_coord_t)lroundf(corner[i][0] * sa +
+                                             corner[i][1] * ca);
+      }
+      lv_draw_rect_dsc_t dsc;
+      lv_draw_rect_dsc_init(&dsc);
+      dsc.bg_color = lv_color_hex(0xFFD700);
+      dsc.bg_opa = LV_OPA_COVER;
+      lv_canvas_draw_polygon(canvas, pts, 4, &dsc);
+    }
+  };
+
+  bool rasterize(WeatherIconArt art) {
+    const int box = size + 10;
+    uint32_t bytes = LV_CANVAS_BUF_SIZE_TRUE_COLOR_ALPHA(box, box);
+    uint8_t *buf = (uint8_t *)ps_malloc(bytes);
+    if (!buf)
+      buf = (uint8_t *)malloc(bytes);
+    if (!buf) {
+      Serial.printf("IconAtlas: no memory for %u byte icon\n",
+                    (unsigned)bytes);
+      return false;
+    }
+    memset(buf, 0, bytes); // Fully transparent
+
+    unsigned long start = micros();
+    lv_obj_t *canvas = lv_canvas_create(lv_layer_sys());
+    lv_canvas_set_buffer(canvas, buf, box, box, LV_IMG_CF_TRUE_COLOR_ALPHA);
+    lv_obj_add_flag(canvas, LV_OBJ_FLAG_HIDDEN);
+
+    Painter p = {canvas, box / 2, box / 2};
+    const int sun_d = (int)(size * 0.75);
+    switch (art) {
+    case ICON_ART_CLEAR:
+      p.sun(sun_d, 0xFFD700);
+      break;
+    case ICON_ART_PARTLY_CLOUDY:
+      p.sun(sun_d, 0xFFD700);
+      p.cloud(size, 8, 8, 0xFFFFFF);
+      break;
+    case ICON_ART_CLOUDY:
+      p.cloud(size, 0, 0, 0xBBBBBB);
+      break;
+    case ICON_ART_RAIN:
+      p.cloud(size, 0, 0, 0x888888);
+      p.drops(3, 8, 0, size / 2);
+      break;
+    case ICON_ART_THUNDER:
+      p.cloud(size, 0, 0, 0x555555);
+      p.drops(3, 8, 0, size / 2);
+      p.bolt();
+      break;
+    case ICON_ART_SLEET:
+      p.cloud(size, 0, 0, 0x888888);
+      p.drops(2, 12, -4, size / 2);
+      p.flakes(2, 12, 4, size / 2 + 2);
+      break;
+    case ICON_ART_SNOW:
+      p.cloud(size, 0, 0, 0xBBBBBB);
+      p.flakes(3, 10, 0, size / 2);
+      break;
+    default:
+      break;
+    }
+    lv_obj_del(canvas);
+
+    lv_img_dsc_t &d = img[art];
+    d.header.always_zero = 0;
+    d.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    d.header.w = box;
+    d.header.h = box;
+    d.data_size = bytes;
+    d.data = buf;
+    Serial.printf("IconAtlas: art %d at %d px rasterized in %lu us\n",
+                  (int)art, size, micros() - start);
+    return true;
+  }
+};
+
+static const int ICON_ATLAS_MAX_SIZES = 3;
+static WeatherIconAtlas *g_icon_atlases[ICON_ATLAS_MAX_SIZES] = {};
+
+/**
+ * Atlas For Size
+ * One atlas per icon size in use, created on first request
+ *
+ * @return nullptr once ICON_ATLAS_MAX_SIZES sizes are in use
+ */
+static WeatherIconAtlas *weather_icon_atlas(int size) {
+  for (int i = 0; i < ICON_ATLAS_MAX_SIZES; i++) {
+    if (!g_icon_atlases[i]) {
+      g_icon_atlases[i] = new WeatherIconAtlas(size);
+      return g_icon_atlases[i];
+    }
+    if (g_icon_atlases[i]->iconSize() == size)
+      return g_icon_atlases[i];
+  }
+  return nullptr;
+}
+
+#ifdef WEATHER_ICON_BENCH
+/**
+ * Main Weather Icon Renderer
+ * Shows the Wsymb2 icon as a single image from the atlas for that size,
+ * falling back to composing it from objects. Only iconBench.hpp creates
+ * icons this way; the forecast cards point their own image objects at the
+ * atlas (7dayForecast.hpp).
+ *
+ * @param parent Icon box (size + 10 square)
+ * @param s Wsymb2 symbol code
+ * @param size Icon size in pixels
+ */
+static void draw_weather_icon(lv_obj_t *parent, int s, int size) {
+  WeatherIconAtlas *atlas = weather_icon_atlas(size);
+  const lv_img_dsc_t *src = atlas ? atlas->get(s) : nullptr;
+
+  if (!src) {
+    draw_weather_icon_objects(parent, s, size);
+    return;
+  }
+  lv_obj_t *img = lv_img_create(parent);
+  lv_img_set_src(img, src);
+  lv_obj_center(img);
+}
+#endif // WEATHER_ICON_BENCH
@@ -0,0 +1,298 @@
+/**
+ * Arduino Core (simulator)
+ * The subset of the Arduino-ESP32 core that project/ uses, on top of the
+ * C++ standard library. Timing and Serial live in simArduino.cpp.
+ */
+#pragma once
+
+#ifndef __cplusplus
+// LVGL's C sources include this only for the tick (LV_TICK_CUSTOM_INCLUDE)
+unsigned long millis(void);
+#else
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <time.h>
+
+using std::max;
+using std::min;
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+extern "C" {
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+}
+
+template <typename T> static inline T constrain(T x, T lo, T hi) {
+  return x < lo ? lo : (x > hi ? hi : x);
+}
+static inline long map(long x, long in_min, long in_max, long out_min,
+                       long out_max) {
+  if (in_max == in_min)
+    return out_min;
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+char *dtostrf(double val, signed char width, unsigned char prec, char *sout);
+
+class String {
+public:
+  String() {}
+  String(const char *s) : s_(s ? s : "") {}
+  String(const std::string &s) : s_(s) {}
+  String(char c) : s_(1, c) {}
+  String(int v) : s_(std::to_string(v)) {}
+  String(unsigned v) : s_(std::to_string(v)) {}
+  String(long v) : s_(std::to_string(v)) {}
+  String(unsigned long v) : s_(std::to_string(v)) {}
+  String(long long v) : s_(std::to_string(v)) {}
+  String(unsigned long long v) : s_(std::to_string(v)) {}
+  String(float v, unsigned decimals = 2) { fmt(v, decimals); }
+  String(double v, unsigned decimals = 2) { fmt(v, decimals); }
+
+  const char *c_str() const { return s_.c_str(); }
+  unsigned length() const { return (unsigned)s_.size(); }
+  bool isEmpty() const { return s_.empty(); }
+  bool reserve(unsigned n) {
+    s_.reserve(n);
+    return true;
+  }
+  char operator[](unsigned i) const { return i < s_.size() ? s_[i] : 0; }
+  char &operator[](unsigned i) { return s_[i]; }
+  char charAt(unsigned i) const { return (*this)[i]; }
+
+  String &operator+=(const String &o) {
+    s_ += o.s_;
+    return *this;
+  }
+  String &operator+=(const char *o) {
+    s_ += o ? o : "";
+    return *this;
+  }
+  String &operator+=(char c) {
+    s_ += c;
+    return *this;
+  }
+  String &operator+=(int v) { return *this += String(v); }
+  bool concat(const String &o) {
+    s_ += o.s_;
+    return true;
+  }
+  bool concat(const char *o, unsigned n) {
+    s_.append(o, n);
+    return true;
+  }
+  bool concat(char c) {
+    s_ += c;
+    return true;
+  }
+
+  friend String operator+(const String &a, const String &b) {
+    return String(a.s_ + b.s_);
+  }
+  friend String operator+(const String &a, const char *b) {
+    return String(a.s_ + (b ? b : ""));
+  }
+  friend String operator+(const char *a, const String &b) {
+    return String(std::string(a ? a : "") + b.s_);
+  }
+  bool operator==(const String &o) const { return s_ == o.s_; }
+  bool operator==(const char *o) const { return s_ == (o ? o : ""); }
+  bool operator!=(const String &o) const { return s_ != o.s_; }
+  bool operator!=(const char *o) const { return !(*this == o); }
+  bool operator<(const String &o) const { return s_ < o.s_; }
+  bool equals(const String &o) const { return s_ == o.s_; }
+  bool equalsIgnoreCase(const String &o) const {
+    if (s_.size() != o.s_.size())
+      return false;
+    for (size_t i = 0; i < s_.size(); ++i)
+      if (tolower((unsigned char)s_[i]) != tolower((unsigned char)o.s_[i]))
+        return false;
+    return true;
+  }
+  bool startsWith(const String &p) const {
+    return s_.compare(0, p.s_.size(), p.s_) == 0;
+  }
+  bool endsWith(const String &p) const {
+    return s_.size() >= p.s_.size() &&
+           s_.compare(s_.size() - p.s_.size(), p.s_.size(), p.s_) == 0;
+  }
+  int indexOf(const String &n, unsigned from = 0) const {
+    size_t p = s_.find(n.s_, from);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  int indexOf(char c, unsigned from = 0) const {
+    size_t p = s_.find(c, from);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  String substring(unsigned from) const {
+    return from >= s_.size() ? String() : String(s_.substr(from));
+  }
+  String substring(unsigned from, unsigned to) const {
+    if (from > to)
+      std::swap(from, to);
+    if (from >= s_.size())
+      return String();
+    return String(s_.substr(from, std::min<size_t>(to, s_.size()) - from));
+  }
+  long toInt() const { return atol(s_.c_str()); }
+  float toFloat() const { return (float)atof(s_.c_str()); }
+  void toLowerCase() {
+    for (auto &c : s_)
+      c = (char)tolower((unsigned char)c);
+  }
+  void trim() {
+    size_t b = s_.find_first_not_of(" \t\r\n");
+    size_t e = s_.find_last_not_of(" \t\r\n");
+    s_ = b == std::string::npos ? std::string() : s_.substr(b, e - b + 1);
+  }
+  void clear() { s_.clear(); }
+  // ArduinoJson string adapter hooks
+  size_t write(uint8_t c) {
+    s_ += (char)c;
+    return 1;
+  }
+
+private:
+  std::string s_;
+  void fmt(double v, unsigned decimals) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+    s_ = buf;
+  }
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t n) {
+    size_t w = 0;
+    while (n--)
+      w += write(*buf++);
+    return w;
+  }
+  size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+  size_t print(const char *s) { return write(s); }
+  size_t print(const String &s) { return write(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return printf("%d", v); }
+  size_t print(unsigned v) { return printf("%u", v); }
+  size_t print(long v) { return printf("%ld", v); }
+  size_t print(unsigned long v) { return printf("%lu", v); }
+  size_t print(double v, int d = 2) { return printf("%.*f", d, v); }
+  size_t println() { return write("\n"); }
+  template <typename T> size_t println(const T &v) {
+    size_t n = print(v);
+    return n + println();
+  }
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[512];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n < 0)
+      return 0;
+    return write((const uint8_t *)buf, std::min<size_t>(n, sizeof(buf) - 1));
+  }
+};
+
+class Printable {
+public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print &p) const = 0;
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  size_t write(uint8_t) override { return 0; }
+  using Print::write;
+
+  void setTimeout(unsigned long ms) { timeout_ = ms; }
+  virtual size_t readBytes(char *buf, size_t n) {
+    size_t got = 0;
+    while (got < n) {
+      int c = timedRead();
+      if (c < 0)
+        break;
+      buf[got++] = (char)c;
+    }
+    return got;
+  }
+  size_t readBytes(uint8_t *buf, size_t n) { return readBytes((char *)buf, n); }
+  bool find(const char *target) {
+    size_t len = strlen(target), idx = 0;
+    if (!len)
+      return true;
+    while (true) {
+      int c = timedRead();
+      if (c < 0)
+        return false;
+      if (c == target[idx]) {
+        if (++idx == len)
+          return true;
+      } else {
+        idx = (c == target[0]) ? 1 : 0;
+      }
+    }
+  }
+
+protected:
+  unsigned long timeout_ = 1000;
+  int timedRead() {
+    unsigned long start = millis();
+    do {
+      int c = read();
+      if (c >= 0)
+        return c;
+      yield();
+    } while (millis() - start < timeout_);
+    return -1;
+  }
+};
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  void flush() { fflush(stdout); }
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *b, size_t n) override;
+  using Print::write;
+};
+extern HardwareSerial Serial;
+
+#include "esp32-hal-psram.h"
+#include "freertos/FreeRTOS.h"
+
+// Heap figures: a fixed SIM_HEAP_SIZE budget minus the bytes the host
+// allocator has handed out, so differences measure allocations
+#define SIM_HEAP_SIZE (16u * 1024u * 1024u)
+class EspClass {
+public:
+  uint32_t getHeapSize() { return SIM_HEAP_SIZE; }
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+  uint32_t getPsramSize() { return SIM_HEAP_SIZE; }
+  uint32_t getFreePsram() { return getFreeHeap(); }
+};
+extern EspClass ESP;
+
+#endif // __cplusplus
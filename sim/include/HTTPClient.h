@@ -0,0 +1,43 @@
+/**
+ * HTTPClient (simulator)
+ * GET answers with the fixture file at the URL's path under the fixture
+ * directory (same layout as tools/smhi_standin.py --fixtures), or 404.
+ * Time to first byte and bandwidth can be throttled (simNet.cpp).
+ */
+#pragma once
+#include <Arduino.h>
+#include <WiFiClient.h>
+
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_NOT_FOUND 404
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+
+class SimBodyStream;
+
+class HTTPClient {
+public:
+  HTTPClient() {}
+  ~HTTPClient() { end(); }
+  bool begin(WiFiClient &client, const String &url);
+  bool begin(const String &url);
+  void setTimeout(uint16_t ms) { timeout_ = ms; }
+  void setConnectTimeout(int32_t) {}
+  void setReuse(bool reuse) { reuse_ = reuse; }
+  void addHeader(const String &, const String &) {}
+  int GET();
+  int getSize() { return size_; }
+  Stream &getStream();
+  String getString();
+  void end();
+  bool connected() { return body_ != nullptr; }
+  static String errorToString(int code) {
+    return String("HTTP error ") + String(code);
+  }
+
+private:
+  String url_;
+  SimBodyStream *body_ = nullptr;
+  int size_ = -1;
+  uint16_t timeout_ = 5000;
+  bool reuse_ = false;
+};
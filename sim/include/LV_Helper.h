@@ -0,0 +1,24 @@
+/**
+ * LV_Helper (simulator)
+ * Same entry points as src/LV_Helper.h: registers the LilyGo_Display with
+ * LVGL (two 1/10-screen draw buffers, synchronous flush) and its touch
+ * points as a pointer input device (simDisplay.cpp)
+ */
+#pragma once
+#include <lvgl.h>
+
+#include "LilyGo_Display.h"
+
+/* Flush timing of beginLvglHelperDMA(), accumulated since the last reset */
+struct LvglFlushStats {
+  uint32_t frames;      // Refreshes (monitor_cb)
+  uint32_t areas;       // Areas flushed
+  uint64_t render_us;   // LVGL rendering between flushes
+  uint64_t transfer_us; // Areas copied into the framebuffer
+  uint64_t overlap_us;  // Always 0: the simulator flushes synchronously
+  uint64_t stall_us;    // Always 0
+};
+
+void beginLvglHelper(LilyGo_Display &board, bool debug = false);
+void beginLvglHelperDMA(LilyGo_Display &board, bool debug = false);
+void lvglHelperFlushStats(LvglFlushStats *out, bool reset);
@@ -0,0 +1,53 @@
+/**
+ * LilyGo AMOLED (simulator)
+ * The 536x240 T-Display AMOLED as an in-memory RGB565 framebuffer, with
+ * touch points supplied by the simulator's input script (simDisplay.cpp)
+ */
+#pragma once
+#include <Arduino.h>
+#include <vector>
+
+#include "LilyGo_Display.h"
+
+class LilyGo_AMOLED : public LilyGo_Display {
+public:
+  bool begin();
+  void setBrightness(uint8_t level) { _brightness = level; }
+  uint8_t getBrightness() { return _brightness; }
+
+  void setRotation(uint8_t rotation) override { _rotation = rotation & 3; }
+  uint8_t getRotation() override { return _rotation; }
+  void setAddrWindow(uint16_t xs, uint16_t ys, uint16_t xe,
+                     uint16_t ye) override;
+  void pushColors(uint16_t *data, uint32_t len) override;
+  void pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                  uint16_t *data) override;
+  void pushColorsDMA(uint16_t *data, uint32_t len) override {
+    pushColors(data, len);
+  }
+  uint16_t width() override { return (_rotation & 1) ? PANEL_H : PANEL_W; }
+  uint16_t height() override { return (_rotation & 1) ? PANEL_W : PANEL_H; }
+
+  uint8_t getPoint(int16_t *x, int16_t *y, uint8_t get_point = 1) override;
+  bool hasTouch() override { return true; }
+  bool needFullRefresh() override { return false; }
+
+  // Panel contents as sent (RGB565, byte-swapped like the bus), row-major
+  const uint16_t *framebuffer() const { return _fb.data(); }
+  // Pixels written since the last call
+  uint32_t takePixelsWritten();
+  // Binary PPM of the panel contents
+  bool writePPM(const char *path) const;
+
+private:
+  static const uint16_t PANEL_W = 536;
+  static const uint16_t PANEL_H = 240;
+
+  std::vector<uint16_t> _fb;
+  uint16_t _win_x1 = 0, _win_y1 = 0, _win_x2 = 0, _win_y2 = 0;
+  uint32_t _win_pos = 0;
+  uint32_t _written = 0;
+  uint8_t _brightness = 0;
+};
+
+#define LilyGo_Class LilyGo_AMOLED
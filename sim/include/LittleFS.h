@@ -0,0 +1,54 @@
+/**
+ * LittleFS (simulator)
+ * Paths map into <data>/littlefs (simStorage.cpp)
+ */
+#pragma once
+#include <Arduino.h>
+#include <dirent.h>
+
+class File {
+public:
+  File() {}
+  File(FILE *f, const String &path) : f_(f), path_(path) {}
+  // A directory opened with LittleFS.open(); see openNextFile()
+  File(DIR *d, const String &path) : d_(d), path_(path) {}
+  operator bool() const { return f_ != nullptr || d_ != nullptr; }
+  size_t read(uint8_t *buf, size_t n) { return f_ ? fread(buf, 1, n, f_) : 0; }
+  size_t write(const uint8_t *buf, size_t n) {
+    return f_ ? fwrite(buf, 1, n, f_) : 0;
+  }
+  bool seek(uint32_t pos) { return f_ && fseek(f_, (long)pos, SEEK_SET) == 0; }
+  size_t size();
+  bool isDirectory() const { return d_ != nullptr; }
+  const char *path() const { return path_.c_str(); }
+  const char *name() const {
+    const char *slash = strrchr(path_.c_str(), '/');
+    return slash ? slash + 1 : path_.c_str();
+  }
+  File openNextFile();
+  void close() {
+    if (f_)
+      fclose(f_);
+    if (d_)
+      closedir(d_);
+    f_ = nullptr;
+    d_ = nullptr;
+  }
+
+private:
+  FILE *f_ = nullptr;
+  DIR *d_ = nullptr;
+  String path_;
+};
+
+class LittleFSFS {
+public:
+  bool begin(bool formatOnFail = false);
+  File open(const String &path, const char *mode);
+  bool exists(const String &path);
+  bool remove(const String &path);
+  bool rename(const String &from, const String &to);
+  size_t totalBytes() { return 3 * 1024 * 1024; }
+  size_t usedBytes() { return 0; }
+};
+extern LittleFSFS LittleFS;
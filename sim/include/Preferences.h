@@ -0,0 +1,27 @@
+/**
+ * Preferences (simulator)
+ * One file per key under <data>/nvs/<namespace>/ (simStorage.cpp)
+ */
+#pragma once
+#include <Arduino.h>
+
+class Preferences {
+public:
+  bool begin(const char *name, bool readOnly = false);
+  void end() { open_ = false; }
+  String getString(const char *key, const String &def = String());
+  size_t putString(const char *key, const String &value);
+  int32_t getInt(const char *key, int32_t def = 0);
+  size_t putInt(const char *key, int32_t value);
+  size_t getBytesLength(const char *key);
+  size_t getBytes(const char *key, void *buf, size_t len);
+  size_t putBytes(const char *key, const void *buf, size_t len);
+  bool remove(const char *key);
+  bool clear();
+
+private:
+  String ns_;
+  bool ro_ = true;
+  bool open_ = false;
+  std::string path(const char *key) const;
+};
@@ -0,0 +1,2 @@
+// Included by project.ino but unused; nothing to provide in the simulator
+#pragma once
@@ -0,0 +1,47 @@
+/**
+ * WiFi (simulator)
+ * Always connected; host names resolve to loopback, since requests are
+ * answered from fixture files (simNet.cpp)
+ */
+#pragma once
+#include <Arduino.h>
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_CONNECTED = 3,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+typedef enum { WIFI_STA = 1 } wifi_mode_t;
+
+class IPAddress {
+public:
+  IPAddress() : v_(0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+      : v_(a | b << 8 | c << 16 | (uint32_t)d << 24) {}
+  operator uint32_t() const { return v_; }
+  String toString() const {
+    char b[16];
+    snprintf(b, sizeof(b), "%u.%u.%u.%u", v_ & 255, v_ >> 8 & 255,
+             v_ >> 16 & 255, v_ >> 24);
+    return String(b);
+  }
+
+private:
+  uint32_t v_;
+};
+
+class WiFiClass {
+public:
+  void mode(wifi_mode_t) {}
+  void begin(const char *, const char *) {}
+  bool disconnect(bool = false) { return true; }
+  wl_status_t status() { return WL_CONNECTED; }
+  int hostByName(const char *, IPAddress &ip) {
+    ip = IPAddress(127, 0, 0, 1);
+    return 1;
+  }
+};
+extern WiFiClass WiFi;
+
+// Host time is used as it is; no NTP
+static inline void configTime(long, int, const char *) {}
@@ -0,0 +1,29 @@
+/**
+ * WiFiClient (simulator)
+ * Connection state only; HTTPClient serves the bytes
+ */
+#pragma once
+#include <Arduino.h>
+#include <WiFi.h>
+
+class WiFiClient : public Stream {
+public:
+  virtual ~WiFiClient() {}
+  virtual int connect(const char *, uint16_t) {
+    connected_ = true;
+    return 1;
+  }
+  virtual int connect(IPAddress, uint16_t) {
+    connected_ = true;
+    return 1;
+  }
+  virtual uint8_t connected() { return connected_; }
+  virtual void stop() { connected_ = false; }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  operator bool() { return connected_; }
+
+protected:
+  bool connected_ = false;
+};
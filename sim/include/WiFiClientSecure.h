@@ -0,0 +1,12 @@
+/**
+ * WiFiClientSecure (simulator)
+ * No TLS; see WiFiClient.h
+ */
+#pragma once
+#include <WiFiClient.h>
+
+class WiFiClientSecure : public WiFiClient {
+public:
+  void setInsecure() {}
+  void setHandshakeTimeout(unsigned long) {}
+};
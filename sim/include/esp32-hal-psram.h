@@ -0,0 +1,12 @@
+/**
+ * PSRAM Allocation (simulator)
+ * One host heap: PSRAM requests are ordinary allocations
+ */
+#pragma once
+#include <stdbool.h>
+#include <stdlib.h>
+
+static inline bool psramFound() { return true; }
+static inline void *ps_malloc(size_t n) { return malloc(n); }
+static inline void *ps_calloc(size_t n, size_t s) { return calloc(n, s); }
+static inline void *ps_realloc(void *p, size_t n) { return realloc(p, n); }
@@ -0,0 +1,52 @@
+/**
+ * Simulator Internals
+ * State shared by the host implementations of the Arduino, network,
+ * storage and display shims (sim/include) and the script runner
+ */
+#pragma once
+#include <stdint.h>
+#include <string>
+
+struct SimOptions {
+  std::string fixtures;           // Recorded SMHI responses (URL path layout)
+  std::string data = "sim-data";  // LittleFS and Preferences contents
+  uint32_t ttfb_ms = 0;           // Delay before every response
+  uint32_t kbps = 0;              // Response bandwidth, 0 = unthrottled
+  bool quiet = false;             // Don't echo the device's Serial output
+  bool keep_serial = true;        // Keep Serial output for `expect`
+};
+extern SimOptions g_sim;
+
+// Serial: script input and captured output
+void sim_serial_inject(const std::string &text);
+size_t sim_serial_output_size();
+bool sim_serial_output_contains(const std::string &text, size_t from);
+void sim_log(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+// Heap: bytes handed out by the host allocator, and the highest sample
+size_t sim_heap_in_use();
+size_t sim_heap_peak();
+void sim_heap_sample();
+
+// Network totals
+struct SimNetStats {
+  uint32_t requests;
+  uint32_t not_found;
+  uint64_t bytes;
+};
+SimNetStats sim_net_stats();
+
+// Touch point read by LilyGo_AMOLED::getPoint()
+void sim_touch(bool pressed, int16_t x, int16_t y);
+
+// Display frames: refreshes and their durations (render_start to monitor)
+struct SimFrameStats {
+  uint32_t frames;
+  uint32_t areas;
+  uint64_t px;
+  uint64_t frame_us;   // Sum of frame times
+  uint64_t flush_us;   // Of which copying into the framebuffer
+  uint32_t p50_us, p95_us, max_us;
+};
+SimFrameStats sim_frame_stats();
+uint32_t sim_frame_count();
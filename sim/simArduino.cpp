@@ -0,0 +1,137 @@
+/**
+ * Arduino Core (simulator)
+ * Time, Serial and heap figures for the shims in sim/include/Arduino.h
+ */
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <malloc.h>
+#include <mutex>
+#include <thread>
+
+#include "sim.h"
+
+SimOptions g_sim;
+HardwareSerial Serial;
+EspClass ESP;
+
+// --------------------------------------------------------------------
+// Time
+// --------------------------------------------------------------------
+static const auto boot_time = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - boot_time)
+      .count();
+}
+
+unsigned long micros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - boot_time)
+      .count();
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield() { std::this_thread::yield(); }
+
+char *dtostrf(double val, signed char width, unsigned char prec, char *sout) {
+  sprintf(sout, "%*.*f", width, prec, val);
+  return sout;
+}
+
+// --------------------------------------------------------------------
+// Serial
+// Output goes to stdout (unless --quiet) and is kept for `expect`;
+// input comes from the script's `serial` command
+// --------------------------------------------------------------------
+static std::mutex serial_lock;
+static std::string serial_out;
+static std::deque<char> serial_in;
+
+size_t HardwareSerial::write(const uint8_t *b, size_t n) {
+  std::lock_guard<std::mutex> lock(serial_lock);
+  if (g_sim.keep_serial)
+    serial_out.append((const char *)b, n);
+  if (!g_sim.quiet)
+    fwrite(b, 1, n, stdout);
+  return n;
+}
+
+int HardwareSerial::available() {
+  std::lock_guard<std::mutex> lock(serial_lock);
+  return (int)serial_in.size();
+}
+
+int HardwareSerial::read() {
+  std::lock_guard<std::mutex> lock(serial_lock);
+  if (serial_in.empty())
+    return -1;
+  char c = serial_in.front();
+  serial_in.pop_front();
+  return (unsigned char)c;
+}
+
+int HardwareSerial::peek() {
+  std::lock_guard<std::mutex> lock(serial_lock);
+  return serial_in.empty() ? -1 : (unsigned char)serial_in.front();
+}
+
+void sim_serial_inject(const std::string &text) {
+  std::lock_guard<std::mutex> lock(serial_lock);
+  serial_in.insert(serial_in.end(), text.begin(), text.end());
+}
+
+size_t sim_serial_output_size() {
+  std::lock_guard<std::mutex> lock(serial_lock);
+  return serial_out.size();
+}
+
+bool sim_serial_output_contains(const std::string &text, size_t from) {
+  std::lock_guard<std::mutex> lock(serial_lock);
+  return serial_out.find(text, from) != std::string::npos;
+}
+
+void sim_log(const char *fmt, ...) {
+  char buf[512];
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  std::lock_guard<std::mutex> lock(serial_lock);
+  fprintf(stdout, "[sim] %s\n", buf);
+  fflush(stdout);
+}
+
+// --------------------------------------------------------------------
+// Heap
+// --------------------------------------------------------------------
+static std::atomic<size_t> heap_peak(0);
+
+size_t sim_heap_in_use() { return mallinfo2().uordblks; }
+
+size_t sim_heap_peak() { return heap_peak; }
+
+void sim_heap_sample() {
+  size_t used = sim_heap_in_use();
+  size_t peak = heap_peak.load();
+  while (used > peak && !heap_peak.compare_exchange_weak(peak, used)) {
+  }
+}
+
+static uint32_t heap_free(size_t used) {
+  return used < SIM_HEAP_SIZE ? (uint32_t)(SIM_HEAP_SIZE - used) : 0;
+}
+
+uint32_t EspClass::getFreeHeap() { return heap_free(sim_heap_in_use()); }
+
+uint32_t EspClass::getMinFreeHeap() {
+  sim_heap_sample();
+  return heap_free(heap_peak);
+}
+
+uint32_t EspClass::getMaxAllocHeap() { return getFreeHeap(); }
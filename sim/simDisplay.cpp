@@ -0,0 +1,213 @@
+/**
+ * Display (simulator)
+ * LilyGo_AMOLED as a framebuffer in memory, and the LV_Helper glue that
+ * registers it with LVGL together with the scripted touch input
+ */
+#include <Arduino.h>
+#include <LV_Helper.h>
+#include <LilyGo_AMOLED.h>
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include "sim.h"
+
+// --------------------------------------------------------------------
+// Panel
+// --------------------------------------------------------------------
+static std::mutex touch_lock;
+static bool touch_pressed = false;
+static int16_t touch_x = 0, touch_y = 0;
+
+void sim_touch(bool pressed, int16_t x, int16_t y) {
+  std::lock_guard<std::mutex> lock(touch_lock);
+  touch_pressed = pressed;
+  touch_x = x;
+  touch_y = y;
+}
+
+bool LilyGo_AMOLED::begin() {
+  _fb.assign((size_t)PANEL_W * PANEL_H, 0);
+  return true;
+}
+
+void LilyGo_AMOLED::setAddrWindow(uint16_t xs, uint16_t ys, uint16_t xe,
+                                  uint16_t ye) {
+  _win_x1 = xs;
+  _win_y1 = ys;
+  _win_x2 = xe;
+  _win_y2 = ye;
+  _win_pos = 0;
+}
+
+// Stream into the address window, row by row
+void LilyGo_AMOLED::pushColors(uint16_t *data, uint32_t len) {
+  uint32_t w = _win_x2 - _win_x1 + 1;
+  uint32_t h = _win_y2 - _win_y1 + 1;
+  for (uint32_t i = 0; i < len && _win_pos < w * h; i++, _win_pos++) {
+    uint32_t x = _win_x1 + _win_pos % w, y = _win_y1 + _win_pos / w;
+    if (x < PANEL_W && y < PANEL_H)
+      _fb[y * PANEL_W + x] = data[i];
+  }
+  _written += len;
+}
+
+void LilyGo_AMOLED::pushColors(uint16_t x, uint16_t y, uint16_t width,
+                               uint16_t height, uint16_t *data) {
+  if (_rotation & 1) { // Not how this panel is used; go pixel by pixel
+    setAddrWindow(x, y, x + width - 1, y + height - 1);
+    pushColors(data, (uint32_t)width * height);
+    return;
+  }
+  for (uint16_t row = 0; row < height && y + row < PANEL_H; row++) {
+    uint16_t n = std::min<uint16_t>(width, PANEL_W - x);
+    memcpy(&_fb[(size_t)(y + row) * PANEL_W + x], data + (size_t)row * width,
+           n * sizeof(uint16_t));
+  }
+  _written += (uint32_t)width * height;
+}
+
+uint8_t LilyGo_AMOLED::getPoint(int16_t *x, int16_t *y, uint8_t get_point) {
+  (void)get_point;
+  std::lock_guard<std::mutex> lock(touch_lock);
+  if (!touch_pressed)
+    return 0;
+  *x = touch_x;
+  *y = touch_y;
+  return 1;
+}
+
+uint32_t LilyGo_AMOLED::takePixelsWritten() {
+  uint32_t n = _written;
+  _written = 0;
+  return n;
+}
+
+bool LilyGo_AMOLED::writePPM(const char *path) const {
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+  fprintf(f, "P6\n%u %u\n255\n", PANEL_W, PANEL_H);
+  for (uint16_t c : _fb) {
+#if LV_COLOR_16_SWAP
+    c = (uint16_t)(c << 8 | c >> 8); // Bus byte order back to RGB565
+#endif
+    uint8_t rgb[3] = {(uint8_t)((c >> 11) * 255 / 31),
+                      (uint8_t)(((c >> 5) & 63) * 255 / 63),
+                      (uint8_t)((c & 31) * 255 / 31)};
+    fwrite(rgb, 1, 3, f);
+  }
+  return fclose(f) == 0;
+}
+
+// --------------------------------------------------------------------
+// LVGL glue
+// --------------------------------------------------------------------
+static lv_disp_draw_buf_t draw_buf;
+static lv_disp_drv_t disp_drv;
+static lv_indev_drv_t indev_drv;
+
+static LvglFlushStats flush_stats;   // lvglHelperFlushStats(), resettable
+static SimFrameStats frame_totals;   // Whole run
+static std::vector<uint32_t> frame_times;
+static uint32_t frame_start_us = 0;
+static uint32_t frame_flush_us = 0;
+
+static void disp_flush(lv_disp_drv_t *drv, const lv_area_t *area,
+                       lv_color_t *color_p) {
+  uint32_t t0 = micros();
+  uint32_t w = area->x2 - area->x1 + 1;
+  uint32_t h = area->y2 - area->y1 + 1;
+  static_cast<LilyGo_Display *>(drv->user_data)
+      ->pushColors(area->x1, area->y1, w, h, (uint16_t *)color_p);
+  uint32_t us = micros() - t0;
+  frame_flush_us += us;
+  flush_stats.transfer_us += us;
+  flush_stats.areas++;
+  frame_totals.areas++;
+  frame_totals.px += w * h;
+  lv_disp_flush_ready(drv);
+}
+
+static void disp_render_start(lv_disp_drv_t *drv) {
+  (void)drv;
+  frame_start_us = micros();
+  frame_flush_us = 0;
+}
+
+static void disp_monitor(lv_disp_drv_t *drv, uint32_t time, uint32_t px) {
+  (void)drv, (void)time, (void)px;
+  uint32_t us = micros() - frame_start_us;
+  flush_stats.frames++;
+  flush_stats.render_us += us - frame_flush_us;
+  frame_totals.frames++;
+  frame_totals.frame_us += us;
+  frame_totals.flush_us += frame_flush_us;
+  frame_times.push_back(us);
+}
+
+static void touchpad_read(lv_indev_drv_t *drv, lv_indev_data_t *data) {
+  int16_t x, y;
+  if (static_cast<LilyGo_Display *>(drv->user_data)->getPoint(&x, &y, 1)) {
+    data->point.x = x;
+    data->point.y = y;
+    data->state = LV_INDEV_STATE_PR;
+    return;
+  }
+  data->state = LV_INDEV_STATE_REL;
+}
+
+void beginLvglHelper(LilyGo_Display &board, bool debug) {
+  (void)debug;
+  lv_init();
+
+  // Two 1/10-screen buffers, like beginLvglHelperDMA() on the device
+  size_t pixels = (size_t)board.width() * board.height() / 10;
+  lv_color_t *buf1 = (lv_color_t *)malloc(pixels * sizeof(lv_color_t));
+  lv_color_t *buf2 = (lv_color_t *)malloc(pixels * sizeof(lv_color_t));
+  lv_disp_draw_buf_init(&draw_buf, buf1, buf2, pixels);
+
+  lv_disp_drv_init(&disp_drv);
+  disp_drv.hor_res = board.width();
+  disp_drv.ver_res = board.height();
+  disp_drv.flush_cb = disp_flush;
+  disp_drv.render_start_cb = disp_render_start;
+  disp_drv.monitor_cb = disp_monitor;
+  disp_drv.draw_buf = &draw_buf;
+  disp_drv.full_refresh = board.needFullRefresh();
+  disp_drv.user_data = &board;
+  lv_disp_drv_register(&disp_drv);
+
+  if (board.hasTouch()) {
+    lv_indev_drv_init(&indev_drv);
+    indev_drv.type = LV_INDEV_TYPE_POINTER;
+    indev_drv.read_cb = touchpad_read;
+    indev_drv.user_data = &board;
+    lv_indev_drv_register(&indev_drv);
+  }
+}
+
+void beginLvglHelperDMA(LilyGo_Display &board, bool debug) {
+  beginLvglHelper(board, debug);
+}
+
+void lvglHelperFlushStats(LvglFlushStats *out, bool reset) {
+  if (out)
+    *out = flush_stats;
+  if (reset)
+    memset(&flush_stats, 0, sizeof(flush_stats));
+}
+
+uint32_t sim_frame_count() { return frame_totals.frames; }
+
+SimFrameStats sim_frame_stats() {
+  SimFrameStats s = frame_totals;
+  if (!frame_times.empty()) {
+    std::vector<uint32_t> sorted = frame_times;
+    std::sort(sorted.begin(), sorted.end());
+    s.p50_us = sorted[sorted.size() / 2];
+    s.p95_us = sorted[sorted.size() * 95 / 100];
+    s.max_us = sorted.back();
+  }
+  return s;
+}
@@ -0,0 +1,234 @@
+/**
+ * Project Storm Simulator
+ * Runs project.ino's setup()/loop() on Linux against a framebuffer
+ * display, fixture-backed HTTP and a touch/serial input script, then
+ * reports frame times, heap use and network totals.
+ *
+ *   storm_sim [--fixtures DIR] [--data DIR] [--script FILE]
+ *             [--duration MS] [--ttfb-ms N] [--kbps N] [--quiet]
+ *             [--screenshot FILE.ppm]
+ *
+ * Script commands, one per line ('#' starts a comment):
+ *   wait MS                    keep looping for MS milliseconds
+ *   expect TEXT [TIMEOUT_MS]   loop until the Serial output contains TEXT
+ *   frame [TIMEOUT_MS]         loop until the next frame has been drawn
+ *   tap X Y                    press and release
+ *   press X Y / move X Y / release
+ *   swipe X1 Y1 X2 Y2 [MS]     press, drag over MS (default 300), release
+ *   serial TEXT                send TEXT to the device's Serial input
+ *   screenshot FILE.ppm        save the panel contents
+ *   mark NAME                  log the time since start
+ * expect and frame log how long they waited; a timeout fails the run.
+ */
+#include <Arduino.h>
+#include <LilyGo_AMOLED.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+#include "sim.h"
+
+void setup();
+void loop();
+extern LilyGo_Class amoled;
+
+static unsigned long run_start_ms = 0;
+
+// One pass of the sketch's loop
+static void step() {
+  loop();
+  sim_heap_sample();
+}
+
+static void run_for(unsigned long ms) {
+  unsigned long start = millis();
+  while (millis() - start < ms)
+    step();
+}
+
+// Loops until done() or timeout; logs and returns the wait in ms, or -1
+template <typename Fn>
+static long run_until(Fn done, unsigned long timeout_ms) {
+  unsigned long start = millis();
+  while (!done()) {
+    if (millis() - start >= timeout_ms)
+      return -1;
+    step();
+  }
+  return (long)(millis() - start);
+}
+
+static bool run_command(const std::string &line, int line_no) {
+  std::istringstream in(line);
+  std::string cmd;
+  in >> cmd;
+  if (cmd.empty() || cmd[0] == '#')
+    return true;
+
+  if (cmd == "wait") {
+    unsigned long ms = 0;
+    in >> ms;
+    run_for(ms);
+  } else if (cmd == "expect") {
+    std::string text;
+    in >> std::ws;
+    if (in.peek() == '"') { // Quoted text may contain spaces
+      in.get();
+      std::getline(in, text, '"');
+    } else {
+      in >> text;
+    }
+    unsigned long timeout = 30000;
+    in >> timeout;
+    size_t from = sim_serial_output_size();
+    long ms = run_until(
+        [&] { return sim_serial_output_contains(text, from); }, timeout);
+    if (ms < 0) {
+      sim_log("line %d: \"%s\" not seen within %lu ms", line_no, text.c_str(),
+              timeout);
+      return false;
+    }
+    sim_log("\"%s\" after %ld ms", text.c_str(), ms);
+  } else if (cmd == "frame") {
+    unsigned long timeout = 5000;
+    in >> timeout;
+    uint32_t frames = sim_frame_count();
+    long ms = run_until([&] { return sim_frame_count() != frames; }, timeout);
+    if (ms < 0) {
+      sim_log("line %d: no frame within %lu ms", line_no, timeout);
+      return false;
+    }
+    sim_log("frame after %ld ms", ms);
+  } else if (cmd == "tap") {
+    int x = 0, y = 0;
+    in >> x >> y;
+    sim_touch(true, x, y);
+    run_for(100);
+    sim_touch(false, x, y);
+    run_for(100);
+  } else if (cmd == "press" || cmd == "move") {
+    int x = 0, y = 0;
+    in >> x >> y;
+    sim_touch(true, x, y);
+    step();
+  } else if (cmd == "release") {
+    sim_touch(false, 0, 0);
+    step();
+  } else if (cmd == "swipe") {
+    int x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+    unsigned long ms = 300;
+    in >> x1 >> y1 >> x2 >> y2 >> ms;
+    unsigned long start = millis(), t;
+    while ((t = millis() - start) < ms) {
+      sim_touch(true, x1 + (x2 - x1) * (long)t / (long)ms,
+                y1 + (y2 - y1) * (long)t / (long)ms);
+      step();
+    }
+    sim_touch(true, x2, y2);
+    step();
+    sim_touch(false, x2, y2);
+    run_for(50);
+  } else if (cmd == "serial") {
+    std::string text;
+    std::getline(in >> std::ws, text);
+    sim_serial_inject(text);
+    step();
+  } else if (cmd == "screenshot") {
+    std::string path;
+    in >> path;
+    if (!amoled.writePPM(path.c_str())) {
+      sim_log("line %d: cannot write %s", line_no, path.c_str());
+      return false;
+    }
+  } else if (cmd == "mark") {
+    std::string name;
+    in >> name;
+    sim_log("mark %s at %lu ms", name.c_str(), millis() - run_start_ms);
+  } else {
+    sim_log("line %d: unknown command '%s'", line_no, cmd.c_str());
+    return false;
+  }
+  return true;
+}
+
+static void report() {
+  SimFrameStats f = sim_frame_stats();
+  SimNetStats n = sim_net_stats();
+  unsigned long ms = millis() - run_start_ms;
+  sim_log("run: %lu ms", ms);
+  if (f.frames) {
+    sim_log("frames: %u (%.1f/s), %u areas, %.1f px/frame", f.frames,
+            f.frames * 1000.0 / (ms ? ms : 1), f.areas,
+            (double)f.px / f.frames);
+    sim_log("frame time: avg %.2f ms (flush %.2f ms), p50 %.2f, p95 %.2f, "
+            "max %.2f ms",
+            f.frame_us / 1000.0 / f.frames, f.flush_us / 1000.0 / f.frames,
+            f.p50_us / 1000.0, f.p95_us / 1000.0, f.max_us / 1000.0);
+  }
+  sim_log("heap: %zu bytes in use, peak %zu", sim_heap_in_use(),
+          sim_heap_peak());
+  sim_log("http: %u requests, %u without fixture, %llu bytes", n.requests,
+          n.not_found, (unsigned long long)n.bytes);
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: storm_sim [--fixtures DIR] [--data DIR] [--script FILE]\n"
+          "                 [--duration MS] [--ttfb-ms N] [--kbps N] "
+          "[--quiet]\n"
+          "                 [--screenshot FILE.ppm]\n");
+}
+
+int main(int argc, char **argv) {
+  std::string script, screenshot;
+  unsigned long duration = 10000;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--fixtures" && has_value)
+      g_sim.fixtures = argv[++i];
+    else if (arg == "--data" && has_value)
+      g_sim.data = argv[++i];
+    else if (arg == "--script" && has_value)
+      script = argv[++i];
+    else if (arg == "--duration" && has_value)
+      duration = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--ttfb-ms" && has_value)
+      g_sim.ttfb_ms = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--kbps" && has_value)
+      g_sim.kbps = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--screenshot" && has_value)
+      screenshot = argv[++i];
+    else if (arg == "--quiet")
+      g_sim.quiet = true;
+    else {
+      usage();
+      return 2;
+    }
+  }
+
+  run_start_ms = millis();
+  setup();
+  sim_log("setup() done in %lu ms", millis() - run_start_ms);
+
+  bool ok = true;
+  if (script.empty()) {
+    run_for(duration);
+  } else {
+    std::ifstream in(script);
+    if (!in) {
+      sim_log("cannot open %s", script.c_str());
+      return 2;
+    }
+    std::string line;
+    for (int line_no = 1; ok && std::getline(in, line); line_no++)
+      ok = run_command(line, line_no);
+  }
+
+  if (!screenshot.empty() && !amoled.writePPM(screenshot.c_str()))
+    sim_log("cannot write %s", screenshot.c_str());
+  report();
+  fflush(stdout);
+  // The fetch worker thread never returns; leave without joining it
+  _exit(ok ? 0 : 1);
+}
@@ -0,0 +1,152 @@
+/**
+ * Network (simulator)
+ * HTTPClient answered from recorded responses on disk
+ */
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <atomic>
+
+#include "sim.h"
+
+WiFiClass WiFi;
+
+static std::atomic<uint32_t> net_requests(0);
+static std::atomic<uint32_t> net_not_found(0);
+static std::atomic<uint64_t> net_bytes(0);
+
+SimNetStats sim_net_stats() {
+  return {net_requests.load(), net_not_found.load(), net_bytes.load()};
+}
+
+/**
+ * Response Body
+ * Bytes become available as --kbps allows, counted from the first byte
+ */
+class SimBodyStream : public Stream {
+public:
+  explicit SimBodyStream(std::string body)
+      : data(std::move(body)), start_ms(millis()) {}
+
+  int available() override { return (int)(released() - pos); }
+
+  int read() override {
+    if (pos >= released())
+      return -1;
+    return (unsigned char)data[pos++];
+  }
+
+  int peek() override {
+    return pos < released() ? (unsigned char)data[pos] : -1;
+  }
+
+  size_t readBytes(char *buf, size_t n) override {
+    size_t got = 0;
+    unsigned long last = millis();
+    while (got < n && pos < data.size()) {
+      size_t avail = released() - pos;
+      if (avail == 0) {
+        if (millis() - last >= timeout_)
+          break;
+        delay(1);
+        continue;
+      }
+      size_t take = std::min(avail, n - got);
+      memcpy(buf + got, data.data() + pos, take);
+      pos += take;
+      got += take;
+      last = millis();
+    }
+    return got;
+  }
+
+  std::string rest() {
+    // Whole body: wait for it as a slow link would
+    while (released() < data.size())
+      delay(1);
+    std::string out = data.substr(pos);
+    pos = data.size();
+    return out;
+  }
+
+private:
+  std::string data;
+  size_t pos = 0;
+  unsigned long start_ms;
+
+  size_t released() const {
+    if (!g_sim.kbps)
+      return data.size();
+    uint64_t allowed =
+        (uint64_t)(millis() - start_ms) * g_sim.kbps * 1024 / 1000;
+    return (size_t)std::min<uint64_t>(allowed, data.size());
+  }
+};
+
+// Path of a URL without scheme, host and query
+static std::string url_path(const std::string &url) {
+  size_t start = url.find("://");
+  start = url.find('/', start == std::string::npos ? 0 : start + 3);
+  if (start == std::string::npos)
+    return "/";
+  size_t end = url.find('?', start);
+  return url.substr(start, end == std::string::npos ? end : end - start);
+}
+
+static bool read_file(const std::string &path, std::string &out) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f)
+    return false;
+  char buf[16384];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    out.append(buf, n);
+  fclose(f);
+  return true;
+}
+
+bool HTTPClient::begin(WiFiClient &client, const String &url) {
+  (void)client;
+  return begin(url);
+}
+
+bool HTTPClient::begin(const String &url) {
+  end();
+  url_ = url;
+  return true;
+}
+
+int HTTPClient::GET() {
+  end();
+  net_requests++;
+  std::string path = url_path(url_.c_str());
+  std::string body;
+  int code = HTTP_CODE_OK;
+  if (g_sim.fixtures.empty() || !read_file(g_sim.fixtures + path, body)) {
+    sim_log("no fixture for %s (404)", path.c_str());
+    net_not_found++;
+    body = "{\"error\":\"not found\"}";
+    code = HTTP_CODE_NOT_FOUND;
+  }
+  if (g_sim.ttfb_ms)
+    delay(g_sim.ttfb_ms);
+  net_bytes += body.size();
+  size_ = (int)body.size();
+  body_ = new SimBodyStream(std::move(body));
+  body_->setTimeout(timeout_);
+  return code;
+}
+
+Stream &HTTPClient::getStream() {
+  static SimBodyStream empty("");
+  return body_ ? *(Stream *)body_ : empty;
+}
+
+String HTTPClient::getString() {
+  return body_ ? String(body_->rest()) : String();
+}
+
+void HTTPClient::end() {
+  delete body_;
+  body_ = nullptr;
+  size_ = -1;
+}
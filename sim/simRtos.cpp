@@ -0,0 +1,90 @@
+/**
+ * FreeRTOS (simulator)
+ * Queues and mutexes on std::mutex/condition_variable, tasks on threads
+ */
+#include <Arduino.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct SimQueue {
+  std::mutex lock;
+  std::condition_variable ready;
+  std::deque<std::vector<char>> items;
+  size_t length, item_size;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+  SimQueue *q = new SimQueue;
+  q->length = length;
+  q->item_size = item_size;
+  return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t h, const void *item, TickType_t wait) {
+  (void)wait; // Only used with 0 (drop/replace when full)
+  SimQueue *q = (SimQueue *)h;
+  std::lock_guard<std::mutex> lock(q->lock);
+  if (q->items.size() >= q->length)
+    return pdFALSE;
+  const char *p = (const char *)item;
+  q->items.emplace_back(p, p + q->item_size);
+  q->ready.notify_one();
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t h, void *item, TickType_t wait) {
+  SimQueue *q = (SimQueue *)h;
+  std::unique_lock<std::mutex> lock(q->lock);
+  auto has_item = [q] { return !q->items.empty(); };
+  if (wait == portMAX_DELAY)
+    q->ready.wait(lock, has_item);
+  else if (wait)
+    q->ready.wait_for(lock, std::chrono::milliseconds(wait), has_item);
+  if (q->items.empty())
+    return pdFALSE;
+  memcpy(item, q->items.front().data(), q->item_size);
+  q->items.pop_front();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t h) {
+  SimQueue *q = (SimQueue *)h;
+  std::lock_guard<std::mutex> lock(q->lock);
+  return (UBaseType_t)q->items.size();
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name,
+                                   uint32_t stack, void *arg,
+                                   UBaseType_t prio, TaskHandle_t *out,
+                                   BaseType_t core) {
+  (void)name, (void)stack, (void)prio, (void)core;
+  std::thread *t = new std::thread(fn, arg);
+  t->detach();
+  if (out)
+    *out = t;
+  return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) { delay(ticks); }
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new std::timed_mutex; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t wait) {
+  std::timed_mutex *m = (std::timed_mutex *)s;
+  if (wait == portMAX_DELAY) {
+    m->lock();
+    return pdTRUE;
+  }
+  if (!wait)
+    return m->try_lock() ? pdTRUE : pdFALSE;
+  return m->try_lock_for(std::chrono::milliseconds(wait)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+  ((std::timed_mutex *)s)->unlock();
+  return pdTRUE;
+}
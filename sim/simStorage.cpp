@@ -0,0 +1,167 @@
+/**
+ * Storage (simulator)
+ * LittleFS and Preferences as plain files under --data
+ */
+#include <LittleFS.h>
+#include <Preferences.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "sim.h"
+
+LittleFSFS LittleFS;
+
+// mkdir -p
+static void make_dirs(const std::string &dir) {
+  for (size_t i = 1; i <= dir.size(); i++) {
+    if (i == dir.size() || dir[i] == '/')
+      mkdir(dir.substr(0, i).c_str(), 0755);
+  }
+}
+
+// --------------------------------------------------------------------
+// LittleFS
+// --------------------------------------------------------------------
+static std::string fs_path(const String &path) {
+  return g_sim.data + "/littlefs" + (path.startsWith("/") ? "" : "/") +
+         path.c_str();
+}
+
+size_t File::size() {
+  if (!f_)
+    return 0;
+  long pos = ftell(f_);
+  fseek(f_, 0, SEEK_END);
+  long end = ftell(f_);
+  fseek(f_, pos, SEEK_SET);
+  return end < 0 ? 0 : (size_t)end;
+}
+
+File File::openNextFile() {
+  while (d_) {
+    struct dirent *e = readdir(d_);
+    if (!e)
+      break;
+    if (e->d_name[0] == '.')
+      continue;
+    String child = path_ == "/" ? String("/") : path_ + "/";
+    child += e->d_name;
+    return LittleFS.open(child, "r");
+  }
+  return File();
+}
+
+bool LittleFSFS::begin(bool formatOnFail) {
+  (void)formatOnFail;
+  make_dirs(g_sim.data + "/littlefs");
+  return true;
+}
+
+File LittleFSFS::open(const String &path, const char *mode) {
+  std::string p = fs_path(path);
+  if (mode[0] == 'r') {
+    struct stat st;
+    if (stat(p.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+      return File(opendir(p.c_str()), path);
+  }
+  if (mode[0] == 'w' || mode[0] == 'a')
+    make_dirs(p.substr(0, p.rfind('/')));
+  bool update = mode[1] == '+';
+  FILE *f = fopen(p.c_str(), mode[0] == 'w'   ? (update ? "w+b" : "wb")
+                             : mode[0] == 'a' ? (update ? "a+b" : "ab")
+                                              : (update ? "r+b" : "rb"));
+  return f ? File(f, path) : File();
+}
+
+bool LittleFSFS::exists(const String &path) {
+  struct stat st;
+  return stat(fs_path(path).c_str(), &st) == 0;
+}
+
+bool LittleFSFS::remove(const String &path) {
+  return ::remove(fs_path(path).c_str()) == 0;
+}
+
+bool LittleFSFS::rename(const String &from, const String &to) {
+  return ::rename(fs_path(from).c_str(), fs_path(to).c_str()) == 0;
+}
+
+// --------------------------------------------------------------------
+// Preferences
+// --------------------------------------------------------------------
+std::string Preferences::path(const char *key) const {
+  return g_sim.data + "/nvs/" + ns_.c_str() + "/" + key;
+}
+
+bool Preferences::begin(const char *name, bool readOnly) {
+  ns_ = name;
+  ro_ = readOnly;
+  open_ = true;
+  if (!ro_)
+    make_dirs(g_sim.data + "/nvs/" + name);
+  return true;
+}
+
+size_t Preferences::getBytesLength(const char *key) {
+  struct stat st;
+  return open_ && stat(path(key).c_str(), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t len) {
+  FILE *f = open_ ? fopen(path(key).c_str(), "rb") : nullptr;
+  if (!f)
+    return 0;
+  size_t n = fread(buf, 1, len, f);
+  fclose(f);
+  return n;
+}
+
+size_t Preferences::putBytes(const char *key, const void *buf, size_t len) {
+  FILE *f = open_ && !ro_ ? fopen(path(key).c_str(), "wb") : nullptr;
+  if (!f)
+    return 0;
+  size_t n = fwrite(buf, 1, len, f);
+  fclose(f);
+  return n;
+}
+
+String Preferences::getString(const char *key, const String &def) {
+  size_t len = getBytesLength(key);
+  if (!len)
+    return def;
+  std::string s(len, '\0');
+  s.resize(getBytes(key, &s[0], len));
+  return String(s);
+}
+
+size_t Preferences::putString(const char *key, const String &value) {
+  return putBytes(key, value.c_str(), value.length());
+}
+
+int32_t Preferences::getInt(const char *key, int32_t def) {
+  int32_t v;
+  return getBytes(key, &v, sizeof(v)) == sizeof(v) ? v : def;
+}
+
+size_t Preferences::putInt(const char *key, int32_t value) {
+  return putBytes(key, &value, sizeof(value));
+}
+
+bool Preferences::remove(const char *key) {
+  return open_ && !ro_ && ::remove(path(key).c_str()) == 0;
+}
+
+bool Preferences::clear() {
+  if (!open_ || ro_)
+    return false;
+  std::string dir = g_sim.data + "/nvs/" + ns_.c_str();
+  DIR *d = opendir(dir.c_str());
+  if (!d)
+    return true;
+  while (struct dirent *e = readdir(d)) {
+    if (e->d_name[0] != '.')
+      ::remove((dir + "/" + e->d_name).c_str());
+  }
+  closedir(d);
+  return true;
+}
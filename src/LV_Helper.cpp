@@ -7,6 +7,7 @@
  * @note      Adapt to lvgl 8 version
  */
 #include <Arduino.h>
+#include <esp_timer.h>
 #include "LV_Helper.h"
 
 
@@ -30,16 +31,98 @@ static void disp_flush( lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color
     lv_disp_flush_ready( disp_drv );
 }
 
+/* Async flush: timing of the area in flight, see lvglHelperFlushStats() */
+static LvglFlushStats flush_stats;
+static volatile int64_t flush_done_us = 0;  // Written by the SPI interrupt
+static int64_t flush_queued_us = 0;         // Area handed to the DMA queue
+static int64_t render_end_us = 0;           // LVGL stopped rendering (0: still going)
+static int64_t wait_start_us = 0;           // LVGL started waiting for the bus
+static bool flush_in_flight = false;
+static bool flush_tail = false;             // Last area of the frame
+
+static void IRAM_ATTR disp_flush_done(void *arg)
+{
+    flush_done_us = esp_timer_get_time();
+    lv_disp_flush_ready((lv_disp_drv_t *)arg);
+}
+
+/* Book the previous area once it is known to be off the bus: LVGL renders
+ * the next area from the moment it was queued until render_end, so the part
+ * of that before the DMA finished was hidden behind the transfer */
+static void account_previous_area(int64_t now)
+{
+    if (!flush_in_flight) {
+        return;
+    }
+    int64_t render_end = render_end_us ? render_end_us : (wait_start_us ? wait_start_us : now);
+    int64_t done = flush_done_us;
+    flush_stats.transfer_us += done - flush_queued_us;
+    if (!flush_tail) {
+        flush_stats.render_us += render_end - flush_queued_us;
+    }
+    int64_t overlap_end = done < render_end ? done : render_end;
+    if (overlap_end > flush_queued_us) {
+        flush_stats.overlap_us += overlap_end - flush_queued_us;
+    }
+    if (!flush_tail && done > render_end) {
+        flush_stats.stall_us += done - render_end;
+    }
+    flush_in_flight = false;
+}
+
 static void disp_flushDMA( lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p )
 {
     uint32_t w = ( area->x2 - area->x1 + 1 );
     uint32_t h = ( area->y2 - area->y1 + 1 );
-    static_cast<LilyGo_Display *>(disp_drv->user_data)->setAddrWindow(area->x1, area->y1, area->x2, area->y2);
-    static_cast<LilyGo_Display *>(disp_drv->user_data)->pushColorsDMA((uint16_t *)color_p, w * h);
+    LilyGo_Display *board = static_cast<LilyGo_Display *>(disp_drv->user_data);
+
+    // The other buffer is free again by now: LVGL waited for it before calling
+    int64_t now = esp_timer_get_time();
+    account_previous_area(now);
+    wait_start_us = 0;
+    render_end_us = 0;
+    flush_tail = false;
+    flush_stats.areas++;
+
+    if (board->pushColorsAsync(area->x1, area->y1, w, h, (uint16_t *)color_p, disp_flush_done, disp_drv)) {
+        flush_queued_us = esp_timer_get_time();
+        flush_in_flight = true;
+        return;
+    }
 
+    board->pushColors(area->x1, area->y1, w, h, (uint16_t *)color_p);
+    flush_stats.transfer_us += esp_timer_get_time() - now;
     lv_disp_flush_ready( disp_drv );
 }
 
+/* LVGL is idle until the bus frees the buffer it wants to flush next */
+static void disp_waitDMA( lv_disp_drv_t *disp_drv )
+{
+    if (flush_in_flight && !wait_start_us) {
+        wait_start_us = esp_timer_get_time();
+    }
+}
+
+/* End of a frame: nothing else is rendered behind the last area */
+static void disp_monitorDMA( lv_disp_drv_t *disp_drv, uint32_t time, uint32_t px )
+{
+    flush_stats.frames++;
+    if (flush_in_flight && !render_end_us) {
+        render_end_us = esp_timer_get_time();
+        flush_tail = true;
+    }
+}
+
+void lvglHelperFlushStats(LvglFlushStats *out, bool reset)
+{
+    if (out) {
+        *out = flush_stats;
+    }
+    if (reset) {
+        memset(&flush_stats, 0, sizeof(flush_stats));
+    }
+}
+
 /*Read the touchpad*/
 static void touchpad_read( lv_indev_drv_t *indev_driver, lv_indev_data_t *data )
 {
@@ -120,6 +203,28 @@ static void lv_rounder_cb(lv_disp_drv_t *disp_drv, lv_area_t *area)
 }
 
 void beginLvglHelperDMA(LilyGo_Display &board, bool debug) {
+    // Panels that need full-frame refresh can't use partial buffers
+    if (board.needFullRefresh()) {
+        beginLvglHelper(board, debug);
+        return;
+    }
+
+    // Two bands of 1/10 screen in internal SRAM: LVGL renders into one while
+    // the other is on the QSPI bus
+    uint32_t lv_buffer_px = board.width() * board.height() / 10;
+    size_t lv_buffer_size = lv_buffer_px * sizeof(lv_color_t);
+
+    lv_color_t *buf1 = (lv_color_t *)heap_caps_malloc(lv_buffer_size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    lv_color_t *buf2 = (lv_color_t *)heap_caps_malloc(lv_buffer_size, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+
+    if (!buf1 || !buf2) {
+        Serial.println("Error: No internal DMA memory for draw buffers, using PSRAM");
+        free(buf1);
+        free(buf2);
+        beginLvglHelper(board, debug);
+        return;
+    }
+
     lv_init();
 
 #if LV_USE_LOG
@@ -128,18 +233,7 @@ void beginLvglHelperDMA(LilyGo_Display &board, bool debug) {
     }
 #endif
 
-    size_t lv_buffer_size = (board.width() * board.height() / 10) * sizeof(lv_color_t);
-
-    lv_color_t *buf1 = (lv_color_t *)heap_caps_malloc(lv_buffer_size, MALLOC_CAP_DMA);
-    lv_color_t *buf2 = (lv_color_t *)heap_caps_malloc(lv_buffer_size, MALLOC_CAP_DMA);
-
-    assert (buf1 && buf2);
-
-    if (!esp_ptr_dma_capable(buf1) || !esp_ptr_dma_capable(buf2)) {
-        Serial.println("Error: Buffers are not DMA-capable!");
-    }
-
-    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, board.width() * board.height() / 10);
+    lv_disp_draw_buf_init(&draw_buf, buf1, buf2, lv_buffer_px);
 
     /*Initialize the display*/
     lv_disp_drv_init( &disp_drv );
@@ -147,13 +241,12 @@ void beginLvglHelperDMA(LilyGo_Display &board, bool debug) {
     disp_drv.hor_res = board.width();
     disp_drv.ver_res = board.height();
     disp_drv.flush_cb = disp_flushDMA;
+    disp_drv.wait_cb = disp_waitDMA;
+    disp_drv.monitor_cb = disp_monitorDMA;
     disp_drv.draw_buf = &draw_buf;
-    bool full_refresh = board.needFullRefresh();
-    disp_drv.full_refresh = full_refresh;
+    disp_drv.full_refresh = false;
     disp_drv.user_data = &board;
-    if (!full_refresh) {
-        disp_drv.rounder_cb = lv_rounder_cb;
-    }
+    disp_drv.rounder_cb = lv_rounder_cb;
     lv_disp_drv_register( &disp_drv );
 
     if (board.hasTouch()) {
@@ -13,8 +13,19 @@
 #include "InputParams.h"
 
 
+/* Flush timing of beginLvglHelperDMA(), accumulated since the last reset */
+struct LvglFlushStats {
+    uint32_t frames;        // Refreshes (monitor_cb)
+    uint32_t areas;         // Areas flushed
+    uint64_t render_us;     // LVGL rendering between flushes
+    uint64_t transfer_us;   // Areas on the bus, queued to DMA done
+    uint64_t overlap_us;    // Rendering while the previous area was on the bus
+    uint64_t stall_us;      // Rendering done, waiting for the bus
+};
+
 void beginLvglHelper(LilyGo_Display &board, bool debug = false);
 void beginLvglHelperDMA(LilyGo_Display &board, bool debug = false);
+void lvglHelperFlushStats(LvglFlushStats *out, bool reset);
 void beginLvglInputDevice(struct InputParams prams);
 
 
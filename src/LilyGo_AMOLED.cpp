@@ -8,7 +8,9 @@
  */
 
 #include "LilyGo_AMOLED.h"
+#include "Rotate565.h"
 #include <driver/gpio.h>
+#include <hal/gpio_ll.h>
 
 #if ESP_ARDUINO_VERSION < ESP_ARDUINO_VERSION_VAL(3,0,0)
 #include <esp_adc_cal.h>
@@ -53,6 +55,12 @@ LilyGo_AMOLED::LilyGo_AMOLED() : boards(NULL), _hasRTC(false), _disableTouch(fal
     spiDev = NULL;
     pBuffer = NULL;
     spi = NULL;
+    _asyncPending = 0;
+    _asyncCs = -1;
+    _asyncDone = NULL;
+    _asyncArg = NULL;
+    _bounce[0] = _bounce[1] = NULL;
+    _bouncePixels = 0;
     _brightness = AMOLED_DEFAULT_BRIGHTNESS;
     // Prevent previously set hold
     switch (esp_sleep_get_wakeup_cause()) {
@@ -442,6 +450,7 @@ bool LilyGo_AMOLED::initBUS(DriverBusType type)
             .spics_io_num = -1,
             .flags = SPI_DEVICE_HALFDUPLEX,
             .queue_size = 17,
+            .post_cb = asyncTransDone,
         };
         esp_err_t ret = spi_bus_initialize(DEFAULT_SPI_HANDLER, &buscfg, SPI_DMA_CH_AUTO);
         if (ret != ESP_OK) {
@@ -834,6 +843,7 @@ void LilyGo_AMOLED::writeCommand(uint32_t cmd, uint8_t *pdat, uint32_t length)
     }
 
     // QSPI
+    waitAsync();
     setCS();
     spi_transaction_t t;
     memset(&t, 0, sizeof(t));
@@ -915,6 +925,7 @@ void LilyGo_AMOLED::pushColors(uint16_t *data, uint32_t len)
     uint16_t *p = data;
     assert(p);
     assert(spi);
+    waitAsync();
     setCS();
     do {
         size_t chunk_size = len;
@@ -952,15 +963,13 @@ void LilyGo_AMOLED::pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t
         uint16_t _y = x;
         uint16_t _h = width;
         uint16_t _w = hight;
-        uint16_t *p = data;
-        uint32_t cum = 0;
-        for (uint16_t j = 0; j < width; j++) {
-            for (uint16_t i = 0; i < hight; i++) {
-                pBuffer[cum] = ((uint16_t)p[width * (hight - i - 1) + j]);
-                cum++;
-            }
-        }
         setAddrWindow(_x, _y, _x + _w - 1, _y + _h - 1);
+        if (pushRotated(data, width, hight)) {
+            return;
+        }
+
+        // No bounce buffers: rotate the whole area into pBuffer first
+        rotate565_rows(pBuffer, data, width, hight, 1, 0, width);
         pushColors(pBuffer, width * hight);
     } else {
         setAddrWindow(x, y, x + width - 1, y + hight - 1);
@@ -973,6 +982,7 @@ void LilyGo_AMOLED::pushColorsDMA(uint16_t *data, uint32_t len)
     if (!spi) return;
 
     bool first_send = true;
+    waitAsync();
     setCS();
 
     while (len > 0) {
@@ -1017,6 +1027,165 @@ void LilyGo_AMOLED::pushColorsDMA(uint16_t *data, uint32_t len)
     clrCS();
 }
 
+// Rotate an area 90 degrees strip by strip into the internal-SRAM bounce
+// buffers and send each strip by DMA while the next one is transposed.
+// The address window must already be set.
+bool LilyGo_AMOLED::pushRotated(const uint16_t *data, uint16_t width, uint16_t hight)
+{
+    if (!spi) return false;
+
+    uint32_t strip_px = (uint32_t)ROTATE_STRIP_ROWS * hight;
+    if (!_bouncePixels) {
+        uint32_t px = (uint32_t)ROTATE_STRIP_ROWS * (_width > _height ? _width : _height);
+        _bounce[0] = (uint16_t *)heap_caps_malloc(px * sizeof(uint16_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        _bounce[1] = (uint16_t *)heap_caps_malloc(px * sizeof(uint16_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (!_bounce[0] || !_bounce[1]) {
+            log_e("No internal memory for rotation buffers");
+            free(_bounce[0]);
+            free(_bounce[1]);
+            _bounce[0] = _bounce[1] = NULL;
+        }
+        _bouncePixels = _bounce[0] ? px : 1;  // 1: don't try again
+    }
+    if (!_bounce[0] || strip_px > _bouncePixels || strip_px > SEND_BUF_SIZE) {
+        return false;
+    }
+
+    bool first_send = true;
+    uint8_t slot = 0, in_flight = 0;
+    spi_transaction_t *trans_result;
+    waitAsync();
+    setCS();
+    for (uint16_t row = 0; row < width; row += ROTATE_STRIP_ROWS) {
+        uint16_t rows = (width - row < ROTATE_STRIP_ROWS) ? width - row : ROTATE_STRIP_ROWS;
+
+        // Both strips queued: the older one has to be out before it is refilled
+        if (in_flight == 2) {
+            spi_device_get_trans_result(spi, &trans_result, portMAX_DELAY);
+            in_flight--;
+        }
+        rotate565_rows(_bounce[slot], data, width, hight, 1, row, rows);
+
+        spi_transaction_ext_t &t = _asyncTrans[slot];
+        memset(&t, 0, sizeof(t));
+        if (first_send) {
+            t.base.flags = SPI_TRANS_MODE_QIO;
+            t.base.cmd = 0x32;
+            t.base.addr = 0x002C00;
+            first_send = 0;
+        } else {
+            t.base.flags = SPI_TRANS_MODE_QIO | SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR | SPI_TRANS_VARIABLE_DUMMY;
+            t.command_bits = 0;
+            t.address_bits = 0;
+            t.dummy_bits = 0;
+        }
+        t.base.tx_buffer = _bounce[slot];
+        t.base.length = (uint32_t)rows * hight * 16;
+        if (spi_device_queue_trans(spi, &t.base, portMAX_DELAY) != ESP_OK) {
+            log_e("DMA transfer failed!");
+            break;
+        }
+        in_flight++;
+        slot ^= 1;
+    }
+    while (in_flight) {
+        spi_device_get_trans_result(spi, &trans_result, portMAX_DELAY);
+        in_flight--;
+    }
+    clrCS();
+    return true;
+}
+
+// Queue the pixels of one area as DMA chunks and return without waiting.
+// done(arg) is called from the SPI interrupt once the last chunk is out, so
+// the caller can render the next area while this one is on the bus.
+bool LilyGo_AMOLED::pushColorsAsync(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data,
+                                    void (*done)(void *arg), void *arg)
+{
+    // Rotated panels go through pBuffer, SPI panels have no transaction queue
+    if (!spi || boards->display.frameBufferSize) return false;
+
+    uint32_t len = (uint32_t)width * hight;
+    if (len == 0 || (len + SEND_BUF_SIZE - 1) / SEND_BUF_SIZE > ASYNC_MAX_CHUNKS) {
+        return false;
+    }
+
+    setAddrWindow(x, y, x + width - 1, y + hight - 1);  // Also collects the previous area
+
+    _asyncCs = boards->display.cs;
+    _asyncDone = done;
+    _asyncArg = arg;
+
+    bool first_send = true;
+    uint8_t queued = 0;
+    setCS();
+    while (len > 0) {
+        size_t chunk_size = len;
+        if (chunk_size > SEND_BUF_SIZE) {
+            chunk_size = SEND_BUF_SIZE;
+        }
+
+        spi_transaction_ext_t &t = _asyncTrans[queued];
+        memset(&t, 0, sizeof(t));
+        if (first_send) {
+            t.base.flags = SPI_TRANS_MODE_QIO;
+            t.base.cmd = 0x32;
+            t.base.addr = 0x002C00;
+            first_send = 0;
+        } else {
+            t.base.flags = SPI_TRANS_MODE_QIO | SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR | SPI_TRANS_VARIABLE_DUMMY;
+            t.command_bits = 0;
+            t.address_bits = 0;
+            t.dummy_bits = 0;
+        }
+        t.base.tx_buffer = data;
+        t.base.length = chunk_size * 16;
+        // Only the last chunk releases CS and reports completion
+        t.base.user = (chunk_size == len) ? this : NULL;
+
+        if (spi_device_queue_trans(spi, &t.base, portMAX_DELAY) != ESP_OK) {
+            log_e("DMA transfer failed!");
+            break;
+        }
+        queued++;
+        data += chunk_size;
+        len -= chunk_size;
+    }
+    _asyncPending = queued;
+
+    if (len > 0) {
+        // The last chunk never made it: finish here so the caller isn't left waiting
+        waitAsync();
+        clrCS();
+        done(arg);
+    }
+    return true;
+}
+
+// Collect the results of queued chunks; afterwards the bus is free for
+// polling transactions again
+void LilyGo_AMOLED::waitAsync()
+{
+    spi_transaction_t *trans_result;
+    while (_asyncPending) {
+        if (spi_device_get_trans_result(spi, &trans_result, portMAX_DELAY) != ESP_OK) {
+            log_e("DMA SPI transfer failed!");
+        }
+        _asyncPending--;
+    }
+}
+
+// SPI post-transaction callback (interrupt context, runs from IRAM)
+void IRAM_ATTR LilyGo_AMOLED::asyncTransDone(spi_transaction_t *t)
+{
+    LilyGo_AMOLED *self = (LilyGo_AMOLED *)t->user;
+    if (!self) return;
+    gpio_ll_set_level(&GPIO, (gpio_num_t)self->_asyncCs, 1);
+    if (self->_asyncDone) {
+        self->_asyncDone(self->_asyncArg);
+    }
+}
+
 float LilyGo_AMOLED::readCoreTemp()
 {
     return temperatureRead();
@@ -354,6 +354,8 @@ public:
     void pushColors(uint16_t *data, uint32_t len);
     void pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data);
     void pushColorsDMA(uint16_t *data, uint32_t len);
+    bool pushColorsAsync(uint16_t x, uint16_t y, uint16_t width, uint16_t hight, uint16_t *data,
+                         void (*done)(void *arg), void *arg);
 
     /**
      * @brief   Hang on SD card
@@ -425,8 +427,26 @@ private:
     void inline setCS();
     void inline clrCS();
     void writeCommand(uint32_t cmd, uint8_t *pdat, uint32_t length);
+    void waitAsync();
+    static void asyncTransDone(spi_transaction_t *t);
+    bool pushRotated(const uint16_t *data, uint16_t width, uint16_t hight);
     uint16_t *pBuffer;
     spi_device_handle_t spi;
+
+    // pushColorsAsync(): chunks queued on the SPI driver (they must stay
+    // valid until it is done with them) and the completion callback
+    static const uint8_t ASYNC_MAX_CHUNKS = 8;
+    spi_transaction_ext_t _asyncTrans[ASYNC_MAX_CHUNKS];
+    volatile uint8_t _asyncPending;
+    int _asyncCs;
+    void (*_asyncDone)(void *arg);
+    void *_asyncArg;
+
+    // pushRotated(): two internal-SRAM strips of ROTATE_STRIP_ROWS rotated
+    // rows, one being filled while the other is on the bus
+    static const uint16_t ROTATE_STRIP_ROWS = 16;
+    uint16_t *_bounce[2];
+    uint32_t _bouncePixels;
     uint8_t _brightness;
     const BoardsConfigure_t *boards;
     bool _touchOnline;
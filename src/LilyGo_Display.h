@@ -25,6 +25,13 @@ public:
     virtual void pushColors(uint16_t *data, uint32_t len) = 0;
     virtual void pushColors(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t *data) = 0;
     virtual void pushColorsDMA(uint16_t *data, uint32_t len) = 0;
+    // Queue an area and return at once; done(arg) runs from the transfer-complete
+    // interrupt. Returns false if the display can only push synchronously.
+    virtual bool pushColorsAsync(uint16_t /*x*/, uint16_t /*y*/, uint16_t /*width*/, uint16_t /*height*/,
+                                 uint16_t * /*data*/, void (* /*done*/)(void *arg), void * /*arg*/)
+    {
+        return false;
+    }
     virtual uint16_t  width() = 0;
     virtual uint16_t  height() = 0;
 
@@ -0,0 +1,127 @@
+/**
+ * @file      Rotate565.h
+ * @license   MIT
+ * @note      Cache-blocked RGB565 rotation used by LilyGo_AMOLED::pushColors.
+ *            Plain C++ without Arduino dependencies so it can be benchmarked
+ *            on a host (tools/rotate_bench.cpp).
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Rotations, clockwise:
+ *   0: dst[d][x] = src[d][x]
+ *   1: dst[d][x] = src[h - 1 - x][d]          ( 90, dst is h wide, w tall)
+ *   2: dst[d][x] = src[h - 1 - d][w - 1 - x]  (180)
+ *   3: dst[d][x] = src[x][w - 1 - d]          (270, dst is h wide, w tall)
+ *
+ * rotate565_rows() produces rows [row0, row0 + rows) of the rotated image,
+ * so an area can be rotated strip by strip into a small bounce buffer and
+ * each strip sent while the next one is built.
+ *
+ * The 90/270 transposes work in ROTATE565_TILE x ROTATE565_TILE tiles, so
+ * a tile's source rows stay in cache while its columns are read, instead of
+ * striding through the whole source for every output pixel. Pixels are
+ * moved in pairs with 32-bit loads and stores (each 2x2 block is two loads,
+ * two shuffles and two stores); odd sizes or unaligned buffers use the
+ * scalar path.
+ */
+
+#define ROTATE565_TILE  16
+
+static inline uint16_t rotate565_width(uint16_t w, uint16_t h, uint8_t rotation)
+{
+    return (rotation & 1) ? h : w;
+}
+
+static inline uint16_t rotate565_height(uint16_t w, uint16_t h, uint8_t rotation)
+{
+    return (rotation & 1) ? w : h;
+}
+
+// Reference version: one pixel at a time
+static inline void rotate565_rows_scalar(uint16_t *dst, const uint16_t *src, uint16_t w, uint16_t h,
+        uint8_t rotation, uint16_t row0, uint16_t rows)
+{
+    uint16_t dw = rotate565_width(w, h, rotation);
+    for (uint32_t d = row0; d < (uint32_t)row0 + rows; d++) {
+        uint16_t *out = dst + (d - row0) * dw;
+        for (uint32_t x = 0; x < dw; x++) {
+            switch (rotation & 3) {
+            case 0: out[x] = src[d * w + x]; break;
+            case 1: out[x] = src[(h - 1 - x) * w + d]; break;
+            case 2: out[x] = src[(h - 1 - d) * w + (w - 1 - x)]; break;
+            default: out[x] = src[x * w + (w - 1 - d)]; break;
+            }
+        }
+    }
+}
+
+static inline void rotate565_rows(uint16_t *dst, const uint16_t *src, uint16_t w, uint16_t h,
+                                  uint8_t rotation, uint16_t row0, uint16_t rows)
+{
+    rotation &= 3;
+    bool paired = !((w | h | row0 | rows) & 1) && !(((uintptr_t)dst | (uintptr_t)src) & 3);
+    if (!paired) {
+        rotate565_rows_scalar(dst, src, w, h, rotation, row0, rows);
+        return;
+    }
+
+    uint16_t dw = rotate565_width(w, h, rotation);
+    const uint32_t w2 = w / 2, dw2 = dw / 2; // Row lengths in pixel pairs
+    const uint32_t *s32 = (const uint32_t *)src;
+    uint32_t *d32 = (uint32_t *)dst;
+
+    if (rotation == 0) {
+        memcpy(dst, src + (uint32_t)row0 * w, (uint32_t)rows * w * sizeof(uint16_t));
+        return;
+    }
+
+    if (rotation == 2) {
+        // Each row reversed: pairs in reverse order, halves swapped
+        for (uint32_t d = 0; d < rows; d++) {
+            const uint32_t *in = s32 + (uint32_t)(h - 1 - row0 - d) * w2;
+            uint32_t *out = d32 + d * dw2;
+            for (uint32_t x = 0; x < dw2; x++) {
+                uint32_t a = in[w2 - 1 - x];
+                out[x] = (a >> 16) | (a << 16);
+            }
+        }
+        return;
+    }
+
+    // 90/270 in ROTATE565_TILE square tiles: destination rows (source
+    // columns) in pairs, source rows in pairs
+    for (uint32_t db = 0; db < rows; db += ROTATE565_TILE) {
+        uint32_t db_end = db + ROTATE565_TILE < rows ? db + ROTATE565_TILE : rows;
+        for (uint32_t t = 0; t < h; t += ROTATE565_TILE) {
+            uint32_t t_end = t + ROTATE565_TILE < h ? t + ROTATE565_TILE : h;
+            for (uint32_t d = db; d < db_end; d += 2) {
+                uint32_t *o0 = d32 + d * dw2;   // Destination row d
+                uint32_t *o1 = o0 + dw2;        // Destination row d + 1
+                if (rotation == 1) {
+                    // dst[d][x] = src[h-1-x][d]: source column pair (d, d+1)
+                    const uint32_t *col = s32 + (row0 + d) / 2;
+                    for (uint32_t r = t; r < t_end; r += 2) {
+                        uint32_t a = col[r * w2];        // src[r][d], src[r][d+1]
+                        uint32_t b = col[(r + 1) * w2];  // src[r+1][d], src[r+1][d+1]
+                        uint32_t x2 = (h - 2 - r) / 2;
+                        o0[x2] = (b & 0xFFFF) | (a << 16);
+                        o1[x2] = (b >> 16) | (a & 0xFFFF0000);
+                    }
+                } else {
+                    // dst[d][x] = src[x][w-1-d]: source column pair (w-2-d, w-1-d)
+                    const uint32_t *col = s32 + (w - 2 - row0 - d) / 2;
+                    for (uint32_t r = t; r < t_end; r += 2) {
+                        uint32_t a = col[r * w2];
+                        uint32_t b = col[(r + 1) * w2];
+                        o0[r / 2] = (a >> 16) | (b & 0xFFFF0000);
+                        o1[r / 2] = (a & 0xFFFF) | (b << 16);
+                    }
+                }
+            }
+        }
+    }
+}
@@ -316,7 +316,13 @@ e.g. "stm32f769xx.h" or "stm32f429xx.h"*/
 #define LV_ATTRIBUTE_TIMER_HANDLER
 
 /*Define a custom attribute to `lv_disp_flush_ready` function*/
+#ifdef ESP_PLATFORM
+/*Called from the SPI transfer-complete interrupt by the async flush (LV_Helper.cpp)*/
+#include "esp_attr.h"
+#define LV_ATTRIBUTE_FLUSH_READY IRAM_ATTR
+#else
 #define LV_ATTRIBUTE_FLUSH_READY
+#endif
 
 /*Required alignment size for buffers*/
 #define LV_ATTRIBUTE_MEM_ALIGN_SIZE 1
@@ -0,0 +1,202 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <vector>
+
+/**
+ * Baseline Parsers
+ * The ArduinoJson parsers the firmware used before the pull tokenizer
+ * (observations) and ForecastParser (pmp3g), kept only so parser_bench
+ * can report before/after figures on the same fixtures.
+ *
+ * Both cut each array element out of the stream into a char buffer and
+ * deserialize it with a filter into a small document. Observations become
+ * DataPoints with String date/time fields pushed into a std::vector, as
+ * weatherData used to hold them. The forecast parser keeps the first 12:00
+ * UTC step of each day and stops after seven, so it reads only part of
+ * the body.
+ *
+ * StaticJsonDocument<N> is an alias of the heap-backed JsonDocument in
+ * ArduinoJson 7 (the version the firmware builds against), so JsonDocument
+ * is used directly here.
+ */
+namespace baseline {
+
+struct DataPoint {
+  String date; // YYYY-MM-DD
+  String time; // HH:MM
+  float temp;
+};
+
+struct DayForecast {
+  String date;
+  float temp;
+  int symb;
+};
+
+static void epoch_ms_to_date_time(uint64_t ms, String &outDate,
+                                  String &outTime) {
+  time_t t = (time_t)(ms / 1000);
+  struct tm tmres;
+  gmtime_r(&t, &tmres);
+  char dBuf[36]; // Any int fields fit (-Wformat-truncation)
+  char tBuf[24];
+  snprintf(dBuf, sizeof(dBuf), "%04d-%02d-%02d", tmres.tm_year + 1900,
+           tmres.tm_mon + 1, tmres.tm_mday);
+  snprintf(tBuf, sizeof(tBuf), "%02d:%02d", tmres.tm_hour, tmres.tm_min);
+  outDate = dBuf;
+  outTime = tBuf;
+}
+
+static float value_to_float(JsonVariant val) {
+  if (val.isNull())
+    return 0.0f;
+  if (val.is<const char *>())
+    return atof(val.as<const char *>());
+  if (val.is<float>())
+    return val.as<float>();
+  if (val.is<int>())
+    return (float)val.as<int>();
+  return val.as<String>().toFloat();
+}
+
+/**
+ * Read Next JSON Object
+ * Copies one {...} element of an array into buffer (string-aware brace
+ * matching); false at the closing ']' or on overflow/timeout
+ */
+static bool read_next_object(Stream &stream, char *buffer, size_t bufSize) {
+  size_t pos = 0;
+  int braceCount = 0;
+  bool started = false;
+  bool inString = false;
+  bool escaped = false;
+  unsigned long timeout = millis() + 10000;
+
+  while (millis() < timeout) {
+    if (!stream.available()) {
+      delay(1);
+      continue;
+    }
+    char c = stream.read();
+    if (!escaped && c == '"')
+      inString = !inString;
+    escaped = (!escaped && c == '\\');
+
+    if (!started) {
+      if (c == '{') {
+        started = true;
+        braceCount = 1;
+        buffer[pos++] = c;
+      } else if (c == ']') {
+        return false;
+      }
+      continue;
+    }
+    if (pos >= bufSize - 1)
+      return false; // The old parser skipped the object and stopped too
+    buffer[pos++] = c;
+    if (!inString) {
+      if (c == '{') {
+        braceCount++;
+      } else if (c == '}' && --braceCount == 0) {
+        buffer[pos] = '\0';
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * Observations
+ * One filtered document per element of the "value" array
+ */
+static bool parse_observations(Stream &stream, std::vector<DataPoint> &out) {
+  out.clear();
+  if (!stream.find("\"value\"") || !stream.find("["))
+    return false;
+
+  JsonDocument filter;
+  filter["date"] = true;
+  filter["value"] = true;
+  filter["ref"] = true;
+  filter["from"] = true;
+
+  char objBuffer[256];
+  while (read_next_object(stream, objBuffer, sizeof(objBuffer))) {
+    JsonDocument doc;
+    if (deserializeJson(doc, objBuffer, DeserializationOption::Filter(filter)))
+      continue;
+
+    DataPoint dp;
+    if (doc["date"].is<uint64_t>() && !doc["value"].isNull()) {
+      epoch_ms_to_date_time(doc["date"].as<uint64_t>(), dp.date, dp.time);
+    } else if (!doc["ref"].isNull() && !doc["value"].isNull()) {
+      dp.date = doc["ref"].as<String>();
+      dp.time = "12:00";
+    } else if (doc["from"].is<uint64_t>() && !doc["value"].isNull()) {
+      epoch_ms_to_date_time(doc["from"].as<uint64_t>(), dp.date, dp.time);
+    } else {
+      continue;
+    }
+    dp.temp = value_to_float(doc["value"]);
+    out.push_back(dp);
+  }
+  return !out.empty();
+}
+
+static bool param_value(JsonArray params, const char *name, JsonVariant &out) {
+  for (JsonObject p : params) {
+    if (strcmp(p["name"] | "", name) == 0 && p["values"].is<JsonArray>() &&
+        p["values"].size() > 0) {
+      out = p["values"][0];
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * pmp3g Forecast
+ * Noon (12:00 UTC) temperature and Wsymb2 for up to seven days
+ */
+static bool parse_forecast(Stream &stream, std::vector<DayForecast> &out) {
+  out.clear();
+  if (!stream.find("\"timeSeries\"") || !stream.find("["))
+    return false;
+
+  JsonDocument filter;
+  filter["validTime"] = true;
+  filter["parameters"][0]["name"] = true;
+  filter["parameters"][0]["values"][0] = true;
+
+  static char jsonBuf[4096]; // Was on the stack of the forecast fetch
+  JsonDocument chunkDoc;
+  String lastDate = "";
+
+  while (out.size() < 7 &&
+         read_next_object(stream, jsonBuf, sizeof(jsonBuf))) {
+    chunkDoc.clear();
+    if (deserializeJson(chunkDoc, jsonBuf,
+                        DeserializationOption::Filter(filter)))
+      continue;
+    String vt = chunkDoc["validTime"] | "";
+    if (vt.length() < 16)
+      continue;
+    int hour = vt.substring(11, 13).toInt();
+    String date = vt.substring(0, 10);
+    if (hour != 12 || date == lastDate)
+      continue;
+
+    JsonArray params = chunkDoc["parameters"].as<JsonArray>();
+    JsonVariant t, sym;
+    if (param_value(params, "t", t) && param_value(params, "Wsymb2", sym)) {
+      out.push_back({date, t.as<float>(), sym.as<int>()});
+      lastDate = date;
+    }
+  }
+  return !out.empty();
+}
+
+} // namespace baseline
@@ -0,0 +1,242 @@
+#!/usr/bin/env python3
+"""
+Generate project/stations.hpp, project/stationParams.hpp and
+project/stationGrid.hpp from SMHI metobs metadata.
+
+stations.hpp is the station list compiled into the firmware (every station
+of the temperature parameter, sorted by name). stationParams.hpp is a table
+parallel to it: for each station a bitmask of the parameters it is active
+for and the first/last observation time of any parameter. With the table
+compiled in, the settings tile knows which stations are inactive and which
+parameters each one offers without a single request at boot; the firmware
+still checks the live metadata in the background (paramIndex.hpp).
+stationGrid.hpp buckets the same rows into a fixed latitude/longitude grid
+for the nearest-station queries in stationPicker.hpp.
+
+All files are written together so their row order always matches.
+
+Usage:
+  tools/gen_stations.py [--base-url https://opendata-download-metobs.smhi.se]
+                        [--params 1,2,...] [--insecure]
+
+Point --base-url at tools/smhi_standin.py (with --insecure) to try the
+pipeline offline.
+"""
+
+import argparse
+import json
+import math
+import os
+import ssl
+import sys
+import time
+import urllib.request
+
+DEFAULT_BASE = "https://opendata-download-metobs.smhi.se"
+# Same order as PARAM_CODES in project/settingsTile.hpp
+DEFAULT_PARAMS = ("1,2,3,4,5,6,7,8,9,10,11,12,13,14,16,17,18,19,20,21,22,23,"
+                  "24,25,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40")
+STATION_LIST_PARAM = 1  # stations.hpp lists every station of this parameter
+# stationGrid.hpp cell size in degrees (about 55 x 40-64 km over Sweden)
+GRID_DLAT = 0.5
+GRID_DLON = 1.0
+
+
+def fetch_parameter(base, code, ctx):
+    url = "%s/api/version/1.0/parameter/%d.json" % (base.rstrip("/"), code)
+    for attempt in range(3):
+        try:
+            with urllib.request.urlopen(url, timeout=60, context=ctx) as r:
+                return json.load(r)
+        except OSError as e:
+            if attempt == 2:
+                raise
+            sys.stderr.write("retrying %s: %s\n" % (url, e))
+            time.sleep(2)
+
+
+def c_string(s):
+    return s.replace("\\", "\\\\").replace('"', '\\"')
+
+
+def write_stations(path, stations):
+    with open(path, "w", encoding="utf-8") as f:
+        f.write("// Generated by tools/gen_stations.py - do not edit\n")
+        f.write("#pragma once\n#include <stddef.h>\n#include <stdint.h>\n\n")
+        f.write("struct StationInfo {\n")
+        f.write("  const char *id;\n")
+        f.write("  const char *name; // UTF-8\n")
+        f.write("  float lat;\n")
+        f.write("  float lon;\n")
+        f.write("};\n\n")
+        f.write("// Sorted by name\n")
+        f.write("static constexpr StationInfo STATIONS[] = {\n")
+        for s in stations:
+            f.write('  {"%s", "%s", %.5ff, %.5ff},\n' % (
+                s["key"], c_string(s["name"]), s["lat"], s["lon"]))
+        f.write("};\n")
+        f.write("static constexpr size_t STATION_COUNT = "
+                "sizeof(STATIONS) / sizeof(STATIONS[0]);\n\n")
+        # Ids are ASCII digits, so this is strcmp() order
+        by_id = sorted(range(len(stations)), key=lambda i: stations[i]["key"])
+        f.write("// STATIONS[] indices in strcmp() order of their ids\n")
+        f.write("static constexpr uint16_t STATION_ID_ORDER[] = {\n")
+        for k in range(0, len(by_id), 12):
+            f.write("  " + ", ".join(str(i) for i in by_id[k:k + 12]) + ",\n")
+        f.write("};\n")
+
+
+def write_params(path, stations, codes, generated):
+    with open(path, "w", encoding="utf-8") as f:
+        f.write("// Generated by tools/gen_stations.py - do not edit\n")
+        f.write("#pragma once\n#include <stdint.h>\n\n")
+        f.write('#include "stations.hpp"\n\n')
+        f.write("// Parameter code behind each bit of StationParams::mask\n")
+        f.write("static constexpr int16_t STATION_PARAM_CODES[] = {%s};\n" %
+                ", ".join(str(c) for c in codes))
+        f.write("static constexpr size_t STATION_PARAM_CODE_COUNT = %d;\n" %
+                len(codes))
+        f.write("// Metadata download time (epoch seconds)\n")
+        f.write("static constexpr int32_t STATION_PARAMS_GENERATED = %d;\n\n"
+                % generated)
+        f.write("struct StationParams {\n")
+        f.write("  uint64_t mask; // Parameters the station is active for\n")
+        f.write("  int32_t from;  // First observation, any parameter "
+                "(epoch s)\n")
+        f.write("  int32_t to;    // Last observation, any parameter "
+                "(epoch s)\n")
+        f.write("};\n\n")
+        f.write("// Same order as STATIONS[]\n")
+        f.write("static constexpr StationParams STATION_PARAMS[] = {\n")
+        for s in stations:
+            f.write("  {0x%016xULL, %d, %d}, // %s\n" % (
+                s["mask"], s["from"], s["to"], s["key"]))
+        f.write("};\n")
+        f.write("static_assert(sizeof(STATION_PARAMS) / "
+                "sizeof(STATION_PARAMS[0]) ==\n"
+                "                  sizeof(STATIONS) / sizeof(STATIONS[0]),\n"
+                '              "regenerate stations.hpp and stationParams.hpp '
+                'together");\n')
+
+
+def write_grid(path, stations):
+    # Grid origin and extent snapped to whole cells around the stations
+    lat0 = math.floor(min(s["lat"] for s in stations) / GRID_DLAT) * GRID_DLAT
+    lon0 = math.floor(min(s["lon"] for s in stations) / GRID_DLON) * GRID_DLON
+    rows = int((max(s["lat"] for s in stations) - lat0) // GRID_DLAT) + 1
+    cols = int((max(s["lon"] for s in stations) - lon0) // GRID_DLON) + 1
+
+    cells = [[] for _ in range(rows * cols)]
+    for i, s in enumerate(stations):
+        r = int((s["lat"] - lat0) // GRID_DLAT)
+        c = int((s["lon"] - lon0) // GRID_DLON)
+        cells[r * cols + c].append(i)
+    start = [0]
+    for cell in cells:
+        start.append(start[-1] + len(cell))
+    ids = [i for cell in cells for i in cell]
+
+    def rows_of(values, per_line=12):
+        out = []
+        for k in range(0, len(values), per_line):
+            out.append("  " + ", ".join(str(v) for v in
+                                        values[k:k + per_line]) + ",\n")
+        return "".join(out)
+
+    with open(path, "w", encoding="utf-8") as f:
+        f.write("// Generated by tools/gen_stations.py - do not edit\n")
+        f.write("#pragma once\n#include <stdint.h>\n\n")
+        f.write('#include "stations.hpp"\n\n')
+        f.write("// Cell (row, col) covers latitudes LAT0 + row * DLAT and up,\n"
+                "// longitudes LON0 + col * DLON and up\n")
+        f.write("static constexpr float STATION_GRID_LAT0 = %.1ff;\n" % lat0)
+        f.write("static constexpr float STATION_GRID_LON0 = %.1ff;\n" % lon0)
+        f.write("static constexpr float STATION_GRID_DLAT = %.1ff;\n" %
+                GRID_DLAT)
+        f.write("static constexpr float STATION_GRID_DLON = %.1ff;\n" %
+                GRID_DLON)
+        f.write("static constexpr int STATION_GRID_ROWS = %d;\n" % rows)
+        f.write("static constexpr int STATION_GRID_COLS = %d;\n\n" % cols)
+        f.write("// Cell row * COLS + col holds STATION_GRID_IDS[START[cell] .. "
+                "START[cell + 1])\n")
+        f.write("static constexpr uint16_t STATION_GRID_START[] = {\n")
+        f.write(rows_of(start))
+        f.write("};\n")
+        f.write("// STATIONS[] indices, grouped by cell\n")
+        f.write("static constexpr uint16_t STATION_GRID_IDS[] = {\n")
+        f.write(rows_of(ids))
+        f.write("};\n")
+        f.write("static_assert(sizeof(STATION_GRID_IDS) / "
+                "sizeof(STATION_GRID_IDS[0]) ==\n"
+                "                  sizeof(STATIONS) / sizeof(STATIONS[0]),\n"
+                '              "regenerate stations.hpp and stationGrid.hpp '
+                'together");\n')
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    project = os.path.join(here, "..", "project")
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("--base-url", default=DEFAULT_BASE)
+    ap.add_argument("--params", default=DEFAULT_PARAMS,
+                    help="parameter codes, bit n = n-th code (max 64)")
+    ap.add_argument("--insecure", action="store_true",
+                    help="skip certificate checks (local stand-in)")
+    ap.add_argument("--out-dir", default=project)
+    opts = ap.parse_args()
+
+    codes = [int(p) for p in opts.params.split(",") if p]
+    if len(codes) > 64:
+        ap.error("at most 64 parameters fit the mask")
+    ctx = ssl.create_default_context()
+    if opts.insecure:
+        ctx.check_hostname = False
+        ctx.verify_mode = ssl.CERT_NONE
+
+    stations = {}  # key -> row
+    per_param = {}
+    for code in codes:
+        doc = fetch_parameter(opts.base_url, code, ctx)
+        per_param[code] = doc.get("station", [])
+        sys.stderr.write("parameter %d: %d stations\n" %
+                         (code, len(per_param[code])))
+
+    for st in per_param.get(STATION_LIST_PARAM, []):
+        key = str(st.get("key", st.get("id")))
+        stations[key] = {"key": key, "name": st["name"],
+                         "lat": float(st["latitude"]),
+                         "lon": float(st["longitude"]),
+                         "mask": 0, "from": 0, "to": 0}
+
+    for bit, code in enumerate(codes):
+        for st in per_param[code]:
+            row = stations.get(str(st.get("key", st.get("id"))))
+            if row is None:
+                continue
+            if st.get("active"):
+                row["mask"] |= 1 << bit
+            # Metadata times are epoch milliseconds
+            lo = int(st.get("from", 0)) // 1000
+            hi = int(st.get("to", 0)) // 1000
+            if lo and (not row["from"] or lo < row["from"]):
+                row["from"] = lo
+            if hi > row["to"]:
+                row["to"] = hi
+
+    rows = sorted(stations.values(), key=lambda s: s["name"])
+    for s in rows:
+        s["from"] = max(-2**31, min(2**31 - 1, s["from"]))
+        s["to"] = max(-2**31, min(2**31 - 1, s["to"]))
+
+    os.makedirs(opts.out_dir, exist_ok=True)
+    write_stations(os.path.join(opts.out_dir, "stations.hpp"), rows)
+    write_params(os.path.join(opts.out_dir, "stationParams.hpp"), rows, codes,
+                 int(time.time()))
+    write_grid(os.path.join(opts.out_dir, "stationGrid.hpp"), rows)
+    active = sum(1 for s in rows if s["mask"])
+    print("%d stations (%d active) x %d parameters" %
+          (len(rows), active, len(codes)))
+
+
+if __name__ == "__main__":
+    main()
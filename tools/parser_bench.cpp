@@ -0,0 +1,403 @@
+/**
+ * SMHI Parser Benchmark
+ * Replays recorded SMHI responses through the firmware's parsers on a
+ * host, using the simulator's Arduino shims (sim/include).
+ *
+ *   make -C sim parser_bench
+ *   sim/build/parser_bench --fixtures DIR [--wifi] [--kbps N] [--reps N]
+ *                          [--csv]
+ *
+ * Every data.json under DIR (tools/smhi_standin.py --fixtures/--record
+ * layout, or --write-fixtures for synthetic ones) is run through each
+ * parser that reads its kind of document:
+ *
+ *   observations (/parameter/N/station/S/period/P/data.json)
+ *     obs        SMHI_API::parseWeatherDataStream
+ *     obs-old    the per-object ArduinoJson parser it replaced
+ *                (baseline_parsers.hpp)
+ *   pmp3g forecasts (/api/category/pmp3g/...)
+ *     timeseries SMHI_API::parseTimeSeriesStream
+ *     forecast   ForecastParser::parse (what WeekForecastView fetches with)
+ *     forecast-old the noon-sample ArduinoJson parser it replaced
+ *                (baseline_parsers.hpp; its points are days, at most
+ *                seven, after which it stops reading)
+ *
+ * Reported per file and parser: median time of the runs, MB/s and
+ * points/s from it, heap allocations per run and the peak heap above the
+ * starting point. Allocations are counted by wrapping malloc, which
+ * operator new, String and ArduinoJson all go through.
+ *
+ * --wifi feeds the parsers in TCP-sized pieces of varying length (the way
+ * a WiFiClient hands out received segments) instead of all at once; with
+ * --kbps the pieces also arrive no faster than that rate, so the time
+ * becomes the link's and the CPU column shows what parsing itself cost.
+ */
+#include <Arduino.h>
+#include <dirent.h>
+#include <malloc.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../sim/sim.h"
+// The firmware modules are header-only; the bench uses just their parsers
+#pragma GCC diagnostic ignored "-Wunused-function"
+#include "baseline_parsers.hpp"
+#include "forecastParser.hpp"
+#include "smhiApi.hpp"
+
+// Referenced by smhiApi.hpp (defined in project.ino on the device)
+StationTable gStations;
+SeriesStore weatherData;
+
+// --------------------------------------------------------------------
+// Allocation counting
+// --------------------------------------------------------------------
+extern "C" void *__libc_malloc(size_t);
+extern "C" void *__libc_calloc(size_t, size_t);
+extern "C" void *__libc_realloc(void *, size_t);
+extern "C" void __libc_free(void *);
+
+static bool alloc_armed = false;
+static size_t alloc_count = 0;
+static long alloc_live = 0; // Bytes since arming (may go negative)
+static long alloc_peak = 0;
+
+static void note_alloc(void *p) {
+  if (!alloc_armed || !p)
+    return;
+  alloc_count++;
+  alloc_live += (long)malloc_usable_size(p);
+  alloc_peak = std::max(alloc_peak, alloc_live);
+}
+
+static void note_free(void *p) {
+  if (alloc_armed && p)
+    alloc_live -= (long)malloc_usable_size(p);
+}
+
+extern "C" void *malloc(size_t n) {
+  void *p = __libc_malloc(n);
+  note_alloc(p);
+  return p;
+}
+
+extern "C" void *calloc(size_t n, size_t size) {
+  void *p = __libc_calloc(n, size);
+  note_alloc(p);
+  return p;
+}
+
+extern "C" void *realloc(void *old, size_t n) {
+  note_free(old);
+  void *p = __libc_realloc(old, n);
+  note_alloc(p);
+  return p;
+}
+
+extern "C" void free(void *p) {
+  note_free(p);
+  __libc_free(p);
+}
+
+// --------------------------------------------------------------------
+// Replay stream
+// --------------------------------------------------------------------
+
+/**
+ * Replay Stream
+ * A response body in memory. Unthrottled, everything is available at
+ * once; in Wi-Fi mode bytes come in pieces of 1..TCP_MSS bytes
+ * (deterministic pseudo-random sizes), paced to kbps if set.
+ */
+class ReplayStream : public Stream {
+public:
+  static const size_t TCP_MSS = 1436;
+
+  ReplayStream(const std::string &body, bool wifi, uint32_t kbps)
+      : data(body), wifi(wifi), kbps(kbps) {}
+
+  int available() override {
+    if (pos >= data.size())
+      return 0;
+    if (!wifi)
+      return (int)(data.size() - pos);
+    if (pos >= piece_end)
+      next_piece();
+    return (int)(piece_end - pos);
+  }
+
+  int read() override {
+    if (available() <= 0)
+      return -1;
+    return (unsigned char)data[pos++];
+  }
+
+  int peek() override {
+    return available() > 0 ? (unsigned char)data[pos] : -1;
+  }
+
+  size_t readBytes(char *buf, size_t n) override {
+    size_t take = std::min(n, (size_t)std::max(available(), 0));
+    memcpy(buf, data.data() + pos, take);
+    pos += take;
+    return take;
+  }
+
+private:
+  const std::string &data;
+  bool wifi;
+  uint32_t kbps;
+  size_t pos = 0;
+  size_t piece_end = 0;
+  uint32_t rng = 12345;
+
+  void next_piece() {
+    rng = rng * 1103515245u + 12345u;
+    // Mostly full segments, with the odd short one
+    size_t len = (rng >> 16) % 4 ? TCP_MSS : 1 + (rng >> 8) % TCP_MSS;
+    piece_end = std::min(data.size(), pos + len);
+    if (kbps)
+      delay((piece_end - pos) * 1000 / (kbps * 1024));
+  }
+};
+
+// --------------------------------------------------------------------
+// Parsers
+// --------------------------------------------------------------------
+enum DocKind { DOC_OBSERVATIONS, DOC_FORECAST, DOC_OTHER };
+
+struct ParserCase {
+  const char *name;
+  DocKind kind;
+  // Parses the stream; returns the points read, -1 on failure
+  long (*run)(Stream &s);
+};
+
+static long run_obs(Stream &s) {
+  static SMHI_API api("/api/version/1.0/parameter/");
+  SeriesStore out;
+  return api.parseWeatherDataStream(s, out) ? (long)out.size() : -1;
+}
+
+static long run_obs_baseline(Stream &s) {
+  std::vector<baseline::DataPoint> out;
+  return baseline::parse_observations(s, out) ? (long)out.size() : -1;
+}
+
+static long run_timeseries(Stream &s) {
+  static SMHI_API api("/api/version/1.0/parameter/");
+  SeriesStore out;
+  return api.parseTimeSeriesStream(s, out) ? (long)out.size() : -1;
+}
+
+static long run_forecast(Stream &s) {
+  JsonPullParser json(s);
+  ForecastData out;
+  bool ok = ForecastParser::parse(json, out) && json.finish();
+  return ok ? (long)out.hours.size() : -1;
+}
+
+static long run_forecast_baseline(Stream &s) {
+  std::vector<baseline::DayForecast> out;
+  return baseline::parse_forecast(s, out) ? (long)out.size() : -1;
+}
+
+static const ParserCase PARSERS[] = {
+    {"obs", DOC_OBSERVATIONS, run_obs},
+    {"obs-old", DOC_OBSERVATIONS, run_obs_baseline},
+    {"timeseries", DOC_FORECAST, run_timeseries},
+    {"forecast", DOC_FORECAST, run_forecast},
+    {"forecast-old", DOC_FORECAST, run_forecast_baseline},
+};
+
+static DocKind kind_of(const std::string &path) {
+  if (path.find("/api/category/pmp3g/") != std::string::npos)
+    return DOC_FORECAST;
+  if (path.find("/period/") != std::string::npos)
+    return DOC_OBSERVATIONS;
+  return DOC_OTHER;
+}
+
+// --------------------------------------------------------------------
+// Runner
+// --------------------------------------------------------------------
+struct Options {
+  std::string fixtures;
+  bool wifi = false;
+  uint32_t kbps = 0;
+  int reps = 0; // 0: as many as fit in about 0.3 s (at least 3)
+  bool csv = false;
+};
+
+static double now_s(clockid_t clock) {
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void find_documents(const std::string &dir,
+                           std::vector<std::string> &out) {
+  DIR *d = opendir(dir.c_str());
+  if (!d)
+    return;
+  while (struct dirent *e = readdir(d)) {
+    if (e->d_name[0] == '.')
+      continue;
+    std::string path = dir + "/" + e->d_name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+      continue;
+    if (S_ISDIR(st.st_mode))
+      find_documents(path, out);
+    else if (kind_of(path) != DOC_OTHER)
+      out.push_back(path);
+  }
+  closedir(d);
+}
+
+static bool read_file(const std::string &path, std::string &out) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f)
+    return false;
+  char buf[16384];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    out.append(buf, n);
+  fclose(f);
+  return true;
+}
+
+// Short label: parameter/station/period, or forecast lon/lat
+static std::string label_of(const std::string &path) {
+  size_t p = path.find("/parameter/");
+  if (p != std::string::npos) {
+    std::string s = path.substr(p + 11);
+    size_t st = s.find("/station/"), pe = s.find("/period/");
+    if (st != std::string::npos && pe != std::string::npos)
+      return "p" + s.substr(0, st) + " " + s.substr(st + 9, pe - st - 9) +
+             " " + s.substr(pe + 8, s.rfind('/') - pe - 8);
+  }
+  p = path.find("/lon/");
+  if (p != std::string::npos) {
+    std::string s = path.substr(p + 5);
+    return "pmp3g " + s.substr(0, s.find('/'));
+  }
+  return path;
+}
+
+struct Result {
+  long points;
+  double wall_s, cpu_s; // Medians
+  size_t allocs;
+  long peak_bytes;
+};
+
+static Result bench(const ParserCase &pc, const std::string &body,
+                    const Options &opt) {
+  std::vector<double> wall, cpu;
+  Result r = {};
+  double spent = 0;
+  for (int i = 0; opt.reps ? i < opt.reps : (i < 3 || spent < 0.3); i++) {
+    ReplayStream s(body, opt.wifi, opt.kbps);
+    alloc_count = 0;
+    alloc_live = alloc_peak = 0;
+    double c0 = now_s(CLOCK_PROCESS_CPUTIME_ID), w0 = now_s(CLOCK_MONOTONIC);
+    alloc_armed = true;
+    long points = pc.run(s);
+    alloc_armed = false;
+    double w = now_s(CLOCK_MONOTONIC) - w0;
+    cpu.push_back(now_s(CLOCK_PROCESS_CPUTIME_ID) - c0);
+    wall.push_back(w);
+    spent += w;
+    r.points = points;
+    r.allocs = alloc_count; // Same every run
+    r.peak_bytes = alloc_peak;
+  }
+  std::sort(wall.begin(), wall.end());
+  std::sort(cpu.begin(), cpu.end());
+  r.wall_s = wall[wall.size() / 2];
+  r.cpu_s = cpu[cpu.size() / 2];
+  return r;
+}
+
+static void usage() {
+  fprintf(stderr, "usage: parser_bench --fixtures DIR [--wifi] [--kbps N] "
+                  "[--reps N] [--csv]\n");
+}
+
+int main(int argc, char **argv) {
+  Options opt;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool has_value = i + 1 < argc;
+    if (arg == "--fixtures" && has_value)
+      opt.fixtures = argv[++i];
+    else if (arg == "--wifi")
+      opt.wifi = true;
+    else if (arg == "--kbps" && has_value)
+      opt.kbps = strtoul(argv[++i], nullptr, 10), opt.wifi = true;
+    else if (arg == "--reps" && has_value)
+      opt.reps = atoi(argv[++i]);
+    else if (arg == "--csv")
+      opt.csv = true;
+    else {
+      usage();
+      return 2;
+    }
+  }
+  if (opt.fixtures.empty()) {
+    usage();
+    return 2;
+  }
+
+  std::vector<std::string> docs;
+  find_documents(opt.fixtures, docs);
+  std::sort(docs.begin(), docs.end());
+  if (docs.empty()) {
+    fprintf(stderr, "no observation or pmp3g data.json under %s\n",
+            opt.fixtures.c_str());
+    return 1;
+  }
+
+  // Neither print nor keep the parsers' Serial logging (kept output would
+  // grow over the runs and show up as parser allocations)
+  g_sim.quiet = true;
+  g_sim.keep_serial = false;
+  if (opt.csv)
+    printf("document,parser,bytes,points,ms,cpu_ms,mb_s,points_s,allocs,"
+           "peak_bytes\n");
+  else
+    printf("%-28s %-12s %9s %7s %9s %9s %8s %11s %7s %9s\n", "document",
+           "parser", "bytes", "points", "ms", "cpu ms", "MB/s", "points/s",
+           "allocs", "peak heap");
+
+  for (const std::string &path : docs) {
+    std::string body;
+    if (!read_file(path, body))
+      continue;
+    DocKind kind = kind_of(path);
+    std::string label = label_of(path);
+    for (const ParserCase &pc : PARSERS) {
+      if (pc.kind != kind)
+        continue;
+      Result r = bench(pc, body, opt);
+      double mb_s = body.size() / r.wall_s / 1e6;
+      double pts_s = r.points > 0 ? r.points / r.wall_s : 0;
+      if (opt.csv)
+        printf("%s,%s,%zu,%ld,%.3f,%.3f,%.2f,%.0f,%zu,%ld\n", label.c_str(),
+               pc.name, body.size(), r.points, r.wall_s * 1e3, r.cpu_s * 1e3,
+               mb_s, pts_s, r.allocs, r.peak_bytes);
+      else
+        printf("%-28s %-12s %9zu %7s %9.3f %9.3f %8.2f %11.0f %7zu %9ld\n",
+               label.c_str(), pc.name, body.size(),
+               r.points < 0 ? "failed" : std::to_string(r.points).c_str(),
+               r.wall_s * 1e3, r.cpu_s * 1e3, mb_s, pts_s, r.allocs,
+               r.peak_bytes);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * Host microbenchmark for src/Rotate565.h
+ *
+ * Checks rotate565_rows() against the one-pixel-at-a-time reference for all
+ * four rotations, then times both on full panel-sized areas and in the
+ * 16-row strips LilyGo_AMOLED::pushColors sends through its bounce buffers.
+ *
+ *   g++ -O2 -o rotate_bench tools/rotate_bench.cpp && ./rotate_bench
+ */
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "../src/Rotate565.h"
+
+static const uint16_t STRIP_ROWS = 16; // As ROTATE_STRIP_ROWS in LilyGo_AMOLED
+
+struct Size {
+    uint16_t w, h;
+};
+
+static double now_us()
+{
+    using namespace std::chrono;
+    return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+}
+
+// The loop pushColors() used before: rotation 1 only, one pixel at a time
+static void rotate_legacy(uint16_t *dst, const uint16_t *p, uint16_t width, uint16_t hight)
+{
+    uint32_t cum = 0;
+    for (uint16_t j = 0; j < width; j++) {
+        for (uint16_t i = 0; i < hight; i++) {
+            dst[cum++] = p[width * (hight - i - 1) + j];
+        }
+    }
+}
+
+template <typename F>
+static double time_us(F fn, int reps)
+{
+    fn(); // Warm up
+    double t0 = now_us();
+    for (int i = 0; i < reps; i++) {
+        fn();
+    }
+    return (now_us() - t0) / reps;
+}
+
+int main()
+{
+    const Size sizes[] = {{194, 368}, {240, 536}, {536, 240}, {450, 600}};
+    const int reps = 200;
+    int failures = 0;
+
+    for (const Size &sz : sizes) {
+        uint32_t n = (uint32_t)sz.w * sz.h;
+        std::vector<uint16_t> src(n), ref(n), out(n), strip((size_t)STRIP_ROWS * (sz.w > sz.h ? sz.w : sz.h));
+        for (uint32_t i = 0; i < n; i++) {
+            src[i] = (uint16_t)(rand() & 0xFFFF);
+        }
+
+        printf("%ux%u\n", sz.w, sz.h);
+        for (uint8_t rot = 0; rot < 4; rot++) {
+            uint16_t dw = rotate565_width(sz.w, sz.h, rot);
+            uint16_t dh = rotate565_height(sz.w, sz.h, rot);
+
+            rotate565_rows_scalar(ref.data(), src.data(), sz.w, sz.h, rot, 0, dh);
+            rotate565_rows(out.data(), src.data(), sz.w, sz.h, rot, 0, dh);
+            bool ok = ref == out;
+
+            // Strip by strip into the bounce buffer, as pushColors does
+            for (uint16_t row = 0; row < dh && ok; row += STRIP_ROWS) {
+                uint16_t rows = dh - row < STRIP_ROWS ? dh - row : STRIP_ROWS;
+                rotate565_rows(strip.data(), src.data(), sz.w, sz.h, rot, row, rows);
+                ok = memcmp(strip.data(), &ref[(uint32_t)row * dw], (size_t)rows * dw * 2) == 0;
+            }
+            if (!ok) {
+                failures++;
+            }
+
+            double scalar = time_us([&] {
+                rotate565_rows_scalar(out.data(), src.data(), sz.w, sz.h, rot, 0, dh);
+            }, reps);
+            double tiled = time_us([&] {
+                rotate565_rows(out.data(), src.data(), sz.w, sz.h, rot, 0, dh);
+            }, reps);
+            double strips = time_us([&] {
+                for (uint16_t row = 0; row < dh; row += STRIP_ROWS) {
+                    uint16_t rows = dh - row < STRIP_ROWS ? dh - row : STRIP_ROWS;
+                    rotate565_rows(strip.data(), src.data(), sz.w, sz.h, rot, row, rows);
+                }
+            }, reps);
+
+            printf("  rot %3d: scalar %7.1f us  tiled %7.1f us  strips %7.1f us  %6.0f Mpx/s  %s\n",
+                   rot * 90, scalar, tiled, strips, n / strips, ok ? "ok" : "MISMATCH");
+        }
+
+        double legacy = time_us([&] {
+            rotate_legacy(out.data(), src.data(), sz.w, sz.h);
+        }, reps);
+        printf("  legacy pushColors loop (90): %7.1f us\n", legacy);
+    }
+    return failures ? 1 : 0;
+}
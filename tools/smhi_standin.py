@@ -0,0 +1,351 @@
+#!/usr/bin/env python3
+"""
+Local HTTPS stand-in for the SMHI open data hosts.
+
+Serves the subset of the metobs (observations) and metfcst (pmp3g forecast)
+APIs the firmware uses, with HTTP/1.1 keep-alive, so connection reuse and the
+HTTPS timing counters (httpsPool.hpp) can be checked without the real API.
+
+Responses come from a fixture directory when a file exists at the request
+path (e.g. fixtures/api/version/1.0/parameter/1/station/65090/period/
+latest-months/data.json), otherwise synthetic data is generated. With
+--record, missing fixtures are fetched from the real SMHI hosts and saved,
+so a session can be replayed offline (and used by host benchmarks).
+
+Build the firmware against it with:
+  -DSMHI_METOBS_HOST=\\"<pc-ip>\\" -DSMHI_METFCST_HOST=\\"<pc-ip>\\"
+  -DSMHI_HTTPS_PORT=8443
+
+Usage:
+  tools/smhi_standin.py [--port 8443] [--fixtures DIR] [--record]
+                        [--ttfb-ms 150] [--kbps 200] [--params 1,4,6,9]
+  tools/smhi_standin.py --write-fixtures DIR [--station 65090]
+                        [--params 1,2]
+
+A self-signed certificate is created with openssl on first run (the firmware
+uses setInsecure(), so any certificate is accepted).
+"""
+
+import argparse
+import datetime as dt
+import http.server
+import json
+import math
+import os
+import re
+import socketserver
+import ssl
+import subprocess
+import sys
+import time
+import urllib.request
+
+OBS_DATA = re.compile(
+    r"^/api/version/1\.0/parameter/(\d+)/station/(\w+)/period/"
+    r"(latest-hour|latest-day|latest-months)/data\.json$")
+OBS_STATION = re.compile(r"^/api/version/1\.0/parameter/(\d+)/station/(\w+)/?$")
+OBS_PARAMETER = re.compile(r"^/api/version/1\.0/parameter/(\d+)\.json$")
+FORECAST = re.compile(
+    r"^/api/category/pmp3g/version/2/geotype/point/lon/([-\d.]+)/lat/"
+    r"([-\d.]+)/data\.json$")
+
+SMHI_METOBS = "https://opendata-download-metobs.smhi.se"
+SMHI_METFCST = "https://opendata-download-metfcst.smhi.se"
+
+STATION_ROW = re.compile(r'\{"(\d+)", "([^"]*)", ([-\d.]+)f, ([-\d.]+)f\}')
+
+
+def load_stations():
+    """(id, name, lat, lon) rows from project/stations.hpp"""
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..",
+                        "project", "stations.hpp")
+    with open(path, encoding="utf-8") as f:
+        return [(m.group(1), m.group(2), float(m.group(3)), float(m.group(4)))
+                for m in STATION_ROW.finditer(f.read())]
+
+
+PERIOD_HOURS = {"latest-hour": 1, "latest-day": 24, "latest-months": 24 * 120}
+
+# Parameters SMHI reports once per day ({"from", "to", "ref"} entries)
+DAILY_PARAMS = {2, 5, 19, 20}
+
+
+def synthetic_observations(param, station, period):
+    now = dt.datetime.now(dt.timezone.utc).replace(minute=0, second=0,
+                                                   microsecond=0)
+    hours = PERIOD_HOURS[period]
+    seed = sum(ord(c) for c in station) + param
+    values = []
+    if param in DAILY_PARAMS:
+        today = now.replace(hour=0)
+        for i in range(max(1, hours // 24)):
+            t = today - dt.timedelta(days=hours // 24 - i)
+            v = 8 + 10 * math.sin((t.timetuple().tm_yday + seed) / 58.0)
+            values.append({"from": int(t.timestamp() * 1000),
+                           "to": int((t + dt.timedelta(days=1)).timestamp()
+                                     * 1000),
+                           "ref": t.strftime("%Y-%m-%d"),
+                           "value": "%.1f" % v, "quality": "G"})
+    for i in range(0 if param in DAILY_PARAMS else hours):
+        t = now - dt.timedelta(hours=hours - 1 - i)
+        v = 8 + 10 * math.sin((t.timetuple().tm_yday + seed) / 58.0) \
+            + 4 * math.sin(t.hour / 24.0 * 2 * math.pi)
+        values.append({"date": int(t.timestamp() * 1000),
+                       "value": "%.1f" % v, "quality": "G"})
+    return {"value": values,
+            "updated": int(now.timestamp() * 1000),
+            "parameter": {"key": str(param), "name": "Stand-in", "unit": ""},
+            "station": {"key": station, "name": "Stand-in " + station},
+            "period": {"key": period}}
+
+
+def synthetic_parameter(param, stations):
+    """Station list of one parameter: every known station, all active"""
+    return {"key": str(param), "title": "Stand-in parameter %d" % param,
+            "station": [{"key": sid, "id": int(sid), "name": name,
+                         "latitude": lat, "longitude": lon, "active": True}
+                        for sid, name, lat, lon in stations],
+            "link": []}
+
+
+# pmp3g parameters in the order SMHI sends them: (name, levelType, level,
+# unit)
+PMP3G_PARAMS = [
+    ("spp", "hl", 0, "percent"), ("pcat", "hl", 0, "category"),
+    ("pmin", "hl", 0, "kg/m2/h"), ("pmean", "hl", 0, "kg/m2/h"),
+    ("pmax", "hl", 0, "kg/m2/h"), ("pmedian", "hl", 0, "kg/m2/h"),
+    ("tcc_mean", "hl", 0, "octas"), ("lcc_mean", "hl", 0, "octas"),
+    ("mcc_mean", "hl", 0, "octas"), ("hcc_mean", "hl", 0, "octas"),
+    ("t", "hl", 2, "Cel"), ("msl", "hmsl", 0, "hPa"), ("vis", "hl", 2, "km"),
+    ("wd", "hl", 10, "degree"), ("ws", "hl", 10, "m/s"),
+    ("r", "hl", 2, "percent"), ("tstm", "hl", 0, "percent"),
+    ("gust", "hl", 10, "m/s"), ("Wsymb2", "hl", 0, "category"),
+]
+
+
+def pmp3g_steps(start):
+    """Hourly for ~2.5 days, then 3 h, then 6 h out to 10 days"""
+    t, end = start, start + dt.timedelta(days=10)
+    while t <= end:
+        yield t
+        ahead = (t - start).total_seconds() / 3600
+        t += dt.timedelta(hours=1 if ahead < 60 else 3 if ahead < 96 else 6)
+
+
+def synthetic_forecast(lon, lat):
+    start = dt.datetime.now(dt.timezone.utc).replace(minute=0, second=0,
+                                                     microsecond=0)
+    series = []
+    for t in pmp3g_steps(start):
+        i = (t - start).total_seconds() / 3600
+        temp = 6 + 8 * math.sin(i / 24.0 * 2 * math.pi) + float(lat) / 20
+        rain = max(0.0, 1.5 * math.sin(i / 17.0))
+        values = {"t": round(temp, 1), "pmean": round(rain, 1),
+                  "pmin": 0.0, "pmax": round(rain * 1.6, 1),
+                  "pmedian": round(rain * 0.8, 1),
+                  "pcat": 3 if rain > 0 else 0, "spp": -9,
+                  "ws": round(3 + 2 * math.sin(i / 9.0), 1),
+                  "gust": round(6 + 3 * math.sin(i / 9.0), 1),
+                  "wd": int(i * 7) % 360, "msl": 1012.3, "vis": 38.1,
+                  "r": 80, "tstm": 1, "Wsymb2": 1 + int(i // 24) % 27}
+        params = []
+        for name, level_type, level, unit in PMP3G_PARAMS:
+            params.append({"name": name, "levelType": level_type,
+                           "level": level, "unit": unit,
+                           "values": [values.get(name, 4)]})
+        series.append({"validTime": t.strftime("%Y-%m-%dT%H:%M:%SZ"),
+                       "parameters": params})
+    return {"approvedTime": start.strftime("%Y-%m-%dT%H:%M:%SZ"),
+            "referenceTime": start.strftime("%Y-%m-%dT%H:%M:%SZ"),
+            "geometry": {"type": "Point",
+                         "coordinates": [[float(lon), float(lat)]]},
+            "timeSeries": series}
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"  # keep-alive
+    opts = None
+
+    def setup(self):
+        super().setup()
+        self.requests_on_conn = 0
+
+    def log_message(self, fmt, *args):
+        sys.stderr.write("[%s conn#%d req#%d] %s\n" % (
+            self.client_address[0], id(self.connection) % 10000,
+            self.requests_on_conn, fmt % args))
+
+    def send_json(self, code, obj):
+        body = json.dumps(obj, separators=(",", ":")).encode()
+        self.send_bytes(code, body)
+
+    def send_bytes(self, code, body):
+        time.sleep(self.opts.ttfb_ms / 1000.0)
+        self.send_response(code)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        if self.command == "HEAD":
+            return
+        if self.opts.kbps <= 0:
+            self.wfile.write(body)
+            return
+        step = 1460
+        delay = step / (self.opts.kbps * 1024.0)
+        for off in range(0, len(body), step):
+            self.wfile.write(body[off:off + step])
+            self.wfile.flush()
+            time.sleep(delay)
+
+    def do_HEAD(self):
+        self.do_GET()
+
+    def do_GET(self):
+        self.requests_on_conn += 1
+        path = self.path.split("?", 1)[0]
+
+        if self.opts.fixtures:
+            local = os.path.join(self.opts.fixtures, path.lstrip("/"))
+            if not os.path.isfile(local) and self.opts.record:
+                record_fixture(path, local)
+            if os.path.isfile(local):
+                with open(local, "rb") as f:
+                    return self.send_bytes(200, f.read())
+
+        m = OBS_DATA.match(path)
+        if m:
+            param, station, period = int(m.group(1)), m.group(2), m.group(3)
+            if param not in self.opts.params:
+                return self.send_json(404, {"error": "no data"})
+            return self.send_json(200,
+                                  synthetic_observations(param, station, period))
+
+        m = OBS_PARAMETER.match(path)
+        if m:
+            param = int(m.group(1))
+            if param not in self.opts.params:
+                return self.send_json(404, {"error": "no such parameter"})
+            return self.send_json(200, synthetic_parameter(param,
+                                                           self.opts.stations))
+
+        m = OBS_STATION.match(path)
+        if m:
+            param, station = int(m.group(1)), m.group(2)
+            if param not in self.opts.params:
+                return self.send_json(404, {"error": "no such station"})
+            return self.send_json(200, {"key": station, "active": True,
+                                        "parameter": param})
+
+        m = FORECAST.match(path)
+        if m:
+            return self.send_json(200, synthetic_forecast(m.group(1),
+                                                          m.group(2)))
+
+        self.send_json(404, {"error": "not found", "path": path})
+
+
+def record_fixture(path, local):
+    """Fetch path from the real SMHI host and save it as a fixture"""
+    host = SMHI_METFCST if path.startswith("/api/category/") else SMHI_METOBS
+    try:
+        with urllib.request.urlopen(host + path, timeout=30) as r:
+            body = r.read()
+    except OSError as e:
+        sys.stderr.write("record %s failed: %s\n" % (path, e))
+        return
+    os.makedirs(os.path.dirname(local), exist_ok=True)
+    with open(local, "wb") as f:
+        f.write(body)
+    sys.stderr.write("recorded %s (%d bytes)\n" % (path, len(body)))
+
+
+class Server(socketserver.ThreadingMixIn, http.server.HTTPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+
+def write_fixtures(root, station, params, stations):
+    """Synthetic responses for one station, saved as a fixture directory"""
+    def save(path, obj):
+        local = os.path.join(root, path.lstrip("/"))
+        os.makedirs(os.path.dirname(local), exist_ok=True)
+        with open(local, "w", encoding="utf-8") as f:
+            json.dump(obj, f, separators=(",", ":"))
+        sys.stderr.write("wrote %s\n" % path)
+
+    obs = "/api/version/1.0/parameter/%d"
+    for param in sorted(params):
+        save(obs % param + ".json", synthetic_parameter(param, stations))
+        for period in PERIOD_HOURS:
+            if param in DAILY_PARAMS and period == "latest-hour":
+                continue
+            save(obs % param + "/station/%s/period/%s/data.json"
+                 % (station, period),
+                 synthetic_observations(param, station, period))
+    for sid, _, lat, lon in stations:
+        if sid == station:
+            save("/api/category/pmp3g/version/2/geotype/point/lon/%.4f/lat/"
+                 "%.4f/data.json" % (lon, lat),
+                 synthetic_forecast("%.4f" % lon, "%.4f" % lat))
+
+
+def ensure_cert(cert, key):
+    if os.path.exists(cert) and os.path.exists(key):
+        return
+    subprocess.check_call([
+        "openssl", "req", "-x509", "-newkey", "rsa:2048", "-nodes",
+        "-keyout", key, "-out", cert, "-days", "3650",
+        "-subj", "/CN=smhi-standin"])
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("--port", type=int, default=8443)
+    ap.add_argument("--fixtures", default=None,
+                    help="directory mirroring API paths")
+    ap.add_argument("--record", action="store_true",
+                    help="save missing fixtures from the real SMHI API")
+    ap.add_argument("--ttfb-ms", type=int, default=0,
+                    help="delay before each response")
+    ap.add_argument("--kbps", type=int, default=0,
+                    help="throttle response bodies (0 = unthrottled)")
+    ap.add_argument("--params", default="1,2,3,4,5,6,7,8,9,10,11,12,13,14,"
+                    "16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,"
+                    "34,35,36,37,38,39,40",
+                    help="parameter codes every station has")
+    ap.add_argument("--write-fixtures", metavar="DIR", default=None,
+                    help="save synthetic responses for --station as "
+                    "fixtures and exit")
+    ap.add_argument("--station", default="65090",
+                    help="station for --write-fixtures")
+    ap.add_argument("--cert", default=os.path.join(here, "standin-cert.pem"))
+    ap.add_argument("--key", default=os.path.join(here, "standin-key.pem"))
+    opts = ap.parse_args()
+    if opts.record and not opts.fixtures:
+        ap.error("--record needs --fixtures")
+    opts.params = {int(p) for p in opts.params.split(",") if p}
+    opts.stations = load_stations()
+
+    if opts.write_fixtures:
+        write_fixtures(opts.write_fixtures, opts.station, opts.params,
+                       opts.stations)
+        return
+
+    ensure_cert(opts.cert, opts.key)
+    Handler.opts = opts
+
+    httpd = Server(("0.0.0.0", opts.port), Handler)
+    ctx = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    ctx.load_cert_chain(opts.cert, opts.key)
+    httpd.socket = ctx.wrap_socket(httpd.socket, server_side=True)
+
+    print("SMHI stand-in on https://0.0.0.0:%d" % opts.port)
+    try:
+        httpd.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()